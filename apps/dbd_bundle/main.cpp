@@ -0,0 +1,56 @@
+/*
+    Compile a WoWDBDefs definitions directory into a single bundle, which can be loaded in place of the .dbd files.
+
+    dbd_bundle.exe {definitions_dir} {output_path}
+    - definitions_dir = path to the WoWDBDefs definitions directory.
+    - output_path     = where the bundle is saved to.
+*/
+
+#include <WDBReader/ThreadPool.hpp>
+#include <WDBReader/WoWDBDefs.hpp>
+#include <WDBReader/WoWDBDefsBundle.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace WDBReader;
+using namespace WDBReader::WoWDBDefs;
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        std::cerr << "Not enough parameters." << std::endl;
+        std::cerr << "Expected args: {definitions_dir} {output_path}" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path definitions_dir(argv[1]);
+    std::filesystem::path output_path(argv[2]);
+
+    try {
+        ThreadPool pool;
+        const DefinitionRegistry registry(definitions_dir, &pool);
+
+        for (const auto& failure : registry.failures()) {
+            std::cerr << "Skipped " << failure.name << ": " << failure.reason << std::endl;
+        }
+
+        std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            std::cerr << "Unable to open output file." << std::endl;
+            return 1;
+        }
+
+        writeDefinitionBundle(output, registry);
+        output.close();
+
+        std::cout << "Bundled " << registry.size() << " definitions (" << std::filesystem::file_size(output_path) << " bytes)." << std::endl;
+    }
+    catch (std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
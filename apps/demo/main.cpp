@@ -2,10 +2,11 @@
     Demo application that shows basic WDBReader capabilities.
 
     Example usage:
-    demo.exe {wow_dir} {db_file_uri} {dbd_defs_name}
+    demo.exe {wow_dir} {db_file_uri} {dbd_defs_name} [--bundle {bundle_path}]
     - wow_dir       = path to wow install directory.
     - db_file_uri   = path to db file, MPQ: string, CASC file id.
-    - dbd_defs_name = path to .dbd file.
+    - dbd_defs_name = path to .dbd file, or the table name when a bundle is given.
+    - bundle_path   = optional definitions bundle to resolve the table from.
 
     The application will output:
     - Detected client versions
@@ -20,13 +21,18 @@
 #include <WDBReader/Filesystem/CASCFilesystem.hpp>
 #include <WDBReader/Filesystem/MPQFilesystem.hpp>
 #include <WDBReader/WoWDBDefs.hpp>
+#include <WDBReader/WoWDBDefsBundle.hpp>
 
 #include <format>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
@@ -42,6 +48,7 @@ public:
     std::filesystem::path wow_dir;
     std::string db_file;
     std::filesystem::path definition_file;
+    std::optional<std::filesystem::path> bundle_file;
 };
 
 class FilesystemHandler {
@@ -84,16 +91,32 @@ int main(int argc, char* argv[]) {
     }
 #endif
 
-    if (argc < 4) {
+    std::vector<std::string> positional;
+    std::optional<std::filesystem::path> bundle_file;
+    for (int i = 1; i < argc; i++) {
+        if (std::string_view(argv[i]) == "--bundle") {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing bundle path." << std::endl;
+                return 1;
+            }
+            bundle_file = argv[++i];
+        }
+        else {
+            positional.emplace_back(argv[i]);
+        }
+    }
+
+    if (positional.size() < 3) {
         std::cerr << "Not enough parameters." << std::endl;
-        std::cerr << "Expected args: {wow_dir} {file_uri} {def_name}" << std::endl;
+        std::cerr << "Expected args: {wow_dir} {file_uri} {def_name} [--bundle {bundle_path}]" << std::endl;
         return 1;
     }
 
     AppArgs args = {
-        argv[1],
-        argv[2],
-        argv[3]
+        positional[0],
+        positional[1],
+        positional[2],
+        bundle_file
     };
 
     try {
@@ -118,11 +141,18 @@ int main(int argc, char* argv[]) {
         }
         const auto& target_client = found_clients[0];
 
-        std::ifstream def_stream(args.definition_file);
-        auto definition = DBDReader::read(def_stream);
-        def_stream.close();
+        std::optional<RuntimeSchema> schema;
+        if (args.bundle_file.has_value()) {
+            const DefinitionBundle bundle(*args.bundle_file);
+            schema = bundle.schema(args.definition_file.string(), target_client.version);
+        }
+        else {
+            std::ifstream def_stream(args.definition_file);
+            auto definition = DBDReader::read(def_stream);
+            def_stream.close();
 
-        auto schema = makeSchema(definition, target_client.version);
+            schema = makeSchema(definition, target_client.version);
+        }
         if (!schema.has_value()) {
             std::cout << "Unable to create schema." << std::endl;
             return 1;
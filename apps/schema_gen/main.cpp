@@ -1,23 +1,28 @@
 /*
     Generate static record and schema structures for use with WDBReader.
 
-    schema_gen.exe {version} {db_defs_name} {db_format} {output_path}
+    schema_gen.exe {version} {db_defs_name} {db_format} {output_path} [--bundle {bundle_path}]
     - version       = client version a.b.c.d
-    - dbd_defs_name = path to .dbd file.
+    - dbd_defs_name = path to .dbd file, or the table name when a bundle is given.
     - db_format     = DBC_VANILLA, DBC_BC_WOTLK, DBC_CATA_PLUS, DB2
     - output_path   = where output file is saved to.
+    - bundle_path   = optional definitions bundle to resolve the table from.
 */
 
 #include <WDBReader/Database.hpp>
 #include <WDBReader/Database/DB2File.hpp>
 #include <WDBReader/Database/DBCFile.hpp>
 #include <WDBReader/WoWDBDefs.hpp>
+#include <WDBReader/WoWDBDefsBundle.hpp>
 
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 using namespace WDBReader::Database;
 using namespace WDBReader::WoWDBDefs;
@@ -44,16 +49,31 @@ protected:
 
 int main(int argc, char* argv[]) {
 
-    if (argc < 5) {
+    std::vector<std::string> positional;
+    std::optional<std::filesystem::path> bundle_path;
+    for (int i = 1; i < argc; i++) {
+        if (std::string_view(argv[i]) == "--bundle") {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing bundle path." << std::endl;
+                return 1;
+            }
+            bundle_path = argv[++i];
+        }
+        else {
+            positional.emplace_back(argv[i]);
+        }
+    }
+
+    if (positional.size() < 4) {
         std::cerr << "Not enough parameters." << std::endl;
-        std::cerr << "Expected args: {version} {db_defs_name} {db_format} {output_path}" << std::endl;
+        std::cerr << "Expected args: {version} {db_defs_name} {db_format} {output_path} [--bundle {bundle_path}]" << std::endl;
         return 1;
     }
 
-    std::string version_str(argv[1]);
-    std::filesystem::path dbdefs_path(argv[2]);
-    std::string db_format(argv[3]);
-    std::filesystem::path output_path(argv[4]);
+    std::string version_str(positional[0]);
+    std::filesystem::path dbdefs_path(positional[1]);
+    std::string db_format(positional[2]);
+    std::filesystem::path output_path(positional[3]);
 
     auto version = Build::fromString(version_str);
     if (!version.has_value()) {
@@ -75,18 +95,26 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    std::ifstream def_stream(dbdefs_path);
-    auto definition = DBDReader::read(def_stream);
-    def_stream.close();
+    auto plain_name = dbdefs_path.filename().replace_extension("").string();
+
+    std::optional<RuntimeSchema> schema;
+    if (bundle_path.has_value()) {
+        const DefinitionBundle bundle(*bundle_path);
+        schema = bundle.schema(plain_name, version.value());
+    }
+    else {
+        std::ifstream def_stream(dbdefs_path);
+        auto definition = DBDReader::read(def_stream);
+        def_stream.close();
+
+        schema = makeSchema(definition, version.value());
+    }
 
-    auto schema = makeSchema(definition, version.value());
     if (!schema.has_value()) {
         std::cerr << "Unable to find schema." << std::endl;
         return 1;
     }
 
-    auto plain_name = dbdefs_path.filename().replace_extension("").string();
-
     FileBuilder builder(plain_name, *schema, *version, dbc_version);
     builder.create(output_path);
 
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace WDBReader::Benchmarks {
+
+    /// <summary>
+    /// Keeps a value alive, so the work producing it isnt optimised away.
+    /// </summary>
+    template<typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T* sink;
+        sink = &value;
+#endif
+    }
+
+    struct BenchmarkResult {
+    public:
+        std::string name;
+        uint64_t items;     // work items per run, e.g. records read.
+        uint32_t runs;
+        std::chrono::nanoseconds min;
+        std::chrono::nanoseconds median;
+        std::chrono::nanoseconds mean;
+
+        inline double itemsPerSecond() const
+        {
+            return median.count() > 0 ? (items * 1e9) / median.count() : 0.0;
+        }
+
+        // fastest run per item, the least noisy measure for comparing short benchmarks.
+        inline double nanosecondsPerItem() const
+        {
+            return static_cast<double>(min.count()) / std::max<uint64_t>(items, 1);
+        }
+    };
+
+    /// <summary>
+    /// Writes results as json, the format read by readResultsJson.
+    /// </summary>
+    inline void writeResultsJson(std::ostream& out, const std::vector<BenchmarkResult>& results)
+    {
+        out << "{\"results\":[";
+        for (size_t i = 0; i < results.size(); i++) {
+            const auto& result = results[i];
+            // names are generated by the benchmarks, so dont need escaping.
+            out << (i > 0 ? "," : "") << "\n{\"name\":\"" << result.name << "\""
+                << ",\"items\":" << result.items
+                << ",\"runs\":" << result.runs
+                << ",\"min_ns\":" << result.min.count()
+                << ",\"median_ns\":" << result.median.count()
+                << ",\"mean_ns\":" << result.mean.count() << "}";
+        }
+        out << "\n]}\n";
+    }
+
+    /// <summary>
+    /// Reads results written by writeResultsJson. Only handles that flat layout, not arbitrary json.
+    /// </summary>
+    inline std::vector<BenchmarkResult> readResultsJson(std::istream& in)
+    {
+        const std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::vector<BenchmarkResult> results;
+
+        size_t pos = json.find('[');
+        if (pos == std::string::npos) {
+            throw std::runtime_error("Benchmark json is missing results.");
+        }
+
+        while ((pos = json.find('{', pos)) != std::string::npos) {
+            const size_t end = json.find('}', pos);
+            if (end == std::string::npos) {
+                throw std::runtime_error("Benchmark json is truncated.");
+            }
+
+            std::map<std::string, std::string> values;
+            std::istringstream object(json.substr(pos + 1, end - pos - 1));
+            std::string pair;
+            while (std::getline(object, pair, ',')) {
+                const size_t colon = pair.find(':');
+                if (colon == std::string::npos) {
+                    continue;
+                }
+
+                auto unquote = [](std::string str) {
+                    const auto first = str.find_first_not_of(" \t\r\n\"");
+                    const auto last = str.find_last_not_of(" \t\r\n\"");
+                    return first == std::string::npos ? std::string() : str.substr(first, last - first + 1);
+                };
+
+                values[unquote(pair.substr(0, colon))] = unquote(pair.substr(colon + 1));
+            }
+
+            BenchmarkResult result{};
+            result.name = values["name"];
+            result.items = std::stoull(values["items"]);
+            result.runs = static_cast<uint32_t>(std::stoul(values["runs"]));
+            result.min = std::chrono::nanoseconds(std::stoll(values["min_ns"]));
+            result.median = std::chrono::nanoseconds(std::stoll(values["median_ns"]));
+            result.mean = std::chrono::nanoseconds(std::stoll(values["mean_ns"]));
+            results.push_back(std::move(result));
+
+            pos = end + 1;
+        }
+
+        return results;
+    }
+
+    /// <summary>
+    /// Compares time per item against a baseline, reporting every benchmark.
+    /// Returns the number of benchmarks slower than the baseline by more than threshold percent.
+    /// </summary>
+    inline size_t compareResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& current, double threshold, std::ostream& out)
+    {
+        std::map<std::string, const BenchmarkResult*> baseline_by_name;
+        for (const auto& result : baseline) {
+            baseline_by_name.emplace(result.name, &result);
+        }
+
+        size_t regressions = 0;
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+
+        out << std::left << std::setw(48) << "benchmark"
+            << std::right << std::setw(16) << "baseline (ns)"
+            << std::setw(16) << "current (ns)"
+            << std::setw(10) << "change" << "\n";
+
+        out << std::fixed << std::setprecision(1);
+        for (const auto& result : current) {
+            out << std::left << std::setw(48) << result.name << std::right;
+
+            const auto found = baseline_by_name.find(result.name);
+            if (found == baseline_by_name.end()) {
+                out << std::setw(16) << "-" << std::setw(16) << result.nanosecondsPerItem() << std::setw(10) << "new" << "\n";
+                continue;
+            }
+
+            const double before = found->second->nanosecondsPerItem();
+            const double after = result.nanosecondsPerItem();
+            const double change = before > 0 ? ((after - before) / before) * 100.0 : 0.0;
+            const bool regressed = change > threshold;
+
+            out << std::setw(16) << before
+                << std::setw(16) << after
+                << std::setw(9) << std::showpos << change << std::noshowpos << "%"
+                << (regressed ? "  REGRESSION" : "") << "\n";
+
+            if (regressed) {
+                regressions++;
+            }
+            baseline_by_name.erase(found);
+        }
+
+        for (const auto& [name, result] : baseline_by_name) {
+            out << std::left << std::setw(48) << name << std::right << std::setw(16) << result->nanosecondsPerItem()
+                << std::setw(16) << "-" << std::setw(10) << "missing" << "\n";
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+
+        return regressions;
+    }
+
+    /// <summary>
+    /// Repeats each benchmark until both the minimum time and minimum runs are reached, after a single warm up run.
+    /// </summary>
+    class BenchmarkRunner {
+    public:
+        using clock_t = std::chrono::steady_clock;
+
+        BenchmarkRunner(std::chrono::milliseconds min_time = std::chrono::milliseconds(500), uint32_t min_runs = 3, uint32_t max_runs = 1000, std::string filter = "") :
+            _min_time(min_time), _min_runs(min_runs), _max_runs(std::max(min_runs, max_runs)), _filter(std::move(filter))
+        {}
+
+        bool enabled(const std::string& name) const
+        {
+            return _filter.empty() || name.find(_filter) != std::string::npos;
+        }
+
+        template<typename Fn>
+        void run(const std::string& name, uint64_t items, Fn&& fn)
+        {
+            if (!enabled(name)) {
+                return;
+            }
+
+            fn();
+
+            std::vector<std::chrono::nanoseconds> times;
+            std::chrono::nanoseconds total{ 0 };
+
+            while (times.size() < _max_runs && (times.size() < _min_runs || total < _min_time)) {
+                const auto start = clock_t::now();
+                fn();
+                const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - start);
+                times.push_back(elapsed);
+                total += elapsed;
+            }
+
+            std::sort(times.begin(), times.end());
+
+            _results.push_back({
+                name,
+                items,
+                static_cast<uint32_t>(times.size()),
+                times.front(),
+                times[times.size() / 2],
+                total / static_cast<int64_t>(times.size())
+            });
+        }
+
+        const std::vector<BenchmarkResult>& results() const
+        {
+            return _results;
+        }
+
+        void writeJson(std::ostream& out) const
+        {
+            writeResultsJson(out, _results);
+        }
+
+        void report(std::ostream& out) const
+        {
+            const auto flags = out.flags();
+            const auto precision = out.precision();
+
+            out << std::left << std::setw(48) << "benchmark"
+                << std::right << std::setw(8) << "runs"
+                << std::setw(14) << "min (us)"
+                << std::setw(14) << "median (us)"
+                << std::setw(16) << "items/s" << "\n";
+
+            out << std::fixed << std::setprecision(1);
+            for (const auto& result : _results) {
+                out << std::left << std::setw(48) << result.name
+                    << std::right << std::setw(8) << result.runs
+                    << std::setw(14) << (result.min.count() / 1000.0)
+                    << std::setw(14) << (result.median.count() / 1000.0)
+                    << std::setw(16) << result.itemsPerSecond() << "\n";
+            }
+
+            out.flags(flags);
+            out.precision(precision);
+        }
+
+    private:
+        const std::chrono::nanoseconds _min_time;
+        const uint32_t _min_runs;
+        const uint32_t _max_runs;
+        const std::string _filter;
+        std::vector<BenchmarkResult> _results;
+    };
+}
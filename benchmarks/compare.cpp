@@ -0,0 +1,57 @@
+/*
+    Compares two benchmark json files, written by the benchmarks with --json.
+
+    Example usage:
+    benchmark_compare {baseline.json} {current.json} [--threshold {percent}]
+    - threshold = allowed slowdown in percent before a benchmark counts as regressed (default 10).
+
+    Exits with 1 when any benchmark regressed.
+*/
+
+#include "Benchmark.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace WDBReader::Benchmarks;
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::stod(argv[++i]);
+        }
+        else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.size() != 2) {
+        std::cerr << "Usage: benchmark_compare {baseline.json} {current.json} [--threshold {percent}]" << std::endl;
+        return 1;
+    }
+
+    std::vector<BenchmarkResult> results[2];
+    for (size_t i = 0; i < paths.size(); i++) {
+        std::ifstream in(paths[i]);
+        if (!in) {
+            std::cerr << "Unable to open: " << paths[i] << std::endl;
+            return 1;
+        }
+        results[i] = readResultsJson(in);
+    }
+
+    const auto regressions = compareResults(results[0], results[1], threshold, std::cout);
+    if (regressions > 0) {
+        std::cout << regressions << " benchmark(s) regressed by more than " << threshold << "%." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,440 @@
+/*
+    Benchmarks for WDBReader, using synthetic db files so no game data is required.
+
+    Example usage:
+    benchmarks [--records {count}] [--filter {text}] [--min-time {ms}] [--dir {path}] [--json {path}]
+    - records   = record count of the large fixtures (default 100000).
+    - filter    = only run benchmarks with names containing the text.
+    - min-time  = minimum time spent per benchmark in milliseconds (default 500).
+    - dir       = directory the fixtures are written to (default temp directory).
+    - json      = also write the results as json, comparable with benchmark_compare.
+
+    Fixtures are generated deterministically, so results are comparable between library versions.
+*/
+
+#include "Benchmark.hpp"
+
+#include <WDBReader/Database/DB2File.hpp>
+#include <WDBReader/Database/DBCFile.hpp>
+#include <WDBReader/Database/Writer.hpp>
+#include <WDBReader/Filesystem/MappedFilesystem.hpp>
+#include <WDBReader/ThreadPool.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace WDBReader;
+using namespace WDBReader::Benchmarks;
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+
+#pragma pack(push, 1)
+template<bool InlineId>
+struct BenchRecord : public FixedRecord<BenchRecord<InlineId>> {
+    struct Data {
+        uint32_t id;
+        string_data_t name;
+        uint32_t category;
+        uint16_t level;
+        uint8_t flags;
+        float scale;
+        uint32_t values[4];
+        string_data_t description;
+        uint32_t parentId;
+    } data;
+
+    size_t recordIndex;
+    RecordEncryption encryptionState;
+
+    constexpr static Schema schema = Schema(
+        Field::value<uint32_t>(InlineId ? Annotation().Id() : Annotation().Id().NonInline()),
+        Field::string(),
+        Field::value<uint32_t>(),
+        Field::value<uint16_t>(),
+        Field::value<uint8_t>(),
+        Field::value<float>(),
+        Field::value<uint32_t[4]>(),
+        Field::string(),
+        Field::value<uint32_t>()
+    );
+
+    static_assert(DB2Format::recordSizeDest(schema) == sizeof(data));
+};
+#pragma pack(pop)
+
+RuntimeSchema makeRuntimeSchema(bool inline_id)
+{
+    return RuntimeSchema({
+        Field::value<uint32_t>(inline_id ? Annotation().Id() : Annotation().Id().NonInline()),
+        Field::string(),
+        Field::value<uint32_t>(),
+        Field::value<uint16_t>(),
+        Field::value<uint8_t>(),
+        Field::value<float>(),
+        Field::value<uint32_t[4]>(),
+        Field::string(),
+        Field::value<uint32_t>()
+    }, {
+        "id",
+        "name",
+        "category",
+        "level",
+        "flags",
+        "scale",
+        "values",
+        "description",
+        "parentId"
+    });
+}
+
+enum class FixtureFormat {
+    WDBC,
+    WDB2,
+    WDC3,
+    WDC4,
+    WDC5
+};
+
+enum class StringDensity {
+    LIGHT,  // mostly empty strings.
+    HEAVY   // long, mostly unique strings.
+};
+
+enum class FixtureLayout {
+    PLAIN,      // no compression.
+    PACKED,     // bitpacked, pallet and common data columns.
+    SPARSE,     // offset map records with inline strings.
+    COPY_TABLE  // non inline ids, with some of the rows copied.
+};
+
+struct Fixture {
+public:
+    std::string name;
+    FixtureFormat format;
+    uint32_t records;
+    StringDensity strings;
+    FixtureLayout layout;
+    std::filesystem::path path;
+
+    bool inlineId() const
+    {
+        return layout != FixtureLayout::COPY_TABLE;
+    }
+
+    uint32_t copies() const
+    {
+        // copied rows are resolved with a linear search of the id list, keep the count modest.
+        return layout == FixtureLayout::COPY_TABLE ? records / 32 : 0;
+    }
+};
+
+inline uint64_t mix(uint64_t value)
+{
+    // splitmix64, stable across platforms unlike the std distributions.
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+std::string makeString(uint64_t seed, size_t min_length, size_t max_length)
+{
+    static constexpr char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ";
+    const size_t length = min_length + (mix(seed) % (max_length - min_length + 1));
+
+    std::string result;
+    result.reserve(length);
+    uint64_t state = seed;
+    for (size_t i = 0; i < length; i++) {
+        state = mix(state);
+        result.push_back(alphabet[state % (sizeof(alphabet) - 1)]);
+    }
+    return result;
+}
+
+writer_row_provider_t makeRows(const Fixture& fixture)
+{
+    return [&fixture](uint32_t index, writer_row_t& row) {
+        const uint64_t hash = mix(index);
+        const uint32_t id = (index * 2) + 1;
+
+        row.emplace_back(uint64_t(id));
+
+        if (fixture.strings == StringDensity::HEAVY) {
+            // half of the names repeat, descriptions are unique.
+            row.emplace_back(makeString(hash % 2 == 0 ? hash % 1024 : hash, 8, 40));
+        }
+        else {
+            row.emplace_back(hash % 8 == 0 ? makeString(hash % 64, 4, 12) : std::string());
+        }
+
+        row.emplace_back(uint64_t(hash % 32));
+        row.emplace_back(uint64_t(1 + ((hash >> 8) % 120)));
+        row.emplace_back(uint64_t((hash >> 16) % 10 == 0 ? (hash >> 24) % 256 : 0));
+        row.emplace_back(0.5f + static_cast<float>((hash >> 32) % 100) / 100.0f);
+
+        const uint64_t variant = (hash >> 40) % 16;
+        for (uint64_t i = 0; i < 4; i++) {
+            row.emplace_back(uint64_t(variant * 100 + i));
+        }
+
+        if (fixture.strings == StringDensity::HEAVY) {
+            row.emplace_back(makeString(hash ^ 0x5555, 48, 160));
+        }
+        else {
+            row.emplace_back(std::string());
+        }
+
+        row.emplace_back(uint64_t(index > 0 ? (hash % index) * 2 + 1 : 0));
+    };
+}
+
+void writeFixture(const Fixture& fixture)
+{
+    const auto schema = makeRuntimeSchema(fixture.inlineId());
+    const auto rows = makeRows(fixture);
+
+    std::ofstream out(fixture.path, std::ios::binary | std::ios::trunc);
+
+    auto write_modern = [&]<typename F>() {
+        DB2WriterOptions options;
+        options.tableHash = 0x12345678;
+        options.layoutHash = 0x9ABCDEF0;
+
+        if (fixture.layout == FixtureLayout::PACKED) {
+            options.compression = {
+                DB2FieldCompression::Bitpacked,                 // id
+                DB2FieldCompression::None,                      // name
+                DB2FieldCompression::BitpackedIndexed,          // category
+                DB2FieldCompression::Bitpacked,                 // level
+                DB2FieldCompression::CommonData,                // flags
+                DB2FieldCompression::None,                      // scale
+                DB2FieldCompression::BitpackedIndexedArray,     // values
+                DB2FieldCompression::None,                      // description
+                DB2FieldCompression::Bitpacked                  // parentId
+            };
+        }
+
+        options.sparse = fixture.layout == FixtureLayout::SPARSE;
+
+        for (uint32_t i = 0; i < fixture.copies(); i++) {
+            const uint32_t copied = static_cast<uint32_t>(mix(i) % fixture.records);
+            options.copyTable.push_back({ (fixture.records + i) * 2 + 1, copied * 2 + 1 });
+        }
+
+        writeDB2File<F>(out, schema, fixture.records, rows, options);
+    };
+
+    switch (fixture.format) {
+    case FixtureFormat::WDBC:
+        writeDBCFile(out, schema, fixture.records, rows);
+        break;
+    case FixtureFormat::WDB2:
+    {
+        DB2WriterOptions options;
+        options.tableHash = 0x12345678;
+        options.build = 15595;
+        writeDB2File<DB2FileFormatWDB2>(out, schema, fixture.records, rows, options);
+    }
+        break;
+    case FixtureFormat::WDC3:
+        write_modern.template operator()<DB2FileFormatWDC3>();
+        break;
+    case FixtureFormat::WDC4:
+        write_modern.template operator()<DB2FileFormatWDC4>();
+        break;
+    case FixtureFormat::WDC5:
+        write_modern.template operator()<DB2FileFormatWDC5>();
+        break;
+    }
+
+    if (!out) {
+        throw std::runtime_error("Unable to write fixture " + fixture.name);
+    }
+}
+
+template<TRecord R, TSchema S>
+std::unique_ptr<DataSource<R>> openFixture(const Fixture& fixture, const S& schema, ThreadPool* pool = nullptr)
+{
+    MappedFilesystem fs;
+
+    auto open = [&]<typename T>(std::unique_ptr<T> file) -> std::unique_ptr<DataSource<R>> {
+        if constexpr (requires { file->setThreadPool(pool); }) {
+            file->setThreadPool(pool);
+        }
+        file->open(fs.open(fixture.path));
+        file->load();
+        return file;
+    };
+
+    switch (fixture.format) {
+    case FixtureFormat::WDBC:
+        return open(std::make_unique<DBCFile<S, R, MappedFileSource, false>>(schema, DBCVersion::CATA_PLUS));
+    case FixtureFormat::WDB2:
+        return open(std::make_unique<DB2File<DB2FileFormatWDB2, S, R, MappedFileSource>>(schema));
+    case FixtureFormat::WDC3:
+        return open(std::make_unique<DB2File<DB2FileFormatWDC3, S, R, MappedFileSource>>(schema));
+    case FixtureFormat::WDC4:
+        return open(std::make_unique<DB2File<DB2FileFormatWDC4, S, R, MappedFileSource>>(schema));
+    case FixtureFormat::WDC5:
+        return open(std::make_unique<DB2File<DB2FileFormatWDC5, S, R, MappedFileSource>>(schema));
+    }
+
+    throw std::logic_error("Unknown fixture format.");
+}
+
+inline size_t stringLength(const RuntimeRecord& record, size_t element)
+{
+    const auto& str = std::get<string_data_t>(record.data[element]);
+    return str ? strlen(str.get()) : 0;
+}
+
+template<bool InlineId>
+inline size_t stringLength(const BenchRecord<InlineId>& record)
+{
+    return strlen(record.data.name.get()) + strlen(record.data.description.get());
+}
+
+template<TRecord R, TSchema S>
+void runFixture(BenchmarkRunner& runner, const Fixture& fixture, const S& schema, const std::string& record_type)
+{
+    const std::string prefix = fixture.name + "/" + record_type + "/";
+    const auto db = openFixture<R>(fixture, schema);
+    const uint32_t size = static_cast<uint32_t>(db->size());
+
+    runner.run(prefix + "open_load", 1, [&]() {
+        auto opened = openFixture<R>(fixture, schema);
+        doNotOptimize(opened->size());
+    });
+
+    if (fixture.format != FixtureFormat::WDBC && fixture.format != FixtureFormat::WDB2) {
+        static ThreadPool pool;
+        runner.run(prefix + "open_load_pooled", 1, [&]() {
+            auto opened = openFixture<R>(fixture, schema, &pool);
+            doNotOptimize(opened->size());
+        });
+    }
+
+    runner.run(prefix + "sequential", size, [&]() {
+        uint64_t sum = 0;
+        for (auto& record : *db) {
+            sum += record.recordIndex;
+        }
+        doNotOptimize(sum);
+    });
+
+    std::vector<uint32_t> indexes(size);
+    std::mt19937 engine(1234);
+    std::uniform_int_distribution<uint32_t> distribution(0, size > 0 ? size - 1 : 0);
+    for (auto& index : indexes) {
+        index = distribution(engine);
+    }
+
+    runner.run(prefix + "random", size, [&]() {
+        uint64_t sum = 0;
+        for (const auto index : indexes) {
+            sum += (*db)[index].recordIndex;
+        }
+        doNotOptimize(sum);
+    });
+
+    if (fixture.strings == StringDensity::HEAVY) {
+        runner.run(prefix + "strings", size, [&]() {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < size; i++) {
+                const auto record = (*db)[i];
+                if constexpr (std::is_same_v<R, RuntimeRecord>) {
+                    sum += stringLength(record, 1) + stringLength(record, 10);
+                }
+                else {
+                    sum += stringLength(record);
+                }
+            }
+            doNotOptimize(sum);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t records = 100000;
+    std::string filter;
+    std::chrono::milliseconds min_time(500);
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "wdbreader_benchmarks";
+    std::string json_path;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--records" && has_value) {
+            records = std::stoul(argv[++i]);
+        }
+        else if (arg == "--filter" && has_value) {
+            filter = argv[++i];
+        }
+        else if (arg == "--min-time" && has_value) {
+            min_time = std::chrono::milliseconds(std::stoul(argv[++i]));
+        }
+        else if (arg == "--dir" && has_value) {
+            dir = argv[++i];
+        }
+        else if (arg == "--json" && has_value) {
+            json_path = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Fixture> fixtures = {
+        { "wdbc_light", FixtureFormat::WDBC, records, StringDensity::LIGHT, FixtureLayout::PLAIN },
+        { "wdbc_heavy", FixtureFormat::WDBC, records, StringDensity::HEAVY, FixtureLayout::PLAIN },
+        { "wdb2_heavy", FixtureFormat::WDB2, records, StringDensity::HEAVY, FixtureLayout::PLAIN },
+        { "wdc3_small", FixtureFormat::WDC3, 256, StringDensity::LIGHT, FixtureLayout::PACKED },
+        { "wdc3_light", FixtureFormat::WDC3, records, StringDensity::LIGHT, FixtureLayout::PLAIN },
+        { "wdc3_heavy", FixtureFormat::WDC3, records, StringDensity::HEAVY, FixtureLayout::PLAIN },
+        { "wdc3_packed", FixtureFormat::WDC3, records, StringDensity::LIGHT, FixtureLayout::PACKED },
+        { "wdc3_sparse", FixtureFormat::WDC3, records, StringDensity::HEAVY, FixtureLayout::SPARSE },
+        { "wdc3_copy", FixtureFormat::WDC3, records, StringDensity::LIGHT, FixtureLayout::COPY_TABLE },
+        { "wdc4_packed", FixtureFormat::WDC4, records, StringDensity::HEAVY, FixtureLayout::PACKED },
+        { "wdc5_packed", FixtureFormat::WDC5, records, StringDensity::HEAVY, FixtureLayout::PACKED },
+        { "wdc5_sparse", FixtureFormat::WDC5, records, StringDensity::LIGHT, FixtureLayout::SPARSE },
+    };
+
+    std::filesystem::create_directories(dir);
+
+    BenchmarkRunner runner(min_time, 3, 1000, filter);
+
+    for (auto& fixture : fixtures) {
+        fixture.path = dir / (fixture.name + ".db");
+        writeFixture(fixture);
+
+        if (fixture.inlineId()) {
+            runFixture<RuntimeRecord>(runner, fixture, makeRuntimeSchema(true), "runtime");
+            runFixture<BenchRecord<true>>(runner, fixture, BenchRecord<true>::schema, "fixed");
+        }
+        else {
+            runFixture<RuntimeRecord>(runner, fixture, makeRuntimeSchema(false), "runtime");
+            runFixture<BenchRecord<false>>(runner, fixture, BenchRecord<false>::schema, "fixed");
+        }
+
+        std::filesystem::remove(fixture.path);
+    }
+
+    runner.report(std::cout);
+
+    if (!json_path.empty()) {
+        std::ofstream out(json_path, std::ios::trunc);
+        runner.writeJson(out);
+    }
+
+    return 0;
+}
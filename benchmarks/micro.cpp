@@ -0,0 +1,453 @@
+/*
+    Micro benchmarks for the hot decoding primitives, separate from the table benchmarks.
+
+    Example usage:
+    micro_benchmarks [--filter {text}] [--min-time {ms}] [--json {path}] [--baseline {path}] [--threshold {percent}]
+    - filter    = only run benchmarks with names containing the text.
+    - min-time  = minimum time spent per benchmark in milliseconds (default 200).
+    - json      = write the results as json, e.g. to store as a new baseline.
+    - baseline  = compare against previously written json, exits with 1 when any benchmark regressed.
+    - threshold = allowed slowdown in percent before a benchmark counts as regressed (default 10).
+*/
+
+#include "Benchmark.hpp"
+
+#include <WDBReader/Database/DB2File.hpp>
+#include <WDBReader/Database/Writer.hpp>
+#include <WDBReader/WoWDBDefs.hpp>
+#include <WDBReader/WoWDBDefsBundle.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace WDBReader;
+using namespace WDBReader::Benchmarks;
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+
+/// <summary>
+/// Minimal source over a byte buffer, used to fill a MemoryFileSource.
+/// </summary>
+class BufferFileSource {
+public:
+    BufferFileSource(std::vector<uint8_t> data) : _data(std::move(data)), _pos(0) {}
+
+    size_t size() const
+    {
+        return _data.size();
+    }
+
+    void read(void* dest, uint64_t bytes)
+    {
+        memcpy(dest, _data.data() + _pos, bytes);
+        _pos += bytes;
+    }
+
+    void setPos(uint64_t position)
+    {
+        _pos = position;
+    }
+
+    uint64_t getPos() const
+    {
+        return _pos;
+    }
+
+private:
+    std::vector<uint8_t> _data;
+    uint64_t _pos;
+};
+
+static_assert(TFileSource<BufferFileSource>);
+
+struct BitpackedInfo {
+    uint32_t bit_offset;
+    uint32_t bit_width;
+};
+
+void benchBitpacked(BenchmarkRunner& runner)
+{
+    constexpr size_t buffer_size = 64 * 1024;
+    constexpr size_t value_count = 4096;
+
+    std::mt19937 random(1234);
+    std::vector<uint8_t> buffer(buffer_size + sizeof(uint64_t));
+    for (auto& byte : buffer) {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    auto make_infos = [&](uint32_t max_width) {
+        std::vector<BitpackedInfo> infos(value_count);
+        for (auto& info : infos) {
+            info.bit_offset = random() % ((buffer_size - sizeof(uint64_t)) * 8);
+            info.bit_width = 1 + (random() % max_width);
+        }
+        return infos;
+    };
+
+    const auto infos32 = make_infos(32);
+    runner.run("bitpacked/getBitpackedValue/u32", value_count, [&]() {
+        uint32_t sum = 0;
+        for (const auto& info : infos32) {
+            sum += getBitpackedValue<uint32_t>(buffer.data() + (info.bit_offset / 8), info);
+        }
+        doNotOptimize(sum);
+    });
+
+    const auto infos64 = make_infos(57);
+    runner.run("bitpacked/getBitpackedValue/u64", value_count, [&]() {
+        uint64_t sum = 0;
+        for (const auto& info : infos64) {
+            sum += getBitpackedValue<uint64_t>(buffer.data() + (info.bit_offset / 8), info);
+        }
+        doNotOptimize(sum);
+    });
+}
+
+void benchStrings(BenchmarkRunner& runner)
+{
+    constexpr size_t string_count = 4096;
+
+    auto bench = [&](const std::string& name, size_t length) {
+        std::vector<uint8_t> data;
+        std::vector<uint64_t> positions;
+        for (size_t i = 0; i < string_count; i++) {
+            positions.push_back(data.size());
+            for (size_t c = 0; c < length; c++) {
+                data.push_back(static_cast<uint8_t>('a' + ((i + c) % 26)));
+            }
+            data.push_back('\0');
+        }
+
+        BufferFileSource buffer(std::move(data));
+        MemoryFileSource source(buffer);
+
+        runner.run("strings/readCurrentString/" + name, string_count, [&]() {
+            HeapStringStorage storage;
+            for (const auto position : positions) {
+                source.setPos(position);
+                auto str = readCurrentString(&source, storage);
+                doNotOptimize(str);
+            }
+        });
+
+        runner.run("strings/readCurrentString/" + name + "_arena", string_count, [&]() {
+            StringArena storage;
+            for (const auto position : positions) {
+                source.setPos(position);
+                auto str = readCurrentString(&source, storage);
+                doNotOptimize(str);
+            }
+        });
+    };
+
+    bench("short", 8);
+    bench("long", 120);
+}
+
+RuntimeSchema makeAccessorSchema()
+{
+    std::vector<Field> fields = {
+        Field::value<uint32_t>(Annotation().Id()),
+        Field::string(),
+        Field::value<float>()
+    };
+    std::vector<RuntimeSchema::field_name_t> names = { "ID", "Name", "Scale" };
+
+    for (uint32_t i = 0; i < 16; i++) {
+        fields.push_back(i % 2 == 0 ? Field::value<uint32_t>() : Field::value<uint16_t[2]>());
+        names.push_back("Field_" + std::to_string(i));
+    }
+
+    fields.push_back(Field::string());
+    names.push_back("Description");
+
+    return RuntimeSchema(std::move(fields), std::move(names));
+}
+
+void benchSchema(BenchmarkRunner& runner)
+{
+    constexpr size_t repeats = 1024;
+
+    const auto schema = makeAccessorSchema();
+
+    runner.run("schema/schemaFieldHandler", repeats * schema.fields().size(), [&]() {
+        size_t bytes = 0;
+        for (size_t i = 0; i < repeats; i++) {
+            for (const auto& field : schema.fields()) {
+                schemaFieldHandler(field, [&]<typename T>() {
+                    bytes += sizeof(T) * field.size;
+                });
+            }
+        }
+        doNotOptimize(bytes);
+    });
+
+    // a real record to read from, written and loaded from memory.
+    std::ostringstream stream;
+    writeDB2File<DB2FileFormatWDC3>(stream, schema, 1, [](uint32_t index, writer_row_t& row) {
+        row = { uint64_t(1), std::string("name"), 1.5f };
+        for (uint32_t i = 0; i < 16; i++) {
+            row.emplace_back(uint64_t(i));
+            if (i % 2 != 0) {
+                row.emplace_back(uint64_t(i + 1));
+            }
+        }
+        row.emplace_back(std::string("description"));
+    });
+
+    const auto bytes = stream.str();
+    BufferFileSource buffer(std::vector<uint8_t>(bytes.begin(), bytes.end()));
+    auto db2 = makeDB2File<MemoryFileSource>(schema, std::make_unique<MemoryFileSource>(buffer));
+    const auto record = (*db2)[0];
+
+    runner.run("schema/record_accessor/get_first", repeats, [&]() {
+        for (size_t i = 0; i < repeats; i++) {
+            auto [id] = schema(record).get<uint32_t>("ID");
+            doNotOptimize(id);
+        }
+    });
+
+    runner.run("schema/record_accessor/get_many", repeats, [&]() {
+        for (size_t i = 0; i < repeats; i++) {
+            auto values = schema(record).get<uint32_t, float, uint32_t, std::array<uint16_t, 2>, std::string>(
+                "ID", "Scale", "Field_8", "Field_15", "Description"
+            );
+            doNotOptimize(values);
+        }
+    });
+
+    runner.run("schema/record_accessor/get_last", repeats, [&]() {
+        for (size_t i = 0; i < repeats; i++) {
+            auto [description] = schema(record).get<std::string>("Description");
+            doNotOptimize(description);
+        }
+    });
+
+    runner.run("schema/record_accessor/get_many_compiled", repeats, [&]() {
+        const auto handles = schema.compile("ID", "Scale", "Field_8", "Field_15", "Description");
+        for (size_t i = 0; i < repeats; i++) {
+            auto values = schema(record).get<uint32_t, float, uint32_t, std::array<uint16_t, 2>, std::string>(handles);
+            doNotOptimize(values);
+        }
+    });
+}
+
+std::string makeDefinitionText()
+{
+    constexpr uint32_t column_count = 48;
+    constexpr uint32_t version_count = 32;
+
+    std::ostringstream out;
+    out << "COLUMNS\n";
+    out << "int ID\n";
+    out << "locstring Name_lang\n";
+    out << "float Scale\n";
+    out << "int<Parent::ID> ParentID\n";
+    for (uint32_t i = 0; i < column_count; i++) {
+        out << (i % 4 == 0 ? "string" : "int") << " Field_" << i << (i % 7 == 0 ? "? // unverified" : "") << "\n";
+    }
+
+    for (uint32_t version = 0; version < version_count; version++) {
+        out << "\nLAYOUT " << std::hex << (0x10000000 + version) << std::dec << "\n";
+        out << "BUILD 9." << version << ".0." << (30000 + version * 10) << "-9." << version << ".0." << (30000 + version * 10 + 9) << "\n";
+        out << "COMMENT synthetic\n";
+        out << "$id$ID<32>\n";
+        out << "Name_lang\n";
+        out << "Scale\n";
+        for (uint32_t i = 0; i < column_count; i++) {
+            if (i % 4 == 0) {
+                out << "Field_" << i << "\n";
+            }
+            else {
+                out << "Field_" << i << (i % 3 == 0 ? "<u16>" : "<32>") << (i % 5 == 0 ? "[3]" : "") << "\n";
+            }
+        }
+        out << "$noninline,relation$ParentID<32>\n";
+    }
+
+    return out.str();
+}
+
+void benchDefinitions(BenchmarkRunner& runner)
+{
+    const std::string text = makeDefinitionText();
+
+    runner.run("wowdbdefs/DBDReader::read", 1, [&]() {
+        std::istringstream stream(text);
+        auto definition = WoWDBDefs::DBDReader::read(stream);
+        doNotOptimize(definition);
+    });
+
+    std::istringstream stream(text);
+    const auto definition = WoWDBDefs::DBDReader::read(stream);
+
+    runner.run("wowdbdefs/makeSchema/first", 1, [&]() {
+        auto schema = WoWDBDefs::makeSchema(definition, GameVersion(9, 0, 0, 30005));
+        doNotOptimize(schema);
+    });
+
+    runner.run("wowdbdefs/makeSchema/last", 1, [&]() {
+        auto schema = WoWDBDefs::makeSchema(definition, GameVersion(9, 31, 0, 30315));
+        doNotOptimize(schema);
+    });
+
+    runner.run("wowdbdefs/makeSchema/missing", 1, [&]() {
+        auto schema = WoWDBDefs::makeSchema(definition, GameVersion(1, 12, 1, 5875));
+        doNotOptimize(schema);
+    });
+
+    WoWDBDefs::DefinitionRegistry registry;
+    registry.add("Synthetic", definition);
+
+    runner.run("wowdbdefs/registry/last", 1, [&]() {
+        auto schema = registry.schema("Synthetic", GameVersion(9, 31, 0, 30315));
+        doNotOptimize(schema);
+    });
+
+    runner.run("wowdbdefs/registry/missing", 1, [&]() {
+        auto schema = registry.schema("Synthetic", GameVersion(1, 12, 1, 5875));
+        doNotOptimize(schema);
+    });
+
+    std::ostringstream bundle_stream;
+    WoWDBDefs::writeDefinitionBundle(bundle_stream, registry);
+    const std::string bundle_text = bundle_stream.str();
+    const std::vector<uint8_t> bundle_bytes(bundle_text.begin(), bundle_text.end());
+
+    runner.run("wowdbdefs/bundle/open", 1, [&]() {
+        WoWDBDefs::DefinitionBundle bundle(bundle_bytes);
+        doNotOptimize(bundle);
+    });
+
+    const WoWDBDefs::DefinitionBundle bundle(bundle_bytes);
+
+    runner.run("wowdbdefs/bundle/last", 1, [&]() {
+        auto schema = bundle.schema("Synthetic", GameVersion(9, 31, 0, 30315));
+        doNotOptimize(schema);
+    });
+}
+
+void benchOrdering(BenchmarkRunner& runner)
+{
+    constexpr size_t key_count = 65536;
+
+    std::mt19937 random(1234);
+    std::vector<uint32_t> keys(key_count);
+    for (auto& key : keys) {
+        key = random() % 500000;
+    }
+
+    runner.run("ordering/radixSortPermutation", key_count, [&]() {
+        auto order = radixSortPermutation(keys);
+        doNotOptimize(order);
+    });
+
+    runner.run("ordering/std_stable_sort", key_count, [&]() {
+        std::vector<uint32_t> order(key_count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) {
+            return keys[a] < keys[b];
+        });
+        doNotOptimize(order);
+    });
+}
+
+void benchVersions(BenchmarkRunner& runner)
+{
+    constexpr size_t version_count = 1024;
+
+    std::vector<std::string> valid;
+    std::vector<std::string> invalid;
+    for (size_t i = 0; i < version_count; i++) {
+        valid.push_back(std::to_string(1 + i % 11) + "." + std::to_string(i % 4) + "." + std::to_string(i % 8) + "." + std::to_string(5875 + i * 37));
+        invalid.push_back(std::to_string(1 + i % 11) + "." + std::to_string(i % 4));
+    }
+
+    runner.run("version/GameVersion/parse", version_count, [&]() {
+        for (const auto& str : valid) {
+            auto version = GameVersion(str);
+            doNotOptimize(version);
+        }
+    });
+
+    runner.run("version/GameVersion/fromString_invalid", version_count, [&]() {
+        for (const auto& str : invalid) {
+            auto version = GameVersion::fromString(str);
+            doNotOptimize(version);
+        }
+    });
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::chrono::milliseconds min_time(200);
+    std::string json_path;
+    std::string baseline_path;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--filter" && has_value) {
+            filter = argv[++i];
+        }
+        else if (arg == "--min-time" && has_value) {
+            min_time = std::chrono::milliseconds(std::stoul(argv[++i]));
+        }
+        else if (arg == "--json" && has_value) {
+            json_path = argv[++i];
+        }
+        else if (arg == "--baseline" && has_value) {
+            baseline_path = argv[++i];
+        }
+        else if (arg == "--threshold" && has_value) {
+            threshold = std::stod(argv[++i]);
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(min_time, 5, 100000, filter);
+
+    benchBitpacked(runner);
+    benchStrings(runner);
+    benchSchema(runner);
+    benchDefinitions(runner);
+    benchOrdering(runner);
+    benchVersions(runner);
+
+    runner.report(std::cout);
+
+    if (!json_path.empty()) {
+        std::ofstream out(json_path, std::ios::trunc);
+        runner.writeJson(out);
+    }
+
+    if (!baseline_path.empty()) {
+        std::ifstream in(baseline_path);
+        if (!in) {
+            std::cerr << "Unable to open baseline: " << baseline_path << std::endl;
+            return 1;
+        }
+
+        std::cout << "\n";
+        const auto regressions = compareResults(readResultsJson(in), runner.results(), threshold, std::cout);
+        if (regressions > 0) {
+            std::cout << regressions << " benchmark(s) regressed by more than " << threshold << "%." << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -3,11 +3,35 @@
 #include "Filesystem.hpp"
 #include "Database/Schema.hpp"
 #include "Database/Formats.hpp"
+#include "Database/RadixSort.hpp"
+#include <algorithm>
+#include <cassert>
+#include <concepts>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <variant>
+#include <vector>
 
 namespace WDBReader::Database {
 
+    template<TRecord R>
+    class OrderedRange;
+
+    /// <summary>
+    /// Single field element read by DataSource::readElement. Integers hold the fields unsigned value zero extended.
+    /// </summary>
+    using column_value_t = std::variant<uint64_t, float, std::string>;
+
+    /// <summary>
+    /// Random access to the records of a table. Instances are not safe for concurrent reads, operator[] and recordIds() can move the
+    /// file position and reuse a record buffer, so each thread needs its own source (or a lock around reads). orderedById() is the exception.
+    /// </summary>
     template<TRecord R>
 	class DataSource {
 	public:
@@ -104,8 +128,326 @@ namespace WDBReader::Database {
         iterator cend() const {
             return iterator(this, this->size());
         }
+
+        /// <summary>
+        /// ID of every record index (copy table rows included), taken from the formats id storage where it has one.
+        /// Empty when the source cant provide IDs.
+        /// </summary>
+        virtual std::vector<uint32_t> recordIds() const {
+            return {};
+        }
+
+        /// <summary>
+        /// Reads one element of a field from the record at index, without decoding the rest of the record.
+        /// Gives the records encryption state (value is left untouched when encrypted), or nullopt when the source cant read a single element,
+        /// in which case the record has to be decoded in full. Same threading rules as operator[].
+        /// </summary>
+        virtual std::optional<RecordEncryption> readElement(uint32_t index, size_t field_index, size_t array_index, column_value_t& value) const {
+            return std::nullopt;
+        }
+
+        /// <summary>
+        /// Records in ascending ID order. The order is radix sorted from recordIds() on first use and kept, so the source must already be loaded.
+        /// Safe to call from multiple threads, the order is only built once.
+        /// </summary>
+        OrderedRange<R> orderedById() const;
+
+    private:
+        mutable std::once_flag _id_order_once;
+        mutable std::shared_ptr<const std::vector<uint32_t>> _id_order;
 	};
 
+    /// <summary>
+    /// Records of a data source visited in a given order, ranges over the same order share it rather than copy it.
+    /// </summary>
+    template<TRecord R>
+    class OrderedRange {
+    public:
+        struct iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+
+            using value_type = R;
+            using pointer_type = R*;
+            using reference_type = R&;
+
+            iterator(const OrderedRange* owner, size_t position) :
+                _owner(owner), _position(position), _loaded_position(-1)
+            {}
+
+            reference_type operator*()
+            {
+                set_val();
+                return _val;
+            }
+
+            pointer_type operator->()
+            {
+                set_val();
+                return &_val;
+            }
+
+            iterator& operator++()
+            {
+                _position++;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+
+            friend bool operator==(const iterator& a, const iterator& b) {
+                assert(a._owner == b._owner);
+                return a._position == b._position;
+            };
+            friend bool operator!=(const iterator& a, const iterator& b) {
+                assert(a._owner == b._owner);
+                return a._position != b._position;
+            };
+
+        private:
+            inline void set_val() {
+                if (_position != _loaded_position) {
+                    _val = (*_owner)[static_cast<uint32_t>(_position)];
+                    _loaded_position = _position;
+                }
+            }
+
+            R _val;
+            size_t _position;
+            size_t _loaded_position;
+            const OrderedRange* _owner;
+        };
+
+        OrderedRange(const DataSource<R>* source, std::shared_ptr<const std::vector<uint32_t>> order) :
+            _source(source), _order(std::move(order))
+        {}
+
+        inline size_t size() const {
+            return _order->size();
+        }
+
+        inline R operator[](uint32_t position) const {
+            return (*_source)[(*_order)[position]];
+        }
+
+        /// <summary>
+        /// Record indexes of the source, in visiting order.
+        /// </summary>
+        inline const std::vector<uint32_t>& indexes() const {
+            return *_order;
+        }
+
+        iterator begin() const {
+            return iterator(this, 0);
+        }
+
+        iterator end() const {
+            return iterator(this, size());
+        }
+
+    private:
+        const DataSource<R>* _source;
+        std::shared_ptr<const std::vector<uint32_t>> _order;
+    };
+
+    template<TRecord R>
+    OrderedRange<R> DataSource<R>::orderedById() const {
+        // other callers wait until the order is set, if building it throws the next call tries again.
+        std::call_once(_id_order_once, [this]() {
+            auto ids = recordIds();
+            if (ids.size() != this->size()) {
+                throw WDBReaderException("Data source doesnt provide record ids.");
+            }
+
+            _id_order = std::make_shared<const std::vector<uint32_t>>(radixSortPermutation(std::move(ids)));
+        });
+
+        return OrderedRange<R>(this, _id_order);
+    }
+
+    template<TSchema S>
+    std::optional<size_t> idFieldIndex(const S& schema) {
+        const auto& fields = schema.fields();
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (fields[i].annotation.isId && fields[i].type == Field::Type::INT) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// <summary>
+    /// Index of the first field with the name, using the schemas own lookup when it has one (RuntimeSchema hashes its names).
+    /// </summary>
+    template<TNamedSchema S>
+    size_t namedFieldIndex(const S& schema, std::string_view field_name) {
+        if constexpr (requires { { schema.fieldIndex(field_name) } -> std::convertible_to<std::optional<uint32_t>>; }) {
+            if (const auto index = schema.fieldIndex(field_name); index.has_value()) {
+                return *index;
+            }
+        }
+        else {
+            const auto& names = schema.names();
+            const auto found = std::find(names.begin(), names.end(), field_name);
+            if (found != names.end()) {
+                return static_cast<size_t>(std::distance(names.begin(), found));
+            }
+        }
+
+        throw WDBReaderException("Unknown field name.");
+    }
+
+    namespace DatabaseDetail {
+
+        struct ElementLocation {
+            uint32_t elementIndex;
+            ptrdiff_t dataOffset;
+        };
+
+        /// <summary>
+        /// Where a decoded element lives, matching the offsets the loaders pass to insertValue.
+        /// </summary>
+        template<TSchema S>
+        ElementLocation elementLocation(const S& schema, size_t field_index, size_t array_index) {
+            const auto& fields = schema.fields();
+            if (field_index >= fields.size() || array_index >= fields[field_index].size) {
+                throw WDBReaderException("Field element out of range.");
+            }
+
+            ElementLocation location{ 0, 0 };
+            for (size_t i = 0; i <= field_index; i++) {
+                const size_t elements = i == field_index ? array_index : fields[i].size;
+                schemaFieldHandler(fields[i], [&]<typename T>() {
+                    location.dataOffset += sizeof(T) * elements;
+                });
+                location.elementIndex += static_cast<uint32_t>(elements);
+            }
+
+            return location;
+        }
+    }
+
+    /// <summary>
+    /// Calls fn(record_index, value) with a single element of a field from the first count records, converted to T.
+    /// T is std::string for string fields, any arithmetic type otherwise (signed fields convert through their signed type). Encrypted records are skipped.
+    /// Each element is read with DataSource::readElement, records are only decoded in full by sources that cant read a single element.
+    /// </summary>
+    template<typename T, TSchema S, TRecord R, typename Fn>
+    void forEachColumnValue(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index, size_t count, Fn fn) {
+        const Field& field = schema.fields().at(field_index);
+        const auto location = DatabaseDetail::elementLocation(schema, field_index, array_index);
+        const uint32_t record_count = static_cast<uint32_t>(std::min(count, source.size()));
+
+        schemaFieldHandler(field, [&]<typename V>() {
+            if constexpr (std::is_same_v<V, string_data_t> != std::is_same_v<T, std::string>) {
+                throw WDBReaderException("Column type doesnt match field type.");
+            }
+            else {
+                column_value_t element;
+                for (uint32_t i = 0; i < record_count; i++) {
+                    const auto encryption = source.readElement(i, field_index, array_index, element);
+                    if (encryption.has_value()) {
+                        if (encryption.value() == RecordEncryption::ENCRYPTED) {
+                            continue;
+                        }
+
+                        if constexpr (std::is_same_v<V, string_data_t>) {
+                            fn(i, std::move(std::get<std::string>(element)));
+                        }
+                        else if constexpr (std::is_integral_v<V>) {
+                            const V value = static_cast<V>(std::get<uint64_t>(element));
+                            fn(i, field.annotation.isSigned ? static_cast<T>(static_cast<std::make_signed_t<V>>(value)) : static_cast<T>(value));
+                        }
+                        else {
+                            fn(i, static_cast<T>(std::get<float>(element)));
+                        }
+                        continue;
+                    }
+
+                    const R record = source[i];
+                    if (record.encryptionState == RecordEncryption::ENCRYPTED) {
+                        continue;
+                    }
+
+                    const V& value = R::template extractValue<V>(&record, location.elementIndex, location.dataOffset);
+                    if constexpr (std::is_same_v<V, string_data_t>) {
+                        fn(i, std::string(value ? value.get() : ""));
+                    }
+                    else if constexpr (std::is_integral_v<V>) {
+                        fn(i, field.annotation.isSigned ? static_cast<T>(static_cast<std::make_signed_t<V>>(value)) : static_cast<T>(value));
+                    }
+                    else {
+                        fn(i, static_cast<T>(value));
+                    }
+                }
+            }
+        });
+    }
+
+    /// <summary>
+    /// Decodes a single element of a field from the first count records, converted to T (see forEachColumnValue). Encrypted records give T().
+    /// Only the values are kept, rather than whole records.
+    /// </summary>
+    template<typename T, TSchema S, TRecord R>
+    std::vector<T> decodeColumn(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index = 0, std::optional<size_t> count = std::nullopt) {
+        std::vector<T> values(std::min(count.value_or(source.size()), source.size()));
+        forEachColumnValue<T>(schema, source, field_index, array_index, values.size(), [&values](uint32_t record_index, T value) {
+            values[record_index] = std::move(value);
+        });
+        return values;
+    }
+
+    /// <summary>
+    /// Records ordered by a single field element (stable, ascending). Numeric fields are radix sorted on the decoded column alone,
+    /// strings are compared by content.
+    /// </summary>
+    template<TSchema S, TRecord R>
+    OrderedRange<R> sortedBy(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index = 0) {
+        const Field& field = schema.fields().at(field_index);
+        std::vector<uint32_t> order;
+
+        schemaFieldHandler(field, [&]<typename V>() {
+            if constexpr (std::is_same_v<V, string_data_t>) {
+                const auto keys = decodeColumn<std::string>(schema, source, field_index, array_index);
+                order.resize(keys.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) {
+                    return keys[a] < keys[b];
+                });
+            }
+            else {
+                auto sort_as = [&]<typename K>() {
+                    const auto values = decodeColumn<K>(schema, source, field_index, array_index);
+                    std::vector<decltype(radixKey(K()))> keys(values.size());
+                    std::transform(values.begin(), values.end(), keys.begin(), [](K value) { return radixKey(value); });
+                    order = radixSortPermutation(std::move(keys));
+                };
+
+                if constexpr (std::is_integral_v<V>) {
+                    if (field.annotation.isSigned) {
+                        sort_as.template operator()<std::make_signed_t<V>>();
+                        return;
+                    }
+                }
+
+                sort_as.template operator()<V>();
+            }
+        });
+
+        return OrderedRange<R>(&source, std::make_shared<const std::vector<uint32_t>>(std::move(order)));
+    }
+
+    template<TNamedSchema S, TRecord R>
+    OrderedRange<R> sortedBy(const S& schema, const DataSource<R>& source, std::string_view field_name, size_t array_index = 0) {
+        return sortedBy(schema, source, namedFieldIndex(schema, field_name), array_index);
+    }
+
 	template<typename T, typename R, typename FS>
 	concept TDataSource = requires(T t) {
         std::is_base_of_v<DataSource<R>, T>;
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "../Database.hpp"
+#include "../Filesystem.hpp"
+#include "../ThreadPool.hpp"
+#include "../Trace.hpp"
+#include "../WoWDBDefs.hpp"
+#include "Definitions.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	template<Filesystem::TFileUri FU>
+	struct BuildTable {
+	public:
+		std::string name;
+		FU file;
+	};
+
+	struct BuildLoadOptions {
+	public:
+		size_t threads = std::max(1u, std::thread::hardware_concurrency());
+		uint64_t maxInFlightBytes = 0;							// 0 for no limit, a single table over the limit is still loaded alone.
+		DBCStringLocale dbcLocale = DBCStringLocale::enUS;		// only used for pre cata dbc files.
+	};
+
+	struct BuildLoadFailure {
+	public:
+		std::string name;
+		std::string reason;
+	};
+
+	struct BuildLoadResult {
+	public:
+		size_t loaded = 0;
+		std::vector<BuildLoadFailure> failed;
+		uint64_t bytes = 0;
+		uint64_t peakInFlightBytes = 0;
+		std::chrono::nanoseconds time{ 0 };
+	};
+
+	namespace BuildLoaderDetail {
+
+		/// <summary>
+		/// Bounds the total size of the tables open at once. A table larger than the limit waits until nothing else is open.
+		/// </summary>
+		class ByteBudget final {
+		public:
+			ByteBudget(uint64_t max_bytes) : _max_bytes(max_bytes), _in_flight(0), _peak(0) {}
+
+			void acquire(uint64_t bytes) {
+				std::unique_lock lock(_mutex);
+				if (_max_bytes != 0) {
+					_released.wait(lock, [this, bytes]() { return _in_flight == 0 || _in_flight + bytes <= _max_bytes; });
+				}
+				_in_flight += bytes;
+				_peak = std::max(_peak, _in_flight);
+			}
+
+			void release(uint64_t bytes) {
+				{
+					std::scoped_lock lock(_mutex);
+					_in_flight -= bytes;
+				}
+				_released.notify_all();
+			}
+
+			uint64_t peak() const {
+				std::scoped_lock lock(_mutex);
+				return _peak;
+			}
+
+		private:
+			const uint64_t _max_bytes;
+			mutable std::mutex _mutex;
+			std::condition_variable _released;
+			uint64_t _in_flight;
+			uint64_t _peak;
+		};
+
+		/// <summary>
+		/// resolve(name, reason) gives the tables schema, or nullptr with the reason set.
+		/// </summary>
+		template<typename FSys, Filesystem::TFileUri FU, typename MakeFS, typename Resolve, typename Sink>
+		BuildLoadResult load(MakeFS& make_filesystem, Resolve& resolve, const GameVersion& build, const std::vector<BuildTable<FU>>& tables, const BuildLoadOptions& options, Sink& sink) {
+			WDBREADER_TRACE_SCOPE("database", "loadBuild");
+			const auto start = std::chrono::steady_clock::now();
+
+			const size_t thread_count = std::max<size_t>(1, options.threads);
+
+			// only touched by the worker of the same index, declared first so the pool is stopped before they close.
+			std::vector<std::unique_ptr<FSys>> filesystems(thread_count);
+			ByteBudget budget(options.maxInFlightBytes);
+			ThreadPool pool(thread_count);
+
+			std::mutex result_mutex;
+			BuildLoadResult result;
+
+			auto fail = [&](const std::string& name, std::string reason) {
+				std::scoped_lock lock(result_mutex);
+				result.failed.push_back({ name, std::move(reason) });
+			};
+
+			std::vector<std::future<void>> pending;
+			pending.reserve(tables.size());
+
+			for (const auto& table : tables) {
+				pending.push_back(pool.submit([&, table_ptr = &table]() {
+					const auto& table = *table_ptr;
+					WDBREADER_TRACE_SCOPE("database", "loadBuild::table", table.name);
+
+					try {
+						std::string reason;
+						const std::shared_ptr<const RuntimeSchema> schema = resolve(table.name, reason);
+						if (schema == nullptr) {
+							fail(table.name, std::move(reason));
+							return;
+						}
+
+						auto& filesystem = filesystems[pool.currentWorker()];
+						if (filesystem == nullptr) {
+							filesystem = make_filesystem();
+						}
+
+						auto source = filesystem->open(table.file);
+						if (source == nullptr) {
+							fail(table.name, "Unable to open file.");
+							return;
+						}
+
+						const uint64_t bytes = source->size();
+						budget.acquire(bytes);
+						auto budget_guard = ScopeGuard([&budget, bytes]() { budget.release(bytes); });
+
+						auto db = makeDBFile(*schema, std::move(source), build, options.dbcLocale, &pool);
+						sink(table, *schema, *db);
+
+						std::scoped_lock lock(result_mutex);
+						result.loaded++;
+						result.bytes += bytes;
+					}
+					catch (const std::exception& e) {
+						fail(table.name, e.what());
+					}
+				}));
+			}
+
+			for (auto& future : pending) {
+				future.get();
+			}
+
+			result.peakInFlightBytes = budget.peak();
+			result.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			return result;
+		}
+	}
+
+	/// <summary>
+	/// Opens every table of a build on a pool, passing each to sink(table, schema, source) as soon as it is ready.
+	/// Each worker opens files through its own filesystem from make_filesystem(), so CASC and MPQ handles arent shared between threads.
+	/// The sink is called from the workers concurrently and must be done with the source when it returns, as the sources
+	/// read from the workers filesystem. Tables that fail (no definition for the build, unreadable, or the sink throws) are reported rather than rethrown.
+	/// </summary>
+	template<typename FSys, Filesystem::TFileUri FU, typename MakeFS, typename Sink>
+	BuildLoadResult loadBuild(MakeFS make_filesystem,
+		const std::map<std::string, WoWDBDefs::DBDefinition>& definitions,
+		const GameVersion& build,
+		const std::vector<BuildTable<FU>>& tables,
+		const BuildLoadOptions& options,
+		Sink sink)
+	{
+		auto resolve = [&](const std::string& name, std::string& reason) -> std::shared_ptr<const RuntimeSchema> {
+			const auto definition = definitions.find(name);
+			if (definition == definitions.end()) {
+				reason = "No definition.";
+				return nullptr;
+			}
+
+			auto schema = WoWDBDefs::makeSchema(definition->second, build);
+			if (!schema.has_value()) {
+				reason = "No definition for build.";
+				return nullptr;
+			}
+
+			return std::make_shared<const RuntimeSchema>(std::move(*schema));
+		};
+
+		return BuildLoaderDetail::load<FSys, FU>(make_filesystem, resolve, build, tables, options, sink);
+	}
+
+	/// <summary>
+	/// As above, with schemas resolved (and cached) by the registry.
+	/// </summary>
+	template<typename FSys, Filesystem::TFileUri FU, typename MakeFS, typename Sink>
+	BuildLoadResult loadBuild(MakeFS make_filesystem,
+		const WoWDBDefs::DefinitionRegistry& registry,
+		const GameVersion& build,
+		const std::vector<BuildTable<FU>>& tables,
+		const BuildLoadOptions& options,
+		Sink sink)
+	{
+		auto resolve = [&](const std::string& name, std::string& reason) -> std::shared_ptr<const RuntimeSchema> {
+			if (!registry.contains(name)) {
+				reason = "No definition.";
+				return nullptr;
+			}
+
+			auto schema = registry.schema(name, build);
+			if (schema == nullptr) {
+				reason = "No definition for build.";
+			}
+			return schema;
+		};
+
+		return BuildLoaderDetail::load<FSys, FU>(make_filesystem, resolve, build, tables, options, sink);
+	}
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "../Database.hpp"
+#include "../Filesystem.hpp"
+#include "../Trace.hpp"
+#include "DB2File.hpp"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	/// <summary>
+	/// Named tables of a build, each mapped to its file (FileDataID or MPQ path) and schema.
+	/// Tables are opened on first use, when a size limit is given the least recently used tables are closed to stay within it.
+	/// The limit is measured in file size, as a proxy for memory, not the bytes the opened sources actually hold. Pointers still held
+	/// by callers keep a closed table alive without counting towards the limit.
+	/// Indexes built through the catalog are kept when a table is closed, record indexes stay valid as the file is unchanged.
+	/// </summary>
+	template<typename FSys, Filesystem::TFileUri FU, TSchema S = RuntimeSchema, TRecord R = RuntimeRecord>
+	class Catalog final {
+	public:
+		using file_source_t = typename decltype(std::declval<FSys&>().open(std::declval<const FU&>()))::element_type;
+		using opener_t = std::function<std::unique_ptr<DataSource<R>>(const S&, std::unique_ptr<file_source_t>)>;
+
+		struct Stats {
+			size_t hits;
+			size_t misses;			// tables opened from the filesystem.
+			size_t evictions;
+			uint64_t residentBytes;	// file size of the tables currently open, not including closed tables still held by callers.
+			size_t openTables;
+			size_t tables;
+		};
+
+		static constexpr uint64_t UNLIMITED = 0;
+
+		Catalog(FSys* filesystem, uint64_t max_bytes = UNLIMITED, opener_t opener = defaultOpener) :
+			_filesystem(filesystem), _max_bytes(max_bytes), _opener(std::move(opener)),
+			_resident_bytes(0), _hits(0), _misses(0), _evictions(0)
+		{}
+
+		Catalog(const Catalog&) = delete;
+		Catalog& operator=(const Catalog&) = delete;
+
+		/// <summary>
+		/// Adds a table, tables arent removed once added.
+		/// </summary>
+		void add(const std::string& name, FU file, S schema) {
+			std::scoped_lock lock(_mutex);
+
+			const auto [it, inserted] = _tables.try_emplace(name, std::move(file), std::move(schema));
+			if (!inserted) {
+				throw WDBReaderException("Catalog table already exists.");
+			}
+		}
+
+		bool contains(std::string_view name) const {
+			std::scoped_lock lock(_mutex);
+			return _tables.find(name) != _tables.end();
+		}
+
+		std::vector<std::string> tables() const {
+			std::scoped_lock lock(_mutex);
+			std::vector<std::string> names;
+			names.reserve(_tables.size());
+			for (const auto& [name, table] : _tables) {
+				names.push_back(name);
+			}
+			return names;
+		}
+
+		/// <summary>
+		/// The reference stays valid for the life of the catalog.
+		/// </summary>
+		const S& schema(std::string_view name) const {
+			std::scoped_lock lock(_mutex);
+			return *get(name).schema;
+		}
+
+		/// <summary>
+		/// Returns the opened table, opening it if needed. The table stays usable through the returned pointer even if
+		/// the catalog later closes it or is itself destroyed, the pointer shares ownership of the tables schema.
+		/// A closed table no longer counts towards the size limit.
+		/// Every caller shares the same source, so its reads are serialised by a per table lock and it can be read from any thread.
+		/// </summary>
+		std::shared_ptr<const DataSource<R>> open(std::string_view name) {
+			Table* table = nullptr;
+			{
+				std::scoped_lock lock(_mutex);
+				table = &get(name);
+				if (table->source != nullptr) {
+					_hits++;
+					_lru.splice(_lru.begin(), _lru, table->lru);
+					return table->source;
+				}
+			}
+
+			WDBREADER_TRACE_SCOPE("database", "Catalog::open", std::string(name));
+
+			// opened outside the lock so other tables can be served meanwhile, only the filesystem itself is serialised.
+			std::unique_ptr<file_source_t> file;
+			{
+				std::scoped_lock lock(_filesystem_mutex);
+				file = _filesystem->open(table->file);
+			}
+
+			if (file == nullptr) {
+				throw WDBReaderException("Unable to open catalog table.");
+			}
+
+			const uint64_t bytes = file->size();
+			std::unique_ptr<DataSource<R>> opened = _opener(*table->schema, std::move(file));
+			if (opened == nullptr) {
+				throw WDBReaderException("Unable to open catalog table.");
+			}
+
+			std::shared_ptr<DataSource<R>> source = std::make_shared<OpenedTable>(table->schema, std::move(opened));
+
+			std::scoped_lock lock(_mutex);
+			if (table->source != nullptr) {
+				// another thread opened it first.
+				_hits++;
+				_lru.splice(_lru.begin(), _lru, table->lru);
+				return table->source;
+			}
+
+			_misses++;
+			table->source = std::move(source);
+			table->bytes = bytes;
+			_lru.push_front(table);
+			table->lru = _lru.begin();
+			_resident_bytes += bytes;
+
+			evict();
+
+			return table->source;
+		}
+
+		/// <summary>
+		/// Closes the table if open, its indexes are kept.
+		/// </summary>
+		void release(std::string_view name) {
+			std::scoped_lock lock(_mutex);
+			close(get(name));
+		}
+
+		/// <summary>
+		/// Returns the index stored under key for the table, building it with build(schema, source) the first time.
+		/// </summary>
+		template<typename T, typename Fn>
+		std::shared_ptr<const T> index(std::string_view name, const std::string& key, Fn build) {
+			{
+				std::scoped_lock lock(_mutex);
+				const auto& indexes = get(name).indexes;
+				const auto found = indexes.find(key);
+				if (found != indexes.end()) {
+					if (found->second.type != std::type_index(typeid(T))) {
+						throw WDBReaderException("Catalog index type mismatch.");
+					}
+					return std::static_pointer_cast<const T>(found->second.value);
+				}
+			}
+
+			const auto source = open(name);
+			std::shared_ptr<const T> built = std::make_shared<const T>(build(schema(name), *source));
+
+			std::scoped_lock lock(_mutex);
+			auto [it, inserted] = get(name).indexes.try_emplace(key, Index{ std::type_index(typeid(T)), built });
+			if (!inserted && it->second.type != std::type_index(typeid(T))) {
+				throw WDBReaderException("Catalog index type mismatch.");
+			}
+			return std::static_pointer_cast<const T>(it->second.value);
+		}
+
+		Stats stats() const {
+			std::scoped_lock lock(_mutex);
+			return Stats{ _hits, _misses, _evictions, _resident_bytes, _lru.size(), _tables.size() };
+		}
+
+		static std::unique_ptr<DataSource<R>> defaultOpener(const S& schema, std::unique_ptr<file_source_t> source) {
+			return makeDB2File<S, R, file_source_t>(schema, std::move(source));
+		}
+
+	protected:
+		struct Index {
+			std::type_index type;
+			std::shared_ptr<const void> value;
+		};
+
+		/// <summary>
+		/// Source handed out by open(). Reads of the opened source move its file position and reuse its record buffer,
+		/// so they are made one at a time. The source reads through a reference to the schema, which is kept alive with it.
+		/// </summary>
+		class OpenedTable final : public DataSource<R> {
+		public:
+			OpenedTable(std::shared_ptr<const S> table_schema, std::unique_ptr<DataSource<R>> table_source) :
+				_schema(std::move(table_schema)), _source(std::move(table_source))
+			{}
+
+			size_t size() const override {
+				return _source->size();
+			}
+
+			R operator[](uint32_t index) const override {
+				std::scoped_lock lock(_read_mutex);
+				return (*_source)[index];
+			}
+
+			DBFormat format() const override {
+				return _source->format();
+			}
+
+			std::vector<uint32_t> recordIds() const override {
+				std::scoped_lock lock(_read_mutex);
+				return _source->recordIds();
+			}
+
+			std::optional<RecordEncryption> readElement(uint32_t index, size_t field_index, size_t array_index, column_value_t& value) const override {
+				std::scoped_lock lock(_read_mutex);
+				return _source->readElement(index, field_index, array_index, value);
+			}
+
+		private:
+			std::shared_ptr<const S> _schema;
+			std::unique_ptr<DataSource<R>> _source;	// declared after the schema, so destroyed before it.
+			mutable std::mutex _read_mutex;
+		};
+
+		struct Table {
+			Table(FU file_uri, S table_schema) : file(std::move(file_uri)), schema(std::make_shared<const S>(std::move(table_schema))), bytes(0) {}
+
+			const FU file;
+			const std::shared_ptr<const S> schema;
+			std::shared_ptr<DataSource<R>> source;
+			uint64_t bytes;
+			typename std::list<Table*>::iterator lru;	// only valid while open.
+			std::unordered_map<std::string, Index> indexes;
+		};
+
+		Table& get(std::string_view name) {
+			auto found = _tables.find(name);
+			if (found == _tables.end()) {
+				throw WDBReaderException("Unknown catalog table.");
+			}
+			return found->second;
+		}
+
+		const Table& get(std::string_view name) const {
+			auto found = _tables.find(name);
+			if (found == _tables.end()) {
+				throw WDBReaderException("Unknown catalog table.");
+			}
+			return found->second;
+		}
+
+		void close(Table& table) {
+			if (table.source != nullptr) {
+				_lru.erase(table.lru);
+				_resident_bytes -= table.bytes;
+				table.source.reset();
+				table.bytes = 0;
+			}
+		}
+
+		void evict() {
+			if (_max_bytes == UNLIMITED) {
+				return;
+			}
+
+			// the most recently opened table is kept even when it alone is over the limit.
+			while (_resident_bytes > _max_bytes && _lru.size() > 1) {
+				close(*_lru.back());
+				_evictions++;
+			}
+		}
+
+		FSys* _filesystem;
+		const uint64_t _max_bytes;
+		const opener_t _opener;
+
+		mutable std::mutex _mutex;
+		std::mutex _filesystem_mutex;
+		std::map<std::string, Table, std::less<>> _tables;
+		std::list<Table*> _lru;	// open tables, most recently used first.
+		uint64_t _resident_bytes;
+		size_t _hits;
+		size_t _misses;
+		size_t _evictions;
+	};
+}
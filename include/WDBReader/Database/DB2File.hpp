@@ -1,9 +1,14 @@
 #pragma once
 
 #include "../Database.hpp"
+#include "../ThreadPool.hpp"
 #include "../Utility.hpp"
 #include "DB2Format.hpp"
+#include "LoadStats.hpp"
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <ranges>
 #include <type_traits>
 #include <vector>
@@ -14,6 +19,21 @@ namespace WDBReader::Database {
 	template<typename T>
 	using integer_equivelant_t = std::conditional_t<std::is_same_v<T, float>, uint32_t, T>;
 
+	/// <summary>
+	/// Extracts a bitpacked value, buff points to the byte containing the first bit.
+	/// At least 8 bytes must be readable from buff.
+	/// </summary>
+	template<typename T, typename D>
+	inline T getBitpackedValue(const uint8_t* buff, const D& compression_data)
+		requires (sizeof(T) <= sizeof(uint64_t))
+	{
+		const auto bit_width = compression_data.bit_width;
+		const auto bits_to_read = compression_data.bit_offset & 7;
+
+		const auto val = *reinterpret_cast<uint64_t const*>(buff) << (64 - bits_to_read - bit_width) >> (64 - bit_width);
+		return static_cast<T>(val);
+	}
+
 	class DB2Format {
 	public:
 		template<TSchema S>
@@ -109,9 +129,19 @@ namespace WDBReader::Database {
 		DynArray<typename F::FieldStructure> fieldStructures;
 		DynArray<typename F::FieldStorageInfo> fieldStorage;
 
-		std::unique_ptr<DynArray<typename F::PalletValue>[]> indexedPalletData;
-		std::unique_ptr<DynArray<typename F::CommonValue>[]> indexedCommonData;	//	only used for loading.
-		std::unique_ptr<std::unordered_map<typename F::CommonValue::id_t, typename F::CommonValue::value_t>[]> commonData;
+		/// <summary>
+		/// Pallet or common data of a single field, only read from the source when the field is first accessed.
+		/// </summary>
+		struct FieldData {
+		public:
+			uint64_t offset = 0;		// position of the fields block in the file.
+			std::once_flag once;
+			std::atomic<bool> loaded = false;
+			DynArray<typename F::PalletValue> pallet;
+			std::unordered_map<typename F::CommonValue::id_t, typename F::CommonValue::value_t> common;
+		};
+
+		std::unique_ptr<FieldData[]> fieldData;
 
 		std::vector<db2_record_id_t> idList;
 		std::vector<typename F::CopyTableEntry> copyTable;
@@ -119,6 +149,54 @@ namespace WDBReader::Database {
 		std::vector<db2_record_id_t> offsetMapIds;
 		std::vector<typename F::RelationshipEntry> relationships;	// only used during loading.
 		std::unordered_map<decltype(F::RelationshipEntry::record_index), decltype(F::RelationshipEntry::foreign_id)> relationshipMap;
+
+		/// <summary>
+		/// Returns the pallet or common data of the field, reading it on first use. The source position is left unchanged.
+		/// </summary>
+		template<Filesystem::TFileSource FS>
+		const FieldData& loadFieldData(uint32_t field_index, FS* source) {
+			auto& data = fieldData[field_index];
+
+			std::call_once(data.once, [&]() {
+				const auto& storage = fieldStorage[field_index];
+
+				// positionless sources can be read from several fields at once, others share the single position.
+				auto read_block = [&](void* dest) {
+					if constexpr (Filesystem::TPositionlessFileSource<FS>) {
+						source->readAt(dest, data.offset, storage.additional_data_size);
+					}
+					else {
+						const auto restore_pos = source->getPos();
+						auto restore = ScopeGuard([&]() {
+							source->setPos(restore_pos);
+						});
+
+						source->setPos(data.offset);
+						source->read(dest, storage.additional_data_size);
+					}
+				};
+
+				if (storage.compression_type == DB2FieldCompression::BitpackedIndexed ||
+					storage.compression_type == DB2FieldCompression::BitpackedIndexedArray) {
+					data.pallet = DynArray<typename F::PalletValue>(storage.additional_data_size / sizeof(typename F::PalletValue));
+					read_block(data.pallet.get());
+				}
+				else if (storage.compression_type == DB2FieldCompression::CommonData && storage.additional_data_size > 0) {
+					const auto common_count = storage.additional_data_size / sizeof(typename F::CommonValue);
+					DynArray<typename F::CommonValue> values(common_count);
+					read_block(values.get());
+
+					data.common.reserve(common_count);
+					for (size_t i = 0; i < common_count; i++) {
+						data.common[values[i].record_id] = values[i].value;
+					}
+				}
+
+				data.loaded = true;
+			});
+
+			return data;
+		}
 	};
 
 	template<TDB2FormatModern F, TRecord R>
@@ -128,13 +206,17 @@ namespace WDBReader::Database {
 		virtual void loadSection(const typename F::SectionHeader& format) = 0;		
 		virtual uint32_t size() const = 0;
 		virtual R operator[](uint32_t index) const = 0;
+
+		virtual std::optional<RecordEncryption> readElement(uint32_t index, size_t field_index, size_t array_index, column_value_t& value) const {
+			return std::nullopt;
+		}
 	};
 
-	template<TDB2FormatModern F, TSchema S, TRecord R, Filesystem::TFileSource FS>
+	template<TDB2FormatModern F, TSchema S, TRecord R, Filesystem::TFileSource FS, TStringStorage SS>
 	class DB2LoaderStandard final : public DB2Loader<F, R> {
 	public:
-		DB2LoaderStandard(const S& schema, const DB2LoadInfo& load, DB2Structure<F>& structure, FS* source) :
-			_schema(schema), _load_info(load), _structure(structure), _source(source), _record_size(DB2Format::recordSizeSrc(schema))
+		DB2LoaderStandard(const S& schema, const DB2LoadInfo& load, DB2Structure<F>& structure, FS* source, SS* strings) :
+			_schema(schema), _load_info(load), _structure(structure), _source(source), _strings(strings), _record_size(DB2Format::recordSizeSrc(schema))
 		{
 			_section_offsets.reserve(_structure.header.section_count);
 			_buffer.resize(_structure.header.record_size);
@@ -143,6 +225,7 @@ namespace WDBReader::Database {
 		virtual ~DB2LoaderStandard() = default;
 
 		void loadSection(const typename F::SectionHeader& section) override {
+			WDBREADER_TRACE_SCOPE("database", "DB2LoaderStandard::loadSection");
 
 			SectionOffset current{
 				_structure.header.record_size * section.record_count,
@@ -168,36 +251,13 @@ namespace WDBReader::Database {
 		}
 
 		R operator[](uint32_t index) const override {
+			WDBREADER_TRACE_RECORD_SCOPE("record", "DB2Loader::operator[]", std::to_string(index));
 
-			uint32_t lookup_index = index;
-			std::optional<db2_record_id_t> replacement_id;
-
-			if (index >= _structure.header.record_count) {
-				const auto& copy_entry = _structure.copyTable[index - _structure.header.record_count];
-				auto id_it = std::ranges::find(_structure.idList, copy_entry.id_of_copied_row);
-
-				if (id_it == _structure.idList.end()) {
-					throw WDBReaderException("Copy table id doesnt exist.");
-				}
-
-				lookup_index = std::distance(_structure.idList.begin(), id_it);
-				replacement_id = copy_entry.id_of_new_row;
-			}
-
-			const auto section_index = getSectionIndex(lookup_index);
-			const SectionOffset& offset = _section_offsets[section_index];
-			const auto& section_header = _structure.sectionHeaders[section_index];
-			const auto section_record_index_start = offset.recordIndexEnd - section_header.record_count;
-			const auto relative_record_index = lookup_index - section_record_index_start;
-
-			const bool is_encypted_section = section_header.tact_key_hash != 0;
-
-			const uint64_t source_record_start_pos = section_header.file_offset + (relative_record_index * _structure.header.record_size);
-			_source->setPos(source_record_start_pos);
-
-			std::fill(_buffer.begin(), _buffer.end(), 0);
-		
-			_source->read(_buffer.data(), _structure.header.record_size);
+			const RecordLocation location = readRecordBuffer(index);
+			const uint32_t lookup_index = location.lookupIndex;
+			const std::optional<db2_record_id_t>& replacement_id = location.replacementId;
+			const bool is_encypted_section = location.encryptedSection;
+			const uint64_t source_record_start_pos = location.startPos;
 
 			R record;	
 			record.recordIndex = index;
@@ -267,7 +327,7 @@ namespace WDBReader::Database {
 								str_pos -= (_structure.header.record_count - _structure.sectionHeaders[0].record_count) * _structure.header.record_size; //weird fix need for multi section records.
 								_source->setPos(str_pos);
 
-								R::insertValue(&record, schema_field_index, z, view_offset, std::move(readCurrentString(_source)));
+								R::insertValue(&record, schema_field_index, z, view_offset, std::move(readCurrentString(_source, *_strings)));
 								view_offset += sizeof(T);
 							}
 							else {
@@ -333,8 +393,150 @@ namespace WDBReader::Database {
 			return std::move(record); 
 		}
 
+		/// <summary>
+		/// Reads the records bytes and decodes only the requested element, along with its pallet or common data.
+		/// </summary>
+		std::optional<RecordEncryption> readElement(uint32_t index, size_t field_index, size_t array_index, column_value_t& value) const override {
+			const RecordLocation location = readRecordBuffer(index);
+			RecordEncryption encryption = RecordEncryption::NONE;
+
+			db2_record_id_t id_list_use_id = 0;
+			if (_load_info.useIdList) {
+				id_list_use_id = location.replacementId.has_value() ? location.replacementId.value() : _structure.idList[location.lookupIndex];
+				if (id_list_use_id == 0 && location.encryptedSection) {
+					return RecordEncryption::ENCRYPTED;
+				}
+			}
+
+			if (location.encryptedSection) {
+				if (std::all_of(_buffer.begin(), _buffer.end(), [](auto i) { return i == 0; })) {
+					return RecordEncryption::ENCRYPTED;
+				}
+				encryption = RecordEncryption::DECRYPTED;
+			}
+
+			const Field& schema_field = _schema.fields()[field_index];
+
+			if (_load_info.useIdList && field_index == 0) {
+				value = uint64_t(id_list_use_id);
+				return encryption;
+			}
+
+			const uint32_t file_field_index = static_cast<uint32_t>(field_index - (_load_info.useIdList ? 1 : 0));
+			if (file_field_index >= _structure.header.field_count) {
+				assert(schema_field.annotation.isRelation && !schema_field.annotation.isInline);
+				if ((_structure.header.flags & DB2HeaderFlags::HasRelationshipData) != 0) {
+					throw std::logic_error("DB2 Relations using ID has not yet been implemented.");
+				}
+
+				const auto relation = _structure.relationshipMap.find(location.lookupIndex);
+				value = uint64_t(relation != _structure.relationshipMap.end() ? relation->second : 0);
+				return encryption;
+			}
+
+			if (schema_field.annotation.isId && location.replacementId.has_value()) {
+				value = uint64_t(location.replacementId.value());
+				return encryption;
+			}
+
+			schemaFieldHandler(schema_field, [&]<typename T>() {
+				if constexpr (std::is_same_v<string_data_t, T>) {
+					const auto str_ref = getRecordFieldValue<string_ref_t>(_buffer.data(), file_field_index, static_cast<uint32_t>(array_index), 0);
+					auto str_pos = location.startPos +
+						(_structure.fieldStorage[file_field_index].field_offset_bits / 8) +
+						str_ref;
+
+					str_pos -= (_structure.header.record_count - _structure.sectionHeaders[0].record_count) * _structure.header.record_size; //weird fix need for multi section records.
+					_source->setPos(str_pos);
+					value = readCurrentStringValue(_source);
+				}
+				else {
+					db2_record_id_t record_id = 0;
+					if (_structure.fieldStorage[file_field_index].compression_type == DB2FieldCompression::CommonData) {
+						if (_load_info.useIdList) {
+							record_id = id_list_use_id;
+						}
+						else {
+							record_id = location.replacementId.has_value() ? location.replacementId.value() : inlineRecordId();
+						}
+					}
+
+					const T element = getRecordFieldValue<T>(_buffer.data(), file_field_index, static_cast<uint32_t>(array_index), record_id);
+					if constexpr (std::is_floating_point_v<T>) {
+						value = element;
+					}
+					else {
+						value = uint64_t(element);
+					}
+				}
+			});
+
+			return encryption;
+		}
+
 	protected:
 
+		struct RecordLocation {
+			uint32_t lookupIndex;
+			std::optional<db2_record_id_t> replacementId;
+			uint64_t startPos;
+			bool encryptedSection;
+		};
+
+		/// <summary>
+		/// Resolves copy table rows to the record they copy and reads that records bytes into the buffer.
+		/// </summary>
+		RecordLocation readRecordBuffer(uint32_t index) const {
+			RecordLocation location{ index, std::nullopt, 0, false };
+
+			if (index >= _structure.header.record_count) {
+				const auto& copy_entry = _structure.copyTable[index - _structure.header.record_count];
+				auto id_it = std::ranges::find(_structure.idList, copy_entry.id_of_copied_row);
+
+				if (id_it == _structure.idList.end()) {
+					throw WDBReaderException("Copy table id doesnt exist.");
+				}
+
+				location.lookupIndex = static_cast<uint32_t>(std::distance(_structure.idList.begin(), id_it));
+				location.replacementId = copy_entry.id_of_new_row;
+			}
+
+			const auto section_index = getSectionIndex(location.lookupIndex);
+			const SectionOffset& offset = _section_offsets[section_index];
+			const auto& section_header = _structure.sectionHeaders[section_index];
+			const auto section_record_index_start = offset.recordIndexEnd - section_header.record_count;
+			const auto relative_record_index = location.lookupIndex - section_record_index_start;
+
+			location.encryptedSection = section_header.tact_key_hash != 0;
+			location.startPos = section_header.file_offset + (relative_record_index * _structure.header.record_size);
+			_source->setPos(location.startPos);
+
+			std::fill(_buffer.begin(), _buffer.end(), 0);
+		
+			_source->read(_buffer.data(), _structure.header.record_size);
+
+			return location;
+		}
+
+		/// <summary>
+		/// ID of the record in the buffer, read from the inline id field. Only used without an id list.
+		/// </summary>
+		db2_record_id_t inlineRecordId() const {
+			const auto id_field = idFieldIndex(_schema);
+			if (!id_field.has_value()) {
+				throw std::logic_error("Record id not set when accessing common data.");
+			}
+
+			db2_record_id_t record_id = 0;
+			schemaFieldHandler(_schema.fields()[id_field.value()], [&]<typename T>() {
+				if constexpr (std::is_integral_v<T>) {
+					record_id = static_cast<db2_record_id_t>(getRecordFieldValue<T>(_buffer.data(), static_cast<uint32_t>(id_field.value()), 0, 0));
+				}
+			});
+
+			return record_id;
+		}
+
 		template<typename T>
 		inline T getRecordFieldValue(uint8_t* buff, uint32_t field_index, uint32_t array_index, db2_record_id_t record_id) const {
 			
@@ -361,8 +563,9 @@ namespace WDBReader::Database {
 					throw std::logic_error("Record id not set when accessing common data.");
 				}
 
-				auto map_itr = _structure.commonData[field_index].find(record_id);
-				if (map_itr != _structure.commonData[field_index].end()) {
+				const auto& common = _structure.loadFieldData(field_index, _source).common;
+				auto map_itr = common.find(record_id);
+				if (map_itr != common.end()) {
 					return map_itr->second;
 				}
 
@@ -373,7 +576,7 @@ namespace WDBReader::Database {
 			{
 				const auto offset = field_info.compression_data.pallet.bit_offset / 8 + _structure.header.bitpacked_data_offset;
 				const auto pallet_index = getBitpackedValue<uint64_t>(buff + offset, field_info.compression_data.pallet);
-				T value = _structure.indexedPalletData[field_index][pallet_index].value;
+				T value = _structure.loadFieldData(field_index, _source).pallet[pallet_index].value;
 				return value;
 			}
 				break;
@@ -382,7 +585,7 @@ namespace WDBReader::Database {
 				const auto offset = field_info.compression_data.pallet.bit_offset / 8 + _structure.header.bitpacked_data_offset;
 				const auto pallet_index = getBitpackedValue<uint64_t>(buff + offset, field_info.compression_data.pallet);
 				const size_t key = (pallet_index * field_info.compression_data.pallet.array_size) + array_index;
-				T value = _structure.indexedPalletData[field_index][key].value;
+				T value = _structure.loadFieldData(field_index, _source).pallet[key].value;
 				return value;
 			}
 				break;
@@ -400,17 +603,6 @@ namespace WDBReader::Database {
 			return T(0);
 		}
 
-		template<typename T, typename D>
-		inline T getBitpackedValue(uint8_t* buff, const D& compression_data) const 
-			requires (sizeof(T) <= sizeof(uint64_t))
-		{
-			const auto bit_width = compression_data.bit_width;
-			const auto bits_to_read = compression_data.bit_offset & 7;
-		
-			const auto val = *reinterpret_cast<uint64_t const*>(buff) << (64 - bits_to_read - bit_width) >> (64 - bit_width);
-			return val;
-		}
-
 		uint32_t getSectionIndex(uint32_t record_index) const {
 			uint32_t section = 0;
 			for (; section < _structure.header.section_count; ++section)
@@ -437,18 +629,20 @@ namespace WDBReader::Database {
 		DB2Structure<F>& _structure;
 		std::vector<SectionOffset> _section_offsets;
 		FS* _source;
+		SS* _strings;
 		mutable std::vector<uint8_t> _buffer;
 	};
 
-	template<TDB2FormatModern F, TSchema S, TRecord R, Filesystem::TFileSource FS>
+	template<TDB2FormatModern F, TSchema S, TRecord R, Filesystem::TFileSource FS, TStringStorage SS>
 	class DB2LoaderSparse final : public DB2Loader<F, R> {
 	public:
-		DB2LoaderSparse(const S& schema, const DB2LoadInfo& load, DB2Structure<F>& structure, FS* source) : 
-			_schema(schema), _load_info(load), _structure(structure), _source(source), _record_size(DB2Format::recordSizeSrc(schema))
+		DB2LoaderSparse(const S& schema, const DB2LoadInfo& load, DB2Structure<F>& structure, FS* source, SS* strings) : 
+			_schema(schema), _load_info(load), _structure(structure), _source(source), _strings(strings), _record_size(DB2Format::recordSizeSrc(schema))
 		{}
 		virtual ~DB2LoaderSparse() = default;
 
 		void loadSection(const typename F::SectionHeader& section) override {
+			WDBREADER_TRACE_SCOPE("database", "DB2LoaderSparse::loadSection");
 			_source->setPos(section.offset_records_end);
 		}
 
@@ -457,6 +651,7 @@ namespace WDBReader::Database {
 		}
 		
 		R operator[](uint32_t index) const override {
+			WDBREADER_TRACE_RECORD_SCOPE("record", "DB2Loader::operator[]", std::to_string(index));
 
 			uint32_t lookup_index = index;
 			std::optional<db2_record_id_t> replacement_id;
@@ -541,13 +736,9 @@ namespace WDBReader::Database {
 						schemaFieldHandler(schema_field, [&]<typename T>() {
 							if constexpr (std::is_same_v<string_data_t, T>) {
 								std::string_view str_view((char*)(_buffer.data() + buffer_offset));
-								const auto str_bytes_size = str_view.size() + 1; // add null terminator.
-								buffer_offset += str_bytes_size;
+								buffer_offset += str_view.size() + 1; // add null terminator.
 
-								T result = std::make_unique_for_overwrite<typename T::element_type[]>(str_bytes_size);
-								memcpy(result.get(), str_view.data(), str_bytes_size);
-
-								R::insertValue(&record, schema_field_index, z, view_offset, std::move(result));
+								R::insertValue(&record, schema_field_index, z, view_offset, _strings->store(str_view));
 								view_offset += sizeof(T);
 							}
 							else {
@@ -615,22 +806,27 @@ namespace WDBReader::Database {
 		const DB2LoadInfo& _load_info;
 		DB2Structure<F>& _structure;
 		FS* _source;
+		SS* _strings;
 		mutable std::vector<uint8_t> _buffer;
 	};
 
-	template<TDB2Format F, TSchema S, TRecord R, Filesystem::TFileSource FS>
+	template<TDB2Format F, TSchema S, TRecord R, Filesystem::TFileSource FS, TStringStorage SS = HeapStringStorage>
 	class DB2File final : std::false_type {};
 
-	template<TDB2FormatModern F, TSchema S, TRecord R, Filesystem::TFileSource FS>
-	class DB2File<F, S, R, FS> final : public DataSource<R> {
+	template<TDB2FormatModern F, TSchema S, TRecord R, Filesystem::TFileSource FS, TStringStorage SS>
+	class DB2File<F, S, R, FS, SS> final : public DataSource<R> {
 	public:
-		DB2File(const S& schema) : _format(F()), _schema(schema), _load_info(DB2LoadInfo::make(schema)) {}
+		DB2File(const S& schema, SS strings = SS()) : _format(F()), _schema(schema), _load_info(DB2LoadInfo::make(schema)), _strings(std::move(strings)) {}
 		virtual ~DB2File() = default;
 
 		void open(std::unique_ptr<FS> source) {
+			WDBREADER_TRACE_SCOPE("database", "DB2File::open", std::string(F::signature.str()));
 			_file_source = std::move(source);
 
-			_file_source->read(&_structure.header, sizeof(_structure.header));
+			{
+				auto timer = _stats.time(LoadPhase::HEADER, _file_source.get());
+				_file_source->read(&_structure.header, sizeof(_structure.header));
+			}
 
 			if (_structure.header.signature != F::signature.integer) {
 				throw WDBReaderException("Header signature doesnt match.");
@@ -648,64 +844,66 @@ namespace WDBReader::Database {
 				throw WDBReaderException("Schema field count doesnt match structure.");
 			}
 
-			_structure.sectionHeaders = DynArray<typename F::SectionHeader>(_structure.header.section_count);
-			_file_source->read(_structure.sectionHeaders.get(), sizeof(F::SectionHeader) * _structure.header.section_count);
-			
+			{
+				auto timer = _stats.time(LoadPhase::SECTION_HEADERS, _file_source.get());
+				_structure.sectionHeaders = DynArray<typename F::SectionHeader>(_structure.header.section_count);
+				_file_source->read(_structure.sectionHeaders.get(), sizeof(F::SectionHeader) * _structure.header.section_count);
+			}
 
-			_structure.fieldStructures = DynArray<typename F::FieldStructure>(_structure.header.field_count);
-			_file_source->read(_structure.fieldStructures.get(), sizeof(F::FieldStructure) * _structure.header.field_count);
+			{
+				auto timer = _stats.time(LoadPhase::FIELD_STRUCTURES, _file_source.get());
+				_structure.fieldStructures = DynArray<typename F::FieldStructure>(_structure.header.field_count);
+				_file_source->read(_structure.fieldStructures.get(), sizeof(F::FieldStructure) * _structure.header.field_count);
+			}
 
 			if (_structure.header.field_storage_info_size > 0) {
+				auto timer = _stats.time(LoadPhase::FIELD_STORAGE, _file_source.get());
 				_structure.fieldStorage = DynArray<typename F::FieldStorageInfo>(_structure.header.total_field_count);
 				_file_source->read(_structure.fieldStorage.get(), sizeof(F::FieldStorageInfo) * _structure.header.total_field_count);
 			}
 
-			_structure.indexedPalletData = std::make_unique_for_overwrite<DynArray<typename F::PalletValue>[]>(_structure.header.total_field_count);
-			if (_structure.header.pallet_data_size > 0) {
-				for (uint32_t i = 0; i < _structure.header.total_field_count; ++i) {
-					const auto compression = _structure.fieldStorage[i].compression_type;
-					if (compression == DB2FieldCompression::BitpackedIndexed ||
-						compression == DB2FieldCompression::BitpackedIndexedArray) {
-						_structure.indexedPalletData[i] = DynArray<typename F::PalletValue>(_structure.fieldStorage[i].additional_data_size / sizeof(F::PalletValue));
-						_file_source->read(_structure.indexedPalletData[i].get(), _structure.fieldStorage[i].additional_data_size);
+			// pallet and common data are only located here, each fields block is read on first access.
+			_structure.fieldData = std::make_unique<typename DB2Structure<F>::FieldData[]>(_structure.header.total_field_count);
+			{
+				uint64_t pallet_offset = _file_source->getPos();
+				uint64_t common_offset = pallet_offset + _structure.header.pallet_data_size;
+
+				for (uint32_t i = 0; _structure.header.field_storage_info_size > 0 && i < _structure.header.total_field_count; ++i) {
+					const auto& storage = _structure.fieldStorage[i];
+					if (storage.compression_type == DB2FieldCompression::BitpackedIndexed ||
+						storage.compression_type == DB2FieldCompression::BitpackedIndexedArray) {
+						_structure.fieldData[i].offset = pallet_offset;
+						pallet_offset += storage.additional_data_size;
 					}
-				}
-			}
-
-			_structure.indexedCommonData = std::make_unique_for_overwrite<DynArray<typename F::CommonValue>[]>(_structure.header.total_field_count);
-			_structure.commonData = std::make_unique_for_overwrite<std::unordered_map<typename F::CommonValue::id_t, typename F::CommonValue::value_t>[]>(_structure.header.total_field_count);
-			if (_structure.header.common_data_size > 0) {
-				for (uint32_t i = 0; i < _structure.header.total_field_count; ++i) {
-					if (_structure.fieldStorage[i].compression_type == DB2FieldCompression::CommonData &&
-						_structure.fieldStorage[i].additional_data_size > 0) {
-
-						const auto common_count = _structure.fieldStorage[i].additional_data_size / sizeof(F::CommonValue);
-
-						_structure.indexedCommonData[i] = DynArray<typename F::CommonValue>(common_count);
-						_file_source->read(_structure.indexedCommonData[i].get(), _structure.fieldStorage[i].additional_data_size);
-
-						for (auto addition = 0; addition < common_count; addition++) {
-							const auto& record = _structure.indexedCommonData[i][addition];
-							_structure.commonData[i][record.record_id] = record.value;
-						}
+					else if (storage.compression_type == DB2FieldCompression::CommonData) {
+						_structure.fieldData[i].offset = common_offset;
+						common_offset += storage.additional_data_size;
 					}
 				}
+
+				_file_source->setPos(_file_source->getPos() + _structure.header.pallet_data_size + _structure.header.common_data_size);
 			}
 
 			if (isSparse()) {
-				_loader = std::make_unique<DB2LoaderSparse<F, S, R, FS>>(_schema, _load_info, _structure, _file_source.get());
+				_loader = std::make_unique<DB2LoaderSparse<F, S, R, FS, SS>>(_schema, _load_info, _structure, _file_source.get(), &_strings);
 			}
 			else [[ likely ]] {
-				_loader = std::make_unique<DB2LoaderStandard<F, S, R, FS>>(_schema, _load_info, _structure, _file_source.get());
+				_loader = std::make_unique<DB2LoaderStandard<F, S, R, FS, SS>>(_schema, _load_info, _structure, _file_source.get(), &_strings);
 			}
 		}
 
 		void load() {
+			WDBREADER_TRACE_SCOPE("database", "DB2File::load", std::string(F::signature.str()));
 			
 			if (_load_info.useIdList && _structure.header.record_count > 0) {
 				_structure.idList.reserve(_structure.header.record_count);
 			}
 
+			bool parallel_blocks = false;
+			if constexpr (Filesystem::TPositionlessFileSource<FS>) {
+				parallel_blocks = _pool != nullptr;
+			}
+
 			for (uint32_t i = 0; i < _structure.header.section_count; i++) {
 				const typename F::SectionHeader& section = _structure.sectionHeaders[i];
 
@@ -725,25 +923,35 @@ namespace WDBReader::Database {
 				}
 
 				_file_source->setPos(section.file_offset);
-				_loader->loadSection(section);
+				{
+					auto timer = _stats.time(LoadPhase::RECORDS, _file_source.get());
+					_loader->loadSection(section);
+				}
 
 				if (section.tact_key_hash != 0) {
 					//...
 				}
 
+				if (parallel_blocks) {
+					continue;
+				}
+
 				if (section.id_list_size) {
+					auto timer = _stats.time(LoadPhase::ID_LIST, _file_source.get());
 					const auto old_id_list_size = _structure.idList.size();
 					_structure.idList.resize(old_id_list_size + (section.id_list_size / sizeof(uint32_t)));
 					_file_source->read(&_structure.idList[old_id_list_size], section.id_list_size);
 				}
 
 				if (section.copy_table_count > 0) {
+					auto timer = _stats.time(LoadPhase::COPY_TABLE, _file_source.get());
 					const auto old_copy_table_size = _structure.copyTable.size();
 					_structure.copyTable.resize(old_copy_table_size + section.copy_table_count);
 					_file_source->read(&_structure.copyTable[old_copy_table_size], section.copy_table_count * sizeof(F::CopyTableEntry));
 				}
 
 				if (section.offset_map_id_count > 0) {
+					auto timer = _stats.time(LoadPhase::OFFSET_MAP, _file_source.get());
 					const auto old_offset_map_size = _structure.offsetMap.size();
 					_structure.offsetMap.resize(old_offset_map_size + section.offset_map_id_count);
 					_file_source->read(&_structure.offsetMap[old_offset_map_size], section.offset_map_id_count * sizeof(F::OffsetMapEntry));
@@ -759,13 +967,21 @@ namespace WDBReader::Database {
 				}
 			}
 
-			_structure.relationshipMap.reserve(_structure.relationships.size());
-			for (const auto& relation : _structure.relationships) {
-				//assert(!_structure.relationshipMap.contains(relation.record_index));	//TODO this doesnt work with encrypted sections, where its filled with zero.
-				_structure.relationshipMap.emplace(relation.record_index, relation.foreign_id);
+			if constexpr (Filesystem::TPositionlessFileSource<FS>) {
+				if (parallel_blocks) {
+					_loadSectionBlocksParallel();
+				}
+			}
+
+			{
+				auto timer = _stats.time(LoadPhase::RELATIONSHIP_MAP, _file_source.get());
+				_structure.relationshipMap.reserve(_structure.relationships.size());
+				for (const auto& relation : _structure.relationships) {
+					//assert(!_structure.relationshipMap.contains(relation.record_index));	//TODO this doesnt work with encrypted sections, where its filled with zero.
+					_structure.relationshipMap.emplace(relation.record_index, relation.foreign_id);
+				}
 			}
 
-			_structure.indexedCommonData.reset();
 			_structure.relationships.clear();
 
 #ifdef _DEBUG
@@ -787,11 +1003,42 @@ namespace WDBReader::Database {
 			return fmt;
 		}
 
+		/// <summary>
+		/// IDs come from the id list when the file has one, otherwise the inline id column is decoded. Copy table rows follow.
+		/// </summary>
+		std::vector<uint32_t> recordIds() const override {
+			std::vector<uint32_t> ids;
+
+			if (!_structure.idList.empty()) {
+				ids.reserve(size());
+				ids.assign(_structure.idList.begin(), _structure.idList.end());
+			}
+			else {
+				const auto id_field = idFieldIndex(_schema);
+				if (!id_field.has_value()) {
+					return {};
+				}
+
+				ids = decodeColumn<uint32_t>(_schema, *this, id_field.value(), 0, _structure.header.record_count);
+			}
+
+			for (const auto& copy : _structure.copyTable) {
+				ids.push_back(copy.id_of_new_row);
+			}
+
+			return ids;
+		}
+
 		R operator[](uint32_t index) const override {
 			assert(_loader);
 			return (*_loader)[index];
 		}
 
+		std::optional<RecordEncryption> readElement(uint32_t index, size_t field_index, size_t array_index, column_value_t& value) const override {
+			assert(_loader);
+			return _loader->readElement(index, field_index, array_index, value);
+		}
+
 		inline bool hasSecondaryKeys() const {
 			return (_structure.header.flags & DB2HeaderFlags::HasRelationshipData) != 0;
 		}
@@ -800,9 +1047,238 @@ namespace WDBReader::Database {
 			return (_structure.header.flags & DB2HeaderFlags::HasOffsetMap) != 0;
 		}
 
+		/// <summary>
+		/// Pool used by load() and preloadFieldData(), must outlive both calls. Only used when the source supports positionless reads.
+		/// </summary>
+		inline void setThreadPool(ThreadPool* pool) {
+			_pool = pool;
+		}
+
+		/// <summary>
+		/// Reads every fields pallet and common data now, rather than on first access. Spread across the pool when one is usable.
+		/// </summary>
+		void preloadFieldData() {
+			WDBREADER_TRACE_SCOPE("database", "DB2File::preloadFieldData");
+			if (_structure.header.field_storage_info_size == 0) {
+				return;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			auto load_field = [this](size_t field_index) {
+				_structure.loadFieldData(static_cast<uint32_t>(field_index), _file_source.get());
+			};
+
+			bool parallel = false;
+			if constexpr (Filesystem::TPositionlessFileSource<FS>) {
+				parallel = _pool != nullptr;
+			}
+
+			if (parallel) {
+				_pool->parallelFor(_structure.header.total_field_count, load_field);
+			}
+			else {
+				for (uint32_t i = 0; i < _structure.header.total_field_count; i++) {
+					load_field(i);
+				}
+			}
+
+			// the blocks are read together, so the time is only attributed to the pallet phase.
+			_stats[LoadPhase::PALLET_DATA].time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			_stats[LoadPhase::PALLET_DATA].bytes += _structure.header.pallet_data_size;
+			_stats[LoadPhase::COMMON_DATA].bytes += _structure.header.common_data_size;
+		}
+
+		/// <summary>
+		/// Per phase timings of open() and load(), along with the current resident size of each structure member.
+		/// </summary>
+		LoadStats loadStats() const {
+			LoadStats stats = _stats;
+
+			size_t pallet_bytes = 0;
+			size_t common_bytes = 0;
+			if (_structure.header.field_storage_info_size > 0 && _structure.fieldData) {
+				for (uint32_t i = 0; i < _structure.header.total_field_count; ++i) {
+					const auto& data = _structure.fieldData[i];
+					if (!data.loaded) {
+						continue;
+					}
+
+					const auto& storage = _structure.fieldStorage[i];
+					if (storage.compression_type == DB2FieldCompression::BitpackedIndexed ||
+						storage.compression_type == DB2FieldCompression::BitpackedIndexedArray) {
+						pallet_bytes += storage.additional_data_size;
+					}
+
+					common_bytes += unorderedMapResidentBytes(data.common);
+				}
+			}
+
+			stats.resident = {
+				{ "header", sizeof(_structure.header) },
+				{ "sectionHeaders", sizeof(typename F::SectionHeader) * _structure.header.section_count },
+				{ "fieldStructures", sizeof(typename F::FieldStructure) * _structure.header.field_count },
+				{ "fieldStorage", _structure.header.field_storage_info_size > 0 ? sizeof(typename F::FieldStorageInfo) * _structure.header.total_field_count : 0 },
+				{ "palletData", pallet_bytes },
+				{ "commonData", common_bytes },
+				{ "idList", _structure.idList.capacity() * sizeof(db2_record_id_t) },
+				{ "copyTable", _structure.copyTable.capacity() * sizeof(typename F::CopyTableEntry) },
+				{ "offsetMap", _structure.offsetMap.capacity() * sizeof(typename F::OffsetMapEntry) },
+				{ "offsetMapIds", _structure.offsetMapIds.capacity() * sizeof(db2_record_id_t) },
+				{ "relationships", _structure.relationships.capacity() * sizeof(typename F::RelationshipEntry) },
+				{ "relationshipMap", unorderedMapResidentBytes(_structure.relationshipMap) }
+			};
+
+			return stats;
+		}
+
 	protected:
+		/// <summary>
+		/// Reads the id list, copy table, offset map and relationship blocks of every section at once.
+		/// Each block is located up front and read into its final place, phase times are summed across threads.
+		/// Small files are read on the calling thread, where handing the blocks to the pool costs more than it saves.
+		/// </summary>
+		void _loadSectionBlocksParallel() requires Filesystem::TPositionlessFileSource<FS> {
+			WDBREADER_TRACE_SCOPE("database", "DB2File::loadSectionBlocks");
+
+			struct Block {
+				LoadPhase phase;
+				void* dest;
+				uint64_t offset;
+				uint64_t bytes;
+			};
+
+			struct {
+				uint32_t count;
+				uint32_t min_id;
+				uint32_t max_id;
+			} relation_header;
+
+			struct Counts {
+				size_t idList = 0;
+				size_t copyTable = 0;
+				size_t offsetMap = 0;
+				size_t relationships = 0;
+			};
+
+			// the vectors are sized before any destination pointer is taken.
+			Counts totals;
+			std::vector<uint32_t> relation_counts(_structure.header.section_count, 0);
+			for (uint32_t i = 0; i < _structure.header.section_count; i++) {
+				const typename F::SectionHeader& section = _structure.sectionHeaders[i];
+				totals.idList += section.id_list_size / sizeof(uint32_t);
+				totals.copyTable += section.copy_table_count;
+				totals.offsetMap += section.offset_map_id_count;
+
+				if (section.relationship_data_size > 0) {
+					_file_source->readAt(&relation_header, _relationshipOffset(section), sizeof(relation_header));
+					relation_counts[i] = relation_header.count;
+					totals.relationships += relation_header.count;
+				}
+			}
+
+			_structure.idList.resize(totals.idList);
+			_structure.copyTable.resize(totals.copyTable);
+			_structure.offsetMap.resize(totals.offsetMap);
+			_structure.offsetMapIds.resize(totals.offsetMap);
+			_structure.relationships.resize(totals.relationships);
+
+			std::vector<Block> blocks;
+			Counts used;
+			for (uint32_t i = 0; i < _structure.header.section_count; i++) {
+				const typename F::SectionHeader& section = _structure.sectionHeaders[i];
+				uint64_t pos = _sectionBlocksOffset(section);
+
+				auto add_block = [&](LoadPhase phase, void* dest, uint64_t bytes) {
+					if (bytes > 0) {
+						blocks.push_back({ phase, dest, pos, bytes });
+					}
+					pos += bytes;
+				};
+
+				const uint64_t id_list_bytes = section.id_list_size;
+				const uint64_t copy_table_bytes = section.copy_table_count * sizeof(typename F::CopyTableEntry);
+				const uint64_t offset_map_bytes = section.offset_map_id_count * sizeof(typename F::OffsetMapEntry);
+				const uint64_t offset_map_id_bytes = section.offset_map_id_count * sizeof(db2_record_id_t);
+				const uint64_t relationship_bytes = relation_counts[i] * sizeof(typename F::RelationshipEntry);
+
+				add_block(LoadPhase::ID_LIST, _structure.idList.data() + used.idList, id_list_bytes);
+				add_block(LoadPhase::COPY_TABLE, _structure.copyTable.data() + used.copyTable, copy_table_bytes);
+				add_block(LoadPhase::OFFSET_MAP, _structure.offsetMap.data() + used.offsetMap, offset_map_bytes);
+
+				// offset map ids come before the relationships with secondary keys, after them otherwise.
+				const uint64_t relationship_offset = _relationshipOffset(section);
+				if (!hasSecondaryKeys()) {
+					pos = relationship_offset + section.relationship_data_size;
+				}
+				add_block(LoadPhase::OFFSET_MAP, _structure.offsetMapIds.data() + used.offsetMap, offset_map_id_bytes);
+
+				if (relationship_bytes > 0) {
+					blocks.push_back({ LoadPhase::RELATIONSHIPS, _structure.relationships.data() + used.relationships, relationship_offset + sizeof(relation_header), relationship_bytes });
+				}
+				if (section.relationship_data_size > 0) {
+					_stats[LoadPhase::RELATIONSHIPS].bytes += sizeof(relation_header);
+				}
+
+				used.idList += section.id_list_size / sizeof(uint32_t);
+				used.copyTable += section.copy_table_count;
+				used.offsetMap += section.offset_map_id_count;
+				used.relationships += relation_counts[i];
+			}
+
+			constexpr uint64_t min_parallel_bytes = 256 * 1024;
+			uint64_t total_bytes = 0;
+			for (const auto& block : blocks) {
+				total_bytes += block.bytes;
+			}
+
+			std::vector<std::chrono::nanoseconds> times(blocks.size());
+			auto read_block = [&](size_t index) {
+				const auto start = std::chrono::steady_clock::now();
+				_file_source->readAt(blocks[index].dest, blocks[index].offset, blocks[index].bytes);
+				times[index] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			};
+
+			if (total_bytes >= min_parallel_bytes) {
+				_pool->parallelFor(blocks.size(), read_block);
+			}
+			else {
+				for (size_t i = 0; i < blocks.size(); i++) {
+					read_block(i);
+				}
+			}
+
+			for (size_t i = 0; i < blocks.size(); i++) {
+				_stats[blocks[i].phase].time += times[i];
+				_stats[blocks[i].phase].bytes += blocks[i].bytes;
+			}
+		}
+
+		/// <summary>
+		/// Position of the first block after the sections record and string data, matching where the loaders leave the source.
+		/// </summary>
+		inline uint64_t _sectionBlocksOffset(const typename F::SectionHeader& section) const {
+			if (isSparse()) {
+				return section.offset_records_end;
+			}
+
+			return section.file_offset + (uint64_t(section.record_count) * _structure.header.record_size) + section.string_table_size;
+		}
+
+		inline uint64_t _relationshipOffset(const typename F::SectionHeader& section) const {
+			uint64_t pos = _sectionBlocksOffset(section) + section.id_list_size +
+				(section.copy_table_count * sizeof(typename F::CopyTableEntry)) +
+				(section.offset_map_id_count * sizeof(typename F::OffsetMapEntry));
+
+			if (hasSecondaryKeys()) {
+				pos += section.offset_map_id_count * sizeof(db2_record_id_t);
+			}
+
+			return pos;
+		}
+
 		inline void _loadOffsetMapIds(const typename F::SectionHeader& section) {
 			if (section.offset_map_id_count > 0) {
+				auto timer = _stats.time(LoadPhase::OFFSET_MAP, _file_source.get());
 				const auto old_offset_map_ids_size = _structure.offsetMapIds.size();
 				_structure.offsetMapIds.resize(old_offset_map_ids_size + section.offset_map_id_count);
 				_file_source->read(&_structure.offsetMapIds[old_offset_map_ids_size], section.offset_map_id_count * sizeof(db2_record_id_t));
@@ -818,6 +1294,7 @@ namespace WDBReader::Database {
 					uint32_t max_id;
 				} relation_header;
 
+				auto timer = _stats.time(LoadPhase::RELATIONSHIPS, _file_source.get());
 				_file_source->read(&relation_header, sizeof(relation_header));
 
 				if (relation_header.count > 0) {
@@ -832,22 +1309,29 @@ namespace WDBReader::Database {
 		const S _schema;
 		const DB2LoadInfo _load_info;
 		std::unique_ptr<FS> _file_source;
+		mutable SS _strings;
 		DB2Structure<typename F> _structure;
 		std::unique_ptr<DB2Loader<typename F, typename R>> _loader;
+		LoadStats _stats;
+		ThreadPool* _pool = nullptr;
 	};
 	
-	template<TSchema S, TRecord R, Filesystem::TFileSource FS>
-	class DB2File<DB2FileFormatWDB2, S, R, FS> final : public DataSource<R> {
+	template<TSchema S, TRecord R, Filesystem::TFileSource FS, TStringStorage SS>
+	class DB2File<DB2FileFormatWDB2, S, R, FS, SS> final : public DataSource<R> {
 	public:
 
-		DB2File(const S& schema) : _schema(schema), _record_size(DB2FormatWDB2::recordSizeSrc(schema))
+		DB2File(const S& schema, SS strings = SS()) : _schema(schema), _record_size(DB2FormatWDB2::recordSizeSrc(schema)), _strings(std::move(strings))
 		{}
 		virtual ~DB2File() = default;
 
 		void open(std::unique_ptr<FS> source) {
+			WDBREADER_TRACE_SCOPE("database", "DB2File::open", "WDB2");
 			_file_source = std::move(source);
 
-			_file_source->read(&_header, sizeof(_header));
+			{
+				auto timer = _stats.time(LoadPhase::HEADER, _file_source.get());
+				_file_source->read(&_header, sizeof(_header));
+			}
 			std::vector<uint8_t> data;
 			data.resize(sizeof(_header));
 			memcpy(data.data(), &_header, sizeof(_header));
@@ -888,7 +1372,42 @@ namespace WDBReader::Database {
 			return fmt;
 		}
 
+		/// <summary>
+		/// WDB2 IDs are always inline. The id index after the header maps IDs to rows, but uses 0 for missing IDs as well as the first row, so isnt used.
+		/// The ID field is read from each record past the index (directly when it is a leading 32 bit field), or decoded as a column.
+		/// </summary>
+		std::vector<uint32_t> recordIds() const override {
+			const auto id_field = idFieldIndex(_schema);
+			if (!id_field.has_value()) {
+				return {};
+			}
+
+			if (id_field.value() != 0 || _schema.fields()[0].bytes != sizeof(uint32_t)) {
+				return decodeColumn<uint32_t>(_schema, *this, id_field.value());
+			}
+
+			std::vector<uint32_t> ids(_header.record_count);
+			for (uint32_t i = 0; i < _header.record_count; i++) {
+				_file_source->setPos(sizeof(_header) + _data_offset + (uint64_t(_header.record_size) * i));
+				_file_source->read(&ids[i], sizeof(uint32_t));
+			}
+			return ids;
+		}
+
+		/// <summary>
+		/// WDB2 records and strings are read on demand, so only the header phase is populated.
+		/// </summary>
+		LoadStats loadStats() const {
+			LoadStats stats = _stats;
+			stats.resident = {
+				{ "header", sizeof(_header) },
+				{ "recordBuffer", _record_buffer.capacity() }
+			};
+			return stats;
+		}
+
 		R operator[](uint32_t index) const override {
+			WDBREADER_TRACE_RECORD_SCOPE("record", "DB2File::operator[]", std::to_string(index));
 
 			uint64_t offset = sizeof(_header) + +_data_offset + (_header.record_size * index);
 			_file_source->setPos(offset);
@@ -920,7 +1439,7 @@ namespace WDBReader::Database {
 								schema_field_index,
 								z,
 								view_offset,
-								std::move(readCurrentString(_file_source.get()))
+								std::move(readCurrentString(_file_source.get(), _strings))
 							);
 
 
@@ -947,20 +1466,65 @@ namespace WDBReader::Database {
 			return record;
 		}
 
+		/// <summary>
+		/// Records have a fixed layout, so only the elements bytes (and its string) are read.
+		/// </summary>
+		std::optional<RecordEncryption> readElement(uint32_t index, size_t field_index, size_t array_index, column_value_t& value) const override {
+			const auto& fields = _schema.fields();
+			if (field_index >= fields.size() || array_index >= fields[field_index].size) {
+				throw WDBReaderException("Field element out of range.");
+			}
+
+			auto element_bytes = [](const Field& field) -> size_t {
+				return field.type == Field::Type::STRING || field.type == Field::Type::LANG_STRING ? sizeof(string_ref_t) : field.bytes;
+			};
+
+			uint64_t element_offset = 0;
+			for (size_t i = 0; i < field_index; i++) {
+				element_offset += element_bytes(fields[i]) * fields[i].size;
+			}
+			element_offset += element_bytes(fields[field_index]) * array_index;
+
+			_file_source->setPos(sizeof(_header) + _data_offset + (uint64_t(_header.record_size) * index) + element_offset);
+
+			schemaFieldHandler(fields[field_index], [&]<typename T>() {
+				if constexpr (std::is_same_v<string_data_t, T>) {
+					string_ref_t string_ref = 0;
+					_file_source->read(&string_ref, sizeof(string_ref));
+					_file_source->setPos(sizeof(_header) + _data_offset + (_header.record_size * _header.record_count) + string_ref);
+					value = readCurrentStringValue(_file_source.get());
+				}
+				else {
+					T element = 0;
+					_file_source->read(&element, sizeof(T));
+					if constexpr (std::is_floating_point_v<T>) {
+						value = element;
+					}
+					else {
+						value = uint64_t(element);
+					}
+				}
+			});
+
+			return RecordEncryption::NONE;
+		}
+
 	protected:
 		const S _schema;
 		const size_t _record_size;
 
 		std::unique_ptr<FS> _file_source;
+		mutable SS _strings;
 		DB2FileFormatWDB2::Header _header;
 		ptrdiff_t _data_offset;
+		LoadStats _stats;
 
 		mutable std::vector<uint8_t> _record_buffer;
 
 	};
 
-	template<TSchema S, TRecord R, Filesystem::TFileSource FS, TDB2Format... F>
-	std::unique_ptr<DataSource<R>> makeDB2FileFormat(const S& schema, std::unique_ptr<FS> source) {
+	template<TSchema S, TRecord R, Filesystem::TFileSource FS, TDB2Format... F, TStringStorage SS = HeapStringStorage>
+	std::unique_ptr<DataSource<R>> makeDB2FileFormat(const S& schema, std::unique_ptr<FS> source, SS strings = SS(), ThreadPool* pool = nullptr) {
 		Signature sig;
 		source->read(&sig.integer, sizeof(sig.integer));
 		source->setPos(0);
@@ -970,7 +1534,10 @@ namespace WDBReader::Database {
 		auto try_format = [&]<TDB2Format Fmt>() -> int {
 			if (result == nullptr) {
 				if (Fmt::signature.integer == sig.integer) {
-					auto res = std::make_unique<DB2File<Fmt, S, R, FS>>(schema);
+					auto res = std::make_unique<DB2File<Fmt, S, R, FS, SS>>(schema, std::move(strings));
+					if constexpr (TDB2FormatModern<Fmt>) {
+						res->setThreadPool(pool);
+					}
 					res->open(std::move(source));
 					res->load();
 					result = std::move(res);
@@ -986,21 +1553,21 @@ namespace WDBReader::Database {
 		return result;
 	}
 
-	template<TSchema S, TRecord R, Filesystem::TFileSource FS>
-	std::unique_ptr<DataSource<R>> makeDB2File(const S& schema, std::unique_ptr<FS> source) {
+	template<TSchema S, TRecord R, Filesystem::TFileSource FS, TStringStorage SS = HeapStringStorage>
+	std::unique_ptr<DataSource<R>> makeDB2File(const S& schema, std::unique_ptr<FS> source, SS strings = SS(), ThreadPool* pool = nullptr) {
 		return makeDB2FileFormat<S, R, FS,DB2FileFormatWDC5, DB2FileFormatWDC4, DB2FileFormatWDC3, DB2FileFormatWDB2>
-			(schema, std::move(source)
+			(schema, std::move(source), std::move(strings), pool
 		);
 	};
 
-	template<Filesystem::TFileSource FS>
-	auto makeDB2File(const RuntimeSchema& schema, std::unique_ptr<FS> source) {
-		return makeDB2File<RuntimeSchema, RuntimeRecord, FS>(schema, std::move(source));
+	template<Filesystem::TFileSource FS, TStringStorage SS = HeapStringStorage>
+	auto makeDB2File(const RuntimeSchema& schema, std::unique_ptr<FS> source, SS strings = SS(), ThreadPool* pool = nullptr) {
+		return makeDB2File<RuntimeSchema, RuntimeRecord, FS, SS>(schema, std::move(source), std::move(strings), pool);
 	}
 	
-	template<TRecord R, Filesystem::TFileSource FS>
-	auto makeDB2File(std::unique_ptr<FS> source) {
-		return makeDB2File<decltype(R::schema), R, FS>(R::schema, std::move(source));
+	template<TRecord R, Filesystem::TFileSource FS, TStringStorage SS = HeapStringStorage>
+	auto makeDB2File(std::unique_ptr<FS> source, SS strings = SS(), ThreadPool* pool = nullptr) {
+		return makeDB2File<decltype(R::schema), R, FS, SS>(R::schema, std::move(source), std::move(strings), pool);
 	}
 
 
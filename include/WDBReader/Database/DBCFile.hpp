@@ -3,6 +3,7 @@
 #include "../Database.hpp"
 #include "../Utility.hpp"
 #include "Formats.hpp"
+#include "LoadStats.hpp"
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -219,19 +220,19 @@ namespace WDBReader::Database {
 
 #pragma pack(pop)
 
-	template<TSchema S, TRecord R, Filesystem::TFileSource FS, bool LegacyLangStrings = std::is_standard_layout_v<decltype(R::data)>>
+	template<TSchema S, TRecord R, Filesystem::TFileSource FS, bool LegacyLangStrings = std::is_standard_layout_v<decltype(R::data)>, TStringStorage SS = HeapStringStorage>
 	requires (LegacyLangStrings == false || (LegacyLangStrings == true && std::is_standard_layout_v<decltype(R::data)>))
 	class DBCFile final : public DataSource<R> {
 	public:
 
 		template<typename = typename std::enable_if_t<LegacyLangStrings>>
-		DBCFile(const S& schema, DBCVersion version) :
-			_schema(schema), _version(version), _locale(DBCStringLocale::ANY), _record_size(DBCFormat::recordSizeSrc(schema, version))
+		DBCFile(const S& schema, DBCVersion version, SS strings = SS()) :
+			_schema(schema), _version(version), _locale(DBCStringLocale::ANY), _record_size(DBCFormat::recordSizeSrc(schema, version)), _strings(std::move(strings))
 		{}
 
 		template<typename = typename std::enable_if_t<!LegacyLangStrings>>
-		DBCFile(const S& schema, DBCVersion version, DBCStringLocale locale = DBCStringLocale::ANY) :
-			_schema(schema), _version(version), _locale(locale), _record_size(DBCFormat::recordSizeSrc(schema, version))
+		DBCFile(const S& schema, DBCVersion version, DBCStringLocale locale = DBCStringLocale::ANY, SS strings = SS()) :
+			_schema(schema), _version(version), _locale(locale), _record_size(DBCFormat::recordSizeSrc(schema, version)), _strings(std::move(strings))
 		{
 
 			if (version == DBCVersion::VANILLA) {
@@ -255,9 +256,13 @@ namespace WDBReader::Database {
         virtual ~DBCFile() = default;
 		
 		void open(std::unique_ptr<FS> source) {
+			WDBREADER_TRACE_SCOPE("database", "DBCFile::open");
 			_file_source = std::move(source);
 			
-			_file_source->read(&_header, sizeof(_header));
+			{
+				auto timer = _stats.time(LoadPhase::HEADER, _file_source.get());
+				_file_source->read(&_header, sizeof(_header));
+			}
 			std::vector<uint8_t> data;
 			data.resize(sizeof(_header));
 			memcpy(data.data(), &_header, sizeof(_header));
@@ -289,7 +294,42 @@ namespace WDBReader::Database {
 			return DBFormat{ WDBC_MAGIC };
 		}
 
+		/// <summary>
+		/// WDBC keeps no ids outside the records, so the ID field of each fixed size record is read.
+		/// A leading 32 bit ID is read at each record offset without decoding, any other ID field is decoded as a column.
+		/// </summary>
+		std::vector<uint32_t> recordIds() const override {
+			const auto id_field = idFieldIndex(_schema);
+			if (!id_field.has_value()) {
+				return {};
+			}
+
+			if (id_field.value() != 0 || _schema.fields()[0].bytes != sizeof(uint32_t)) {
+				return decodeColumn<uint32_t>(_schema, *this, id_field.value());
+			}
+
+			std::vector<uint32_t> ids(_header.recordCount);
+			for (uint32_t i = 0; i < _header.recordCount; i++) {
+				_file_source->setPos(sizeof(DBCHeader) + (uint64_t(_header.recordSize) * i));
+				_file_source->read(&ids[i], sizeof(uint32_t));
+			}
+			return ids;
+		}
+
+		/// <summary>
+		/// DBC records and strings are read on demand, so only the header phase is populated.
+		/// </summary>
+		LoadStats loadStats() const {
+			LoadStats stats = _stats;
+			stats.resident = {
+				{ "header", sizeof(_header) },
+				{ "recordBuffer", _record_buffer.capacity() }
+			};
+			return stats;
+		}
+
 		R operator[](uint32_t index) const override {
+			WDBREADER_TRACE_RECORD_SCOPE("record", "DBCFile::operator[]", std::to_string(index));
 
 			uint64_t offset = sizeof(_header) + (_header.recordSize * index);
 			_file_source->setPos(offset);
@@ -324,7 +364,7 @@ namespace WDBReader::Database {
 									schema_field_index,
 									z,
 									view_offset,
-									std::move(readCurrentString(_file_source.get()))
+									std::move(readCurrentString(_file_source.get(), _strings))
 								);
 
 
@@ -350,7 +390,7 @@ namespace WDBReader::Database {
 											schema_field_index,
 											array_block + idx,
 											view_offset,
-											std::move(readCurrentString(_file_source.get()))
+											std::move(readCurrentString(_file_source.get(), _strings))
 										);
 										
 
@@ -378,7 +418,7 @@ namespace WDBReader::Database {
 										schema_field_index,
 										z,
 										view_offset,
-										std::move(readCurrentString(_file_source.get()))
+										std::move(readCurrentString(_file_source.get(), _strings))
 									);
 
 									buffer_offset += strings_view_size;
@@ -408,26 +448,85 @@ namespace WDBReader::Database {
 			return record;
 		}
 
+		/// <summary>
+		/// Records have a fixed layout, so only the elements bytes (and its string) are read. Legacy lang strings are decoded with the whole record.
+		/// </summary>
+		std::optional<RecordEncryption> readElement(uint32_t index, size_t field_index, size_t array_index, column_value_t& value) const override {
+			const auto& fields = _schema.fields();
+			if (field_index >= fields.size() || array_index >= fields[field_index].size) {
+				throw WDBReaderException("Field element out of range.");
+			}
+
+			const Field& field = fields[field_index];
+			const bool lang_string_refs = field.type == Field::Type::LANG_STRING && _version != DBCVersion::CATA_PLUS;
+			if (LegacyLangStrings && lang_string_refs) {
+				return std::nullopt;
+			}
+
+			const size_t strings_size = (size_t)(_version == DBCVersion::VANILLA ? DBCStringLocale::VANILLA_SIZE : DBCStringLocale::BC_WOTLK_SIZE);
+			auto element_bytes = [&](const Field& element_field) -> size_t {
+				if (element_field.type == Field::Type::LANG_STRING) {
+					return _version == DBCVersion::CATA_PLUS ? sizeof(string_ref_t) : (strings_size * sizeof(lang_string_ref_t)) + sizeof(uint32_t);
+				}
+				return element_field.type == Field::Type::STRING ? sizeof(string_ref_t) : element_field.bytes;
+			};
+
+			uint64_t element_offset = 0;
+			for (size_t i = 0; i < field_index; i++) {
+				element_offset += element_bytes(fields[i]) * fields[i].size;
+			}
+			element_offset += element_bytes(field) * array_index;
+
+			if (lang_string_refs) {
+				element_offset += sizeof(lang_string_ref_t) * (uint32_t)_locale;
+			}
+
+			_file_source->setPos(sizeof(DBCHeader) + (uint64_t(_header.recordSize) * index) + element_offset);
+
+			schemaFieldHandler(field, [&]<typename T>() {
+				if constexpr (std::is_same_v<string_data_t, T>) {
+					string_ref_t string_ref = 0;
+					_file_source->read(&string_ref, sizeof(string_ref));
+					_file_source->setPos(sizeof(DBCHeader) + (_header.recordSize * _header.recordCount) + string_ref);
+					value = readCurrentStringValue(_file_source.get());
+				}
+				else {
+					T element = 0;
+					_file_source->read(&element, sizeof(T));
+					if constexpr (std::is_floating_point_v<T>) {
+						value = element;
+					}
+					else {
+						value = uint64_t(element);
+					}
+				}
+			});
+
+			return RecordEncryption::NONE;
+		}
+
 	protected:
 		const S _schema;
 		const size_t _record_size;
 		const DBCVersion _version;
 		const DBCStringLocale _locale;
 		std::unique_ptr<FS> _file_source;
+		mutable SS _strings;
 		DBCHeader _header;
+		LoadStats _stats;
 
 		mutable std::vector<uint8_t> _record_buffer;
 	};
 
 
-	template<Filesystem::TFileSource FS>
-	auto makeDBCFile(const RuntimeSchema& schema, DBCVersion version, DBCStringLocale locale) {
-		return DBCFile<RuntimeSchema, RuntimeRecord, FS, false>(schema, version, locale);
+	template<Filesystem::TFileSource FS, TStringStorage SS = HeapStringStorage>
+	auto makeDBCFile(const RuntimeSchema& schema, DBCVersion version, DBCStringLocale locale, SS strings = SS()) {
+		return DBCFile<RuntimeSchema, RuntimeRecord, FS, false, SS>(schema, version, locale, std::move(strings));
 	}
 
-	template<TRecord R, Filesystem::TFileSource FS>
-	auto makeDBCFile(DBCVersion version) {
-		return DBCFile<decltype(R::schema), R, FS, true>(R::schema, version);
+	template<TRecord R, Filesystem::TFileSource FS, TStringStorage SS = HeapStringStorage>
+	auto makeDBCFile(DBCVersion version, SS strings = SS()) {
+		return DBCFile<decltype(R::schema), R, FS, true, SS>(R::schema, version, std::move(strings));
 	}
 
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../Database.hpp"
+#include "../Filesystem.hpp"
+#include "../ThreadPool.hpp"
+#include "../Trace.hpp"
+#include "../WoWDBDefs.hpp"
+#include "DB2File.hpp"
+#include "DBCFile.hpp"
+#include "Probe.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace WDBReader::Database {
+
+	/// <summary>
+	/// Opens and loads a dbc or db2 file (detected by signature) with a runtime schema.
+	/// The build picks the dbc layout, the locale is only used for pre cata dbc files.
+	/// </summary>
+	template<Filesystem::TFileSource FS>
+	std::unique_ptr<DataSource<RuntimeRecord>> makeDBFile(const RuntimeSchema& schema, std::unique_ptr<FS> source, const GameVersion& build,
+		DBCStringLocale locale = DBCStringLocale::enUS, ThreadPool* pool = nullptr)
+	{
+		Signature sig;
+		source->read(&sig.integer, sizeof(sig.integer));
+		source->setPos(0);
+
+		if (sig.integer == WDBC_MAGIC.integer) {
+			const auto version = getDBCVersion(build);
+			auto dbc = std::make_unique<DBCFile<RuntimeSchema, RuntimeRecord, FS, false>>(schema, version, version == DBCVersion::CATA_PLUS ? DBCStringLocale::ANY : locale);
+			dbc->open(std::move(source));
+			dbc->load();
+			return dbc;
+		}
+
+		auto db2 = makeDB2File<RuntimeSchema, RuntimeRecord, FS>(schema, std::move(source), HeapStringStorage(), pool);
+		if (db2 == nullptr) {
+			throw WDBReaderException("Unknown file format.");
+		}
+		return db2;
+	}
+
+	/// <summary>
+	/// A table opened with a schema chosen from its definition.
+	/// </summary>
+	struct DefinedTable {
+	public:
+		std::string name;
+		std::shared_ptr<const RuntimeSchema> schema;
+		std::unique_ptr<DataSource<RuntimeRecord>> source;
+	};
+
+	/// <summary>
+	/// Opens a WDC3+ file with the schema matching the layout hash in its header, the table is found from the layout alone.
+	/// </summary>
+	template<typename FSys, Filesystem::TFileUri FU>
+	DefinedTable openWithDefinitions(FSys& filesystem, const FU& uri, const WoWDBDefs::DefinitionRegistry& registry, ThreadPool* pool = nullptr) {
+		WDBREADER_TRACE_SCOPE("database", "openWithDefinitions");
+
+		auto source = filesystem.open(uri);
+		if (source == nullptr) {
+			throw WDBReaderException("Unable to open file.");
+		}
+
+		const auto probe = probeDBFile(*source);
+		if (!probe.has_value()) {
+			throw WDBReaderException("Unknown file format.");
+		}
+
+		if (!probe->layoutHash.has_value()) {
+			throw WDBReaderException("File has no layout hash.");
+		}
+
+		const auto name = registry.tableForLayout(*probe->layoutHash);
+		if (!name.has_value()) {
+			throw WDBReaderException("No definition for layout.");
+		}
+
+		auto schema = registry.schemaForLayout(*probe->layoutHash);
+		auto db = makeDB2File<RuntimeSchema, RuntimeRecord>(*schema, std::move(source), HeapStringStorage(), pool);
+		return DefinedTable{ std::string(*name), std::move(schema), std::move(db) };
+	}
+
+	/// <summary>
+	/// Opens a known table, using the layout hash in the header when the format has one and the definition lists it,
+	/// otherwise the definition for the build. Works for every format, including dbc files.
+	/// </summary>
+	template<typename FSys, Filesystem::TFileUri FU>
+	DefinedTable openWithDefinitions(FSys& filesystem, const FU& uri, const WoWDBDefs::DefinitionRegistry& registry,
+		std::string_view name, const GameVersion& build, ThreadPool* pool = nullptr)
+	{
+		WDBREADER_TRACE_SCOPE("database", "openWithDefinitions", std::string(name));
+
+		auto source = filesystem.open(uri);
+		if (source == nullptr) {
+			throw WDBReaderException("Unable to open file.");
+		}
+
+		const auto probe = probeDBFile(*source);
+		if (!probe.has_value()) {
+			throw WDBReaderException("Unknown file format.");
+		}
+
+		std::shared_ptr<const RuntimeSchema> schema = nullptr;
+		if (probe->layoutHash.has_value()) {
+			schema = registry.schemaForLayout(name, *probe->layoutHash);
+		}
+
+		if (schema == nullptr) {
+			schema = registry.schema(name, build);
+		}
+
+		if (schema == nullptr) {
+			throw WDBReaderException("No definition for table.");
+		}
+
+		auto db = makeDBFile(*schema, std::move(source), build, DBCStringLocale::enUS, pool);
+		return DefinedTable{ std::string(name), std::move(schema), std::move(db) };
+	}
+}
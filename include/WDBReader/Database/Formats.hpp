@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Schema.hpp"
+#include "StringStorage.hpp"
 #include "../Filesystem.hpp"
 #include <array>
 #include <cstdint>
@@ -52,10 +53,10 @@ namespace WDBReader::Database {
 
 
 	/// <summary>
-	/// Reads the current C string from the file source.
+	/// Reads the current C string from the file source, without passing it through a string storage.
 	/// </summary>
 	template<WDBReader::Filesystem::TFileSource FS>
-	string_data_t readCurrentString(FS* _source) 
+	std::string readCurrentStringValue(FS* _source)
 	{
 		std::string buffer;
 		std::array<char, 32> intermediate;
@@ -84,12 +85,26 @@ namespace WDBReader::Database {
 			buffer.append(intermediate.data(), append_pos);
 		}
 
-		if (!end_of_string) {
-			buffer.push_back('\0');
+		if (end_of_string) {
+			buffer.pop_back();
 		}
 
-		auto result = std::make_unique_for_overwrite<string_data_t::element_type[]>(buffer.size());
-		memmove(result.get(), buffer.data(), buffer.size());
-		return result;
+		return buffer;
+	}
+
+	/// <summary>
+	/// Reads the current C string from the file source.
+	/// </summary>
+	template<WDBReader::Filesystem::TFileSource FS, TStringStorage SS>
+	string_data_t readCurrentString(FS* _source, SS& storage) 
+	{
+		return storage.store(readCurrentStringValue(_source));
+	}
+
+	template<WDBReader::Filesystem::TFileSource FS>
+	string_data_t readCurrentString(FS* _source)
+	{
+		HeapStringStorage storage;
+		return readCurrentString(_source, storage);
 	}
 }
\ No newline at end of file
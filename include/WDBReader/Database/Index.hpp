@@ -0,0 +1,572 @@
+#pragma once
+
+#include "../Database.hpp"
+#include "../Filesystem.hpp"
+#include "RadixSort.hpp"
+#include "Snapshot.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <numeric>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	/*
+		Index files store a secondary index over a single field element, written alongside the tables snapshot.
+		Layout:
+			IndexFileHeader
+			keys[key_count], ascending. Numeric keys are fixed width, strings are [uint32_t length][bytes].
+			uint32_t offsets[key_count + 1], into the record indexes.
+			uint32_t record_indexes[entry_count], grouped by key and ascending within each key.
+	*/
+
+	constexpr Signature INDEX_MAGIC = "WDBI";
+	constexpr uint32_t INDEX_VERSION = 1;
+
+	enum class IndexKeyType : uint8_t {
+		UINT32,
+		INT32,
+		UINT64,
+		INT64,
+		FLOAT,
+		STRING
+	};
+
+	template<typename K>
+	inline constexpr IndexKeyType indexKeyType() {
+		if constexpr (std::is_same_v<K, uint32_t>) {
+			return IndexKeyType::UINT32;
+		}
+		else if constexpr (std::is_same_v<K, int32_t>) {
+			return IndexKeyType::INT32;
+		}
+		else if constexpr (std::is_same_v<K, uint64_t>) {
+			return IndexKeyType::UINT64;
+		}
+		else if constexpr (std::is_same_v<K, int64_t>) {
+			return IndexKeyType::INT64;
+		}
+		else if constexpr (std::is_same_v<K, float>) {
+			return IndexKeyType::FLOAT;
+		}
+		else {
+			static_assert(std::is_same_v<K, std::string>, "Unsupported index key type.");
+			return IndexKeyType::STRING;
+		}
+	}
+
+#pragma pack(push, 1)
+
+	struct IndexFileHeader {
+		uint32_t signature;
+		uint32_t version;
+		uint32_t table_hash;
+		uint32_t layout_hash;
+		uint16_t build_expansion;
+		uint16_t build_major;
+		uint16_t build_minor;
+		uint8_t key_type;
+		uint8_t padding;
+		uint32_t build_number;
+		uint32_t field_index;
+		uint32_t array_index;
+		uint32_t record_count;
+		uint32_t key_count;
+		uint32_t entry_count;
+	};
+
+#pragma pack(pop)
+
+	/// <summary>
+	/// Record indexes grouped by unique key, with keys ascending. The storage shared by both index kinds.
+	/// </summary>
+	template<typename K>
+	struct IndexPostings {
+	public:
+		std::vector<K> keys;
+		std::vector<uint32_t> offsets;			// key_count + 1 entries.
+		std::vector<uint32_t> recordIndexes;
+		uint32_t fieldIndex = 0;
+		uint32_t arrayIndex = 0;
+		uint32_t recordCount = 0;				// size of the source the index was built from.
+
+		inline std::span<const uint32_t> at(size_t key_position) const {
+			return std::span<const uint32_t>(recordIndexes).subspan(offsets[key_position], offsets[key_position + 1] - offsets[key_position]);
+		}
+	};
+
+	namespace IndexDetail {
+
+		struct IdentityKey {
+			template<typename K>
+			inline K operator()(K value) const {
+				return value;
+			}
+		};
+
+		template<typename K, TSchema S, TRecord R, typename Transform = IdentityKey>
+		IndexPostings<K> build(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index, Transform transform = Transform()) {
+			WDBREADER_TRACE_SCOPE("database", "buildIndex");
+
+			std::vector<K> values;
+			std::vector<uint32_t> record_indexes;
+			values.reserve(source.size());
+			record_indexes.reserve(source.size());
+
+			forEachColumnValue<K>(schema, source, field_index, array_index, source.size(), [&](uint32_t record_index, K value) {
+				values.push_back(transform(std::move(value)));
+				record_indexes.push_back(record_index);
+			});
+
+			std::vector<uint32_t> order;
+			if constexpr (std::is_same_v<K, std::string>) {
+				order.resize(values.size());
+				std::iota(order.begin(), order.end(), 0);
+				std::stable_sort(order.begin(), order.end(), [&values](uint32_t a, uint32_t b) {
+					return values[a] < values[b];
+				});
+			}
+			else {
+				std::vector<decltype(radixKey(K()))> keys(values.size());
+				std::transform(values.begin(), values.end(), keys.begin(), [](K value) { return radixKey(value); });
+				order = radixSortPermutation(std::move(keys));
+			}
+
+			IndexPostings<K> postings;
+			postings.fieldIndex = static_cast<uint32_t>(field_index);
+			postings.arrayIndex = static_cast<uint32_t>(array_index);
+			postings.recordCount = static_cast<uint32_t>(source.size());
+			postings.recordIndexes.reserve(order.size());
+
+			for (const auto position : order) {
+				if (postings.keys.empty() || !(postings.keys.back() == values[position])) {
+					postings.keys.push_back(std::move(values[position]));
+					postings.offsets.push_back(static_cast<uint32_t>(postings.recordIndexes.size()));
+				}
+				postings.recordIndexes.push_back(record_indexes[position]);
+			}
+			postings.offsets.push_back(static_cast<uint32_t>(postings.recordIndexes.size()));
+
+			return postings;
+		}
+
+		template<typename K>
+		void write(std::ostream& stream, const IndexPostings<K>& postings, const SnapshotKey& key) {
+			auto write = [&stream](const void* data, size_t bytes) {
+				stream.write(reinterpret_cast<const char*>(data), bytes);
+			};
+
+			IndexFileHeader header{};
+			header.signature = INDEX_MAGIC.integer;
+			header.version = INDEX_VERSION;
+			header.table_hash = key.tableHash;
+			header.layout_hash = key.layoutHash;
+			header.build_expansion = key.build.expansion;
+			header.build_major = key.build.major;
+			header.build_minor = key.build.minor;
+			header.build_number = key.build.build;
+			header.key_type = static_cast<uint8_t>(indexKeyType<K>());
+			header.field_index = postings.fieldIndex;
+			header.array_index = postings.arrayIndex;
+			header.record_count = postings.recordCount;
+			header.key_count = static_cast<uint32_t>(postings.keys.size());
+			header.entry_count = static_cast<uint32_t>(postings.recordIndexes.size());
+			write(&header, sizeof(header));
+
+			if constexpr (std::is_same_v<K, std::string>) {
+				for (const auto& str : postings.keys) {
+					const auto length = static_cast<uint32_t>(str.size());
+					write(&length, sizeof(length));
+					write(str.data(), str.size());
+				}
+			}
+			else {
+				write(postings.keys.data(), postings.keys.size() * sizeof(K));
+			}
+
+			write(postings.offsets.data(), postings.offsets.size() * sizeof(uint32_t));
+			write(postings.recordIndexes.data(), postings.recordIndexes.size() * sizeof(uint32_t));
+
+			if (!stream) {
+				throw WDBReaderException("Error writing index.");
+			}
+		}
+
+		template<Filesystem::TFileSource FS>
+		IndexFileHeader readHeader(FS* source) {
+			IndexFileHeader header;
+			if (source->size() < sizeof(header)) {
+				throw WDBReaderException("File too small for header.");
+			}
+
+			source->setPos(0);
+			source->read(&header, sizeof(header));
+
+			if (header.signature != INDEX_MAGIC.integer) {
+				throw WDBReaderException("Header signature doesnt match.");
+			}
+
+			if (header.version != INDEX_VERSION) {
+				throw WDBReaderException("Unsupported index version.");
+			}
+
+			return header;
+		}
+
+		template<typename K, Filesystem::TFileSource FS>
+		IndexPostings<K> read(FS* source) {
+			const auto header = readHeader(source);
+			if (header.key_type != static_cast<uint8_t>(indexKeyType<K>())) {
+				throw WDBReaderException("Index key type doesnt match.");
+			}
+
+			const uint64_t min_key_size = std::is_same_v<K, std::string> ? sizeof(uint32_t) : sizeof(K);
+			const uint64_t min_size = (uint64_t(header.key_count) * min_key_size) + ((uint64_t(header.key_count) + 1 + header.entry_count) * sizeof(uint32_t));
+			if (min_size > source->size() - source->getPos()) {
+				throw WDBReaderException("Index file too small for its counts.");
+			}
+
+			IndexPostings<K> postings;
+			postings.fieldIndex = header.field_index;
+			postings.arrayIndex = header.array_index;
+			postings.recordCount = header.record_count;
+
+			postings.keys.resize(header.key_count);
+			if constexpr (std::is_same_v<K, std::string>) {
+				for (auto& str : postings.keys) {
+					uint32_t length;
+					source->read(&length, sizeof(length));
+					if (length > source->size() - source->getPos()) {
+						throw WDBReaderException("Invalid index key length.");
+					}
+					str.resize(length);
+					source->read(str.data(), length);
+				}
+			}
+			else {
+				source->read(postings.keys.data(), postings.keys.size() * sizeof(K));
+			}
+
+			postings.offsets.resize(header.key_count + 1);
+			source->read(postings.offsets.data(), postings.offsets.size() * sizeof(uint32_t));
+			postings.recordIndexes.resize(header.entry_count);
+			source->read(postings.recordIndexes.data(), postings.recordIndexes.size() * sizeof(uint32_t));
+
+			const bool valid_offsets = postings.offsets.front() == 0 &&
+				postings.offsets.back() == header.entry_count &&
+				std::is_sorted(postings.offsets.begin(), postings.offsets.end());
+			const bool valid_indexes = std::all_of(postings.recordIndexes.begin(), postings.recordIndexes.end(), [&header](uint32_t index) {
+				return index < header.record_count;
+			});
+
+			if (!valid_offsets || !valid_indexes) {
+				throw WDBReaderException("Invalid index data.");
+			}
+
+			return postings;
+		}
+	}
+
+	/// <summary>
+	/// Sorted index over a field element, supporting exact and range lookups by binary search.
+	/// </summary>
+	template<typename K>
+	class SortedIndex final {
+	public:
+		SortedIndex(IndexPostings<K> postings) : _postings(std::move(postings)) {}
+
+		/// <summary>
+		/// Record indexes with the key, ascending. Empty when the key isnt present.
+		/// </summary>
+		std::span<const uint32_t> find(const K& key) const {
+			const auto found = std::lower_bound(_postings.keys.begin(), _postings.keys.end(), key);
+			if (found == _postings.keys.end() || !(*found == key)) {
+				return {};
+			}
+			return _postings.at(std::distance(_postings.keys.begin(), found));
+		}
+
+		/// <summary>
+		/// Record indexes with keys in [min, max], in key order.
+		/// </summary>
+		std::vector<uint32_t> range(const K& min, const K& max) const {
+			const auto first = std::lower_bound(_postings.keys.begin(), _postings.keys.end(), min);
+			const auto last = std::upper_bound(first, _postings.keys.end(), max);
+			const auto begin_offset = _postings.offsets[std::distance(_postings.keys.begin(), first)];
+			const auto end_offset = _postings.offsets[std::distance(_postings.keys.begin(), last)];
+			return std::vector<uint32_t>(_postings.recordIndexes.begin() + begin_offset, _postings.recordIndexes.begin() + end_offset);
+		}
+
+		inline size_t keyCount() const {
+			return _postings.keys.size();
+		}
+
+		inline const IndexPostings<K>& postings() const {
+			return _postings;
+		}
+
+		void write(std::ostream& stream, const SnapshotKey& key) const {
+			IndexDetail::write(stream, _postings, key);
+		}
+
+		template<Filesystem::TFileSource FS>
+		static SortedIndex read(FS* source) {
+			return SortedIndex(IndexDetail::read<K>(source));
+		}
+
+	private:
+		IndexPostings<K> _postings;
+	};
+
+	/// <summary>
+	/// Hash index over a field element, for exact lookups.
+	/// </summary>
+	template<typename K>
+	class HashIndex final {
+	public:
+		HashIndex(IndexPostings<K> postings) : _postings(std::move(postings)) {
+			_positions.reserve(_postings.keys.size());
+			for (uint32_t i = 0; i < _postings.keys.size(); i++) {
+				_positions.emplace(_postings.keys[i], i);
+			}
+		}
+
+		/// <summary>
+		/// Record indexes with the key, ascending. Empty when the key isnt present.
+		/// </summary>
+		std::span<const uint32_t> find(const K& key) const {
+			const auto found = _positions.find(key);
+			if (found == _positions.end()) {
+				return {};
+			}
+			return _postings.at(found->second);
+		}
+
+		inline size_t keyCount() const {
+			return _postings.keys.size();
+		}
+
+		inline const IndexPostings<K>& postings() const {
+			return _postings;
+		}
+
+		void write(std::ostream& stream, const SnapshotKey& key) const {
+			IndexDetail::write(stream, _postings, key);
+		}
+
+		template<Filesystem::TFileSource FS>
+		static HashIndex read(FS* source) {
+			return HashIndex(IndexDetail::read<K>(source));
+		}
+
+	private:
+		IndexPostings<K> _postings;
+		std::unordered_map<K, uint32_t> _positions;
+	};
+
+	/// <summary>
+	/// Prefix and substring search over a string column, case insensitive (ASCII only, other bytes compare as is).
+	/// Unique lowered strings are kept sorted for prefix queries, with a trigram inverted index to narrow substring queries.
+	/// </summary>
+	class StringSearchIndex final {
+	public:
+		StringSearchIndex(IndexPostings<std::string> postings) : _postings(std::move(postings)) {
+			std::vector<uint32_t> trigrams;
+			std::vector<uint32_t> positions;
+
+			for (uint32_t i = 0; i < _postings.keys.size(); i++) {
+				const auto& str = _postings.keys[i];
+				std::vector<uint32_t> seen;
+				for (size_t x = 0; x + 3 <= str.size(); x++) {
+					seen.push_back(trigram(str, x));
+				}
+
+				std::sort(seen.begin(), seen.end());
+				seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+				trigrams.insert(trigrams.end(), seen.begin(), seen.end());
+				positions.insert(positions.end(), seen.size(), i);
+			}
+
+			// stable, so string positions stay ascending within each trigram.
+			const auto order = radixSortPermutation(trigrams);
+			_trigram_positions.reserve(order.size());
+			for (const auto index : order) {
+				if (_trigram_keys.empty() || _trigram_keys.back() != trigrams[index]) {
+					_trigram_keys.push_back(trigrams[index]);
+					_trigram_offsets.push_back(static_cast<uint32_t>(_trigram_positions.size()));
+				}
+				_trigram_positions.push_back(positions[index]);
+			}
+			_trigram_offsets.push_back(static_cast<uint32_t>(_trigram_positions.size()));
+		}
+
+		/// <summary>
+		/// Record indexes whose string starts with the query, ascending.
+		/// </summary>
+		std::vector<uint32_t> prefix(std::string_view query) const {
+			const auto lowered = lower(std::string(query));
+			const auto first = std::lower_bound(_postings.keys.begin(), _postings.keys.end(), lowered);
+
+			std::vector<uint32_t> positions;
+			for (auto it = first; it != _postings.keys.end() && it->starts_with(lowered); ++it) {
+				positions.push_back(static_cast<uint32_t>(std::distance(_postings.keys.begin(), it)));
+			}
+
+			return recordsOf(positions);
+		}
+
+		/// <summary>
+		/// Record indexes whose string contains the query, ascending.
+		/// </summary>
+		std::vector<uint32_t> contains(std::string_view query) const {
+			const auto lowered = lower(std::string(query));
+			std::vector<uint32_t> positions;
+
+			if (lowered.size() < 3) {
+				for (uint32_t i = 0; i < _postings.keys.size(); i++) {
+					if (_postings.keys[i].find(lowered) != std::string::npos) {
+						positions.push_back(i);
+					}
+				}
+				return recordsOf(positions);
+			}
+
+			std::vector<std::span<const uint32_t>> lists;
+			for (size_t x = 0; x + 3 <= lowered.size(); x++) {
+				const auto key = trigram(lowered, x);
+				const auto found = std::lower_bound(_trigram_keys.begin(), _trigram_keys.end(), key);
+				if (found == _trigram_keys.end() || *found != key) {
+					return {};
+				}
+
+				const auto key_index = std::distance(_trigram_keys.begin(), found);
+				lists.push_back(std::span<const uint32_t>(_trigram_positions).subspan(_trigram_offsets[key_index], _trigram_offsets[key_index + 1] - _trigram_offsets[key_index]));
+			}
+
+			std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+
+			// shortest list first, then narrowed by the rest.
+			positions.assign(lists[0].begin(), lists[0].end());
+			std::vector<uint32_t> narrowed;
+			for (size_t i = 1; i < lists.size() && !positions.empty(); i++) {
+				narrowed.clear();
+				std::set_intersection(positions.begin(), positions.end(), lists[i].begin(), lists[i].end(), std::back_inserter(narrowed));
+				positions.swap(narrowed);
+			}
+
+			// trigrams can match out of order, so candidates are confirmed.
+			std::erase_if(positions, [&](uint32_t position) {
+				return _postings.keys[position].find(lowered) == std::string::npos;
+			});
+
+			return recordsOf(positions);
+		}
+
+		inline size_t stringCount() const {
+			return _postings.keys.size();
+		}
+
+		inline size_t trigramCount() const {
+			return _trigram_keys.size();
+		}
+
+		static std::string lower(std::string str) {
+			for (auto& c : str) {
+				if (c >= 'A' && c <= 'Z') {
+					c = static_cast<char>(c - 'A' + 'a');
+				}
+			}
+			return str;
+		}
+
+	private:
+		static inline uint32_t trigram(const std::string& str, size_t pos) {
+			return (uint32_t(uint8_t(str[pos])) << 16) | (uint32_t(uint8_t(str[pos + 1])) << 8) | uint32_t(uint8_t(str[pos + 2]));
+		}
+
+		std::vector<uint32_t> recordsOf(const std::vector<uint32_t>& positions) const {
+			std::vector<uint32_t> records;
+			for (const auto position : positions) {
+				const auto found = _postings.at(position);
+				records.insert(records.end(), found.begin(), found.end());
+			}
+			std::sort(records.begin(), records.end());
+			return records;
+		}
+
+		IndexPostings<std::string> _postings;
+		std::vector<uint32_t> _trigram_keys;
+		std::vector<uint32_t> _trigram_offsets;
+		std::vector<uint32_t> _trigram_positions;
+	};
+
+	/// <summary>
+	/// Builds a hash index from a single decoded column, encrypted records arent indexed.
+	/// K is std::string for string fields, otherwise one of uint32_t, int32_t, uint64_t, int64_t or float.
+	/// </summary>
+	template<typename K, TSchema S, TRecord R>
+	HashIndex<K> buildHashIndex(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index = 0) {
+		return HashIndex<K>(IndexDetail::build<K>(schema, source, field_index, array_index));
+	}
+
+	template<typename K, TNamedSchema S, TRecord R>
+	HashIndex<K> buildHashIndex(const S& schema, const DataSource<R>& source, std::string_view field_name, size_t array_index = 0) {
+		return buildHashIndex<K>(schema, source, namedFieldIndex(schema, field_name), array_index);
+	}
+
+	/// <summary>
+	/// Builds a sorted index from a single decoded column (radix sorted for numeric keys), encrypted records arent indexed.
+	/// </summary>
+	template<typename K, TSchema S, TRecord R>
+	SortedIndex<K> buildSortedIndex(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index = 0) {
+		return SortedIndex<K>(IndexDetail::build<K>(schema, source, field_index, array_index));
+	}
+
+	template<typename K, TNamedSchema S, TRecord R>
+	SortedIndex<K> buildSortedIndex(const S& schema, const DataSource<R>& source, std::string_view field_name, size_t array_index = 0) {
+		return buildSortedIndex<K>(schema, source, namedFieldIndex(schema, field_name), array_index);
+	}
+
+	/// <summary>
+	/// Builds a search index over a string or lang string column, encrypted records arent indexed.
+	/// </summary>
+	template<TSchema S, TRecord R>
+	StringSearchIndex buildStringSearchIndex(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index = 0) {
+		return StringSearchIndex(IndexDetail::build<std::string>(schema, source, field_index, array_index, [](std::string value) {
+			return StringSearchIndex::lower(std::move(value));
+		}));
+	}
+
+	template<TNamedSchema S, TRecord R>
+	StringSearchIndex buildStringSearchIndex(const S& schema, const DataSource<R>& source, std::string_view field_name, size_t array_index = 0) {
+		return buildStringSearchIndex(schema, source, namedFieldIndex(schema, field_name), array_index);
+	}
+
+	/// <summary>
+	/// Reads the key stored in an index file, an index is only valid alongside a snapshot with the same key.
+	/// </summary>
+	template<Filesystem::TFileSource FS>
+	SnapshotKey readIndexKey(FS* source) {
+		const auto header = IndexDetail::readHeader(source);
+		return SnapshotKey{
+			header.table_hash,
+			header.layout_hash,
+			GameVersion(header.build_expansion, header.build_major, header.build_minor, header.build_number)
+		};
+	}
+
+	/// <summary>
+	/// File name for an index of the field, next to the snapshot named by SnapshotKey::fileName().
+	/// </summary>
+	inline std::string indexFileName(const SnapshotKey& key, std::string_view field_name) {
+		return std::format("{:08x}_{:08x}_{}.{}.wdbi", key.tableHash, key.layoutHash, key.build.toString(), field_name);
+	}
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "../Database.hpp"
+#include "../Trace.hpp"
+#include "../WoWDBDefs.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	namespace JoinDetail {
+
+		constexpr uint32_t NO_RECORD = UINT32_MAX;
+
+		inline void requireIntegerField(const Field& field) {
+			if (field.type != Field::Type::INT) {
+				throw WDBReaderException("Foreign keys must be integer fields.");
+			}
+		}
+
+		/// <summary>
+		/// Reads a single integer element from a record, encrypted records and string fields have no key.
+		/// </summary>
+		template<TSchema S, TRecord R>
+		std::optional<int64_t> readKey(const S& schema, size_t field_index, size_t array_index, const R& record) {
+			if (record.encryptionState == RecordEncryption::ENCRYPTED) {
+				return std::nullopt;
+			}
+
+			const Field& field = schema.fields().at(field_index);
+			const auto location = DatabaseDetail::elementLocation(schema, field_index, array_index);
+			std::optional<int64_t> key;
+
+			schemaFieldHandler(field, [&]<typename V>() {
+				if constexpr (std::is_integral_v<V>) {
+					const V& value = R::template extractValue<V>(&record, location.elementIndex, location.dataOffset);
+					key = field.annotation.isSigned ? static_cast<int64_t>(static_cast<std::make_signed_t<V>>(value)) : static_cast<int64_t>(value);
+				}
+				else {
+					throw WDBReaderException("Foreign keys must be integer fields.");
+				}
+			});
+
+			return key;
+		}
+	}
+
+	/// <summary>
+	/// Hash table over the key column of a referenced table, mapping key values to record indexes.
+	/// Duplicate keys are chained, so keys other than the ID still resolve every match.
+	/// </summary>
+	template<TRecord R>
+	class KeyLookup final {
+	public:
+		KeyLookup(const DataSource<R>* source, const std::vector<std::optional<int64_t>>& keys) :
+			_source(source), _next(keys.size(), JoinDetail::NO_RECORD)
+		{
+			_heads.reserve(keys.size());
+			// inserted in reverse, so each chain runs in ascending record order.
+			for (uint32_t i = static_cast<uint32_t>(keys.size()); i-- > 0;) {
+				if (!keys[i].has_value()) {
+					continue;
+				}
+
+				auto [it, inserted] = _heads.try_emplace(*keys[i], i);
+				if (!inserted) {
+					_next[i] = it->second;
+					it->second = i;
+				}
+			}
+		}
+
+		/// <summary>
+		/// First record index with the key.
+		/// </summary>
+		std::optional<uint32_t> findIndex(int64_t key) const {
+			const auto found = _heads.find(key);
+			if (found == _heads.end()) {
+				return std::nullopt;
+			}
+			return found->second;
+		}
+
+		std::optional<R> find(int64_t key) const {
+			const auto index = findIndex(key);
+			if (!index.has_value()) {
+				return std::nullopt;
+			}
+			return (*_source)[*index];
+		}
+
+		/// <summary>
+		/// Calls fn(record_index) for every record with the key, ascending.
+		/// </summary>
+		template<typename Fn>
+		void forEachIndex(int64_t key, Fn fn) const {
+			const auto found = _heads.find(key);
+			for (uint32_t index = found != _heads.end() ? found->second : JoinDetail::NO_RECORD; index != JoinDetail::NO_RECORD; index = _next[index]) {
+				fn(index);
+			}
+		}
+
+		inline size_t keyCount() const {
+			return _heads.size();
+		}
+
+		inline const DataSource<R>& source() const {
+			return *_source;
+		}
+
+	private:
+		const DataSource<R>* _source;
+		std::unordered_map<int64_t, uint32_t> _heads;
+		std::vector<uint32_t> _next;
+	};
+
+	/// <summary>
+	/// Builds a lookup on the ID of a table, using recordIds() when the source provides them (inline or not),
+	/// otherwise the schemas ID field.
+	/// </summary>
+	template<TSchema S, TRecord R>
+	KeyLookup<R> buildIdLookup(const S& schema, const DataSource<R>& source) {
+		WDBREADER_TRACE_SCOPE("database", "buildIdLookup");
+
+		const auto ids = source.recordIds();
+		std::vector<std::optional<int64_t>> keys(source.size());
+
+		if (ids.size() == source.size()) {
+			for (size_t i = 0; i < ids.size(); i++) {
+				keys[i] = ids[i];
+			}
+		}
+		else {
+			const auto id_field = idFieldIndex(schema);
+			if (!id_field.has_value()) {
+				throw WDBReaderException("Table has no ID to join on.");
+			}
+
+			forEachColumnValue<int64_t>(schema, source, *id_field, 0, source.size(), [&keys](uint32_t record_index, int64_t value) {
+				keys[record_index] = value;
+			});
+		}
+
+		return KeyLookup<R>(&source, keys);
+	}
+
+	/// <summary>
+	/// Builds a lookup on any integer field element, encrypted records arent included.
+	/// </summary>
+	template<TSchema S, TRecord R>
+	KeyLookup<R> buildKeyLookup(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index = 0) {
+		WDBREADER_TRACE_SCOPE("database", "buildKeyLookup");
+
+		std::vector<std::optional<int64_t>> keys(source.size());
+		JoinDetail::requireIntegerField(schema.fields().at(field_index));
+
+		forEachColumnValue<int64_t>(schema, source, field_index, array_index, source.size(), [&keys](uint32_t record_index, int64_t value) {
+			keys[record_index] = value;
+		});
+
+		return KeyLookup<R>(&source, keys);
+	}
+
+	/// <summary>
+	/// Inner join from a foreign key column of one table onto the key lookup of another.
+	/// The referencing table is streamed rather than decoded up front.
+	/// </summary>
+	template<TSchema S, TRecord R, TRecord FR>
+	class ForeignKeyJoin final {
+	public:
+		ForeignKeyJoin(const S& schema, const DataSource<R>& source, size_t field_index, size_t array_index, KeyLookup<FR> lookup) :
+			_schema(&schema), _source(&source), _field_index(field_index), _array_index(array_index), _lookup(std::move(lookup))
+		{
+			JoinDetail::requireIntegerField(schema.fields().at(field_index));
+		}
+
+		/// <summary>
+		/// Resolves the foreign key of a single referencing record, giving the first match.
+		/// </summary>
+		std::optional<FR> resolve(const R& record) const {
+			const auto key = JoinDetail::readKey(*_schema, _field_index, _array_index, record);
+			if (!key.has_value()) {
+				return std::nullopt;
+			}
+			return _lookup.find(*key);
+		}
+
+		/// <summary>
+		/// Calls fn(record, foreign_record) for every matching pair, in referencing record order.
+		/// Records without a match are skipped, so a zero key (by convention "none") only matches a real zero ID.
+		/// </summary>
+		template<typename Fn>
+		void forEach(Fn fn) const {
+			WDBREADER_TRACE_SCOPE("database", "foreignKeyJoin");
+
+			const auto& foreign_source = _lookup.source();
+			const uint32_t record_count = static_cast<uint32_t>(_source->size());
+			for (uint32_t i = 0; i < record_count; i++) {
+				const R record = (*_source)[i];
+				const auto key = JoinDetail::readKey(*_schema, _field_index, _array_index, record);
+				if (!key.has_value()) {
+					continue;
+				}
+
+				_lookup.forEachIndex(*key, [&](uint32_t foreign_index) {
+					const FR foreign_record = foreign_source[foreign_index];
+					fn(record, foreign_record);
+				});
+			}
+		}
+
+		inline const KeyLookup<FR>& lookup() const {
+			return _lookup;
+		}
+
+	private:
+		const S* _schema;
+		const DataSource<R>* _source;
+		size_t _field_index;
+		size_t _array_index;
+		KeyLookup<FR> _lookup;
+	};
+
+	/// <summary>
+	/// Joins a column onto the table named by its definitions foreignTable/foreignColumn, the caller supplies the opened foreign table.
+	/// A foreignColumn of "ID" joins on the foreign tables record IDs, anything else on that named field.
+	/// </summary>
+	template<TNamedSchema S, TRecord R, TNamedSchema FS, TRecord FR>
+	ForeignKeyJoin<S, R, FR> joinForeignKey(const WoWDBDefs::DBDefinition& definition, std::string_view column,
+		const S& schema, const DataSource<R>& source,
+		const FS& foreign_schema, const DataSource<FR>& foreign_source,
+		size_t array_index = 0)
+	{
+		const auto column_def = definition.columnDefinitions.find(std::string(column));
+		if (column_def == definition.columnDefinitions.end() || column_def->second.foreignTable.empty()) {
+			throw WDBReaderException("Column has no foreign key definition.");
+		}
+
+		const auto& foreign_column = column_def->second.foreignColumn;
+		auto lookup = foreign_column.empty() || foreign_column == "ID" ?
+			buildIdLookup(foreign_schema, foreign_source) :
+			buildKeyLookup(foreign_schema, foreign_source, namedFieldIndex(foreign_schema, foreign_column));
+
+		return ForeignKeyJoin<S, R, FR>(schema, source, namedFieldIndex(schema, column), array_index, std::move(lookup));
+	}
+}
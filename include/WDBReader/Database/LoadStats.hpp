@@ -0,0 +1,143 @@
+#pragma once
+
+#include "../Filesystem.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	enum class LoadPhase : uint8_t {
+		HEADER,
+		SECTION_HEADERS,
+		FIELD_STRUCTURES,
+		FIELD_STORAGE,
+		PALLET_DATA,
+		COMMON_DATA,
+		RECORDS,
+		ID_LIST,
+		COPY_TABLE,
+		OFFSET_MAP,
+		RELATIONSHIPS,
+		RELATIONSHIP_MAP,
+		COUNT
+	};
+
+	inline constexpr std::string_view loadPhaseName(LoadPhase phase) {
+		switch (phase) {
+		case LoadPhase::HEADER:				return "header";
+		case LoadPhase::SECTION_HEADERS:	return "section_headers";
+		case LoadPhase::FIELD_STRUCTURES:	return "field_structures";
+		case LoadPhase::FIELD_STORAGE:		return "field_storage";
+		case LoadPhase::PALLET_DATA:		return "pallet_data";
+		case LoadPhase::COMMON_DATA:		return "common_data";
+		case LoadPhase::RECORDS:			return "records";
+		case LoadPhase::ID_LIST:			return "id_list";
+		case LoadPhase::COPY_TABLE:			return "copy_table";
+		case LoadPhase::OFFSET_MAP:			return "offset_map";
+		case LoadPhase::RELATIONSHIPS:		return "relationships";
+		case LoadPhase::RELATIONSHIP_MAP:	return "relationship_map";
+		default:							return "unknown";
+		}
+	}
+
+	struct PhaseStats {
+	public:
+		std::chrono::nanoseconds time{ 0 };
+		uint64_t bytes = 0;		// bytes consumed from the source.
+	};
+
+	/// <summary>
+	/// Approximate memory held by a structure member after loading.
+	/// </summary>
+	struct ResidentStats {
+	public:
+		std::string_view name;
+		size_t bytes;
+	};
+
+	/// <summary>
+	/// Timing and size information gathered during open() and load().
+	/// </summary>
+	struct LoadStats {
+	public:
+		std::array<PhaseStats, static_cast<size_t>(LoadPhase::COUNT)> phases{};
+		std::vector<ResidentStats> resident;
+
+		inline PhaseStats& operator[](LoadPhase phase) {
+			return phases[static_cast<size_t>(phase)];
+		}
+
+		inline const PhaseStats& operator[](LoadPhase phase) const {
+			return phases[static_cast<size_t>(phase)];
+		}
+
+		inline std::chrono::nanoseconds totalTime() const {
+			std::chrono::nanoseconds total{ 0 };
+			for (const auto& phase : phases) {
+				total += phase.time;
+			}
+			return total;
+		}
+
+		inline uint64_t totalBytes() const {
+			uint64_t total = 0;
+			for (const auto& phase : phases) {
+				total += phase.bytes;
+			}
+			return total;
+		}
+
+		inline size_t residentBytes() const {
+			size_t total = 0;
+			for (const auto& item : resident) {
+				total += item.bytes;
+			}
+			return total;
+		}
+
+		/// <summary>
+		/// Accumulates the elapsed time and the distance the source moved into the phase, for as long as the timer is in scope.
+		/// </summary>
+		template<Filesystem::TFileSource FS>
+		class Timer final {
+		public:
+			Timer(PhaseStats& stats, const FS* source) :
+				_stats(stats), _source(source), _start_pos(source->getPos()), _start(std::chrono::steady_clock::now())
+			{}
+			Timer(const Timer&) = delete;
+			Timer& operator=(const Timer&) = delete;
+
+			~Timer() {
+				_stats.time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+				const auto end_pos = _source->getPos();
+				if (end_pos > _start_pos) {
+					_stats.bytes += end_pos - _start_pos;
+				}
+			}
+
+		private:
+			PhaseStats& _stats;
+			const FS* _source;
+			const uint64_t _start_pos;
+			const std::chrono::steady_clock::time_point _start;
+		};
+
+		template<Filesystem::TFileSource FS>
+		inline Timer<FS> time(LoadPhase phase, const FS* source) {
+			return Timer<FS>((*this)[phase], source);
+		}
+	};
+
+	/// <summary>
+	/// Estimate of the memory used by an unordered_map, including node and bucket overhead.
+	/// </summary>
+	template<typename M>
+	inline size_t unorderedMapResidentBytes(const M& map) {
+		constexpr size_t node_overhead = sizeof(void*) * 2;
+		return (map.size() * (sizeof(typename M::value_type) + node_overhead)) + (map.bucket_count() * sizeof(void*));
+	}
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../Filesystem.hpp"
+#include "DB2Format.hpp"
+#include "DBCFile.hpp"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	/// <summary>
+	/// Summary of a db file, read from its headers only.
+	/// </summary>
+	struct DBProbe {
+	public:
+		Signature signature;
+		std::optional<uint32_t> tableHash;
+		std::optional<uint32_t> layoutHash;
+		uint32_t recordCount;			// excluding copy table rows.
+		uint32_t copyCount;
+		uint32_t fieldCount;
+		uint32_t sectionCount;
+		uint32_t flags;					// DB2HeaderFlags, 0 for formats without flags.
+		uint64_t estimatedDecodedSize;	// record and string data the loaders decode, in bytes.
+
+		inline DBFormat format() const {
+			DBFormat fmt(signature);
+			fmt.tableHash = tableHash;
+			fmt.layoutHash = layoutHash;
+			return fmt;
+		}
+	};
+
+	namespace ProbeDetail {
+
+		template<Filesystem::TFileSource FS, typename T>
+		inline void readHeader(FS& source, T& dest) {
+			if (source.size() - source.getPos() < sizeof(T)) {
+				throw WDBReaderException("File too small for header.");
+			}
+			source.read(&dest, sizeof(T));
+		}
+
+		template<TDB2FormatModern F, Filesystem::TFileSource FS>
+		DBProbe probeModern(FS& source) {
+			typename F::Header header;
+			readHeader(source, header);
+
+			// checked before allocating, a corrupt count would otherwise size a huge vector.
+			if (header.section_count > (source.size() - source.getPos()) / sizeof(typename F::SectionHeader)) {
+				throw WDBReaderException("File too small for section headers.");
+			}
+
+			std::vector<typename F::SectionHeader> sections(header.section_count);
+			for (auto& section : sections) {
+				readHeader(source, section);
+			}
+
+			DBProbe probe{ F::signature, header.table_hash, header.layout_hash, header.record_count, 0, header.field_count, header.section_count, header.flags, 0 };
+
+			uint64_t record_bytes = 0;
+			for (const auto& section : sections) {
+				probe.copyCount += section.copy_table_count;
+
+				if ((header.flags & DB2HeaderFlags::HasOffsetMap) != 0) {
+					if (section.offset_records_end < section.file_offset) {
+						throw WDBReaderException("Invalid section offsets.");
+					}
+					record_bytes += section.offset_records_end - section.file_offset;
+				}
+				else {
+					record_bytes += uint64_t(section.record_count) * header.record_size;
+				}
+			}
+
+			// copied rows decode to the same size as the rows they copy.
+			const uint64_t average_record = header.record_count > 0 ? record_bytes / header.record_count : 0;
+			probe.estimatedDecodedSize = record_bytes + (average_record * probe.copyCount) + header.string_table_size;
+
+			return probe;
+		}
+	}
+
+	/// <summary>
+	/// Reads the header (and section headers) of a db file, without creating a loader.
+	/// Returns nullopt when the signature isnt a known db format, the source is left at position 0.
+	/// </summary>
+	template<Filesystem::TFileSource FS>
+	std::optional<DBProbe> probeDBFile(FS& source) {
+		using namespace ProbeDetail;
+		WDBREADER_TRACE_SCOPE("database", "probeDBFile");
+
+		Signature sig;
+		if (source.size() < sizeof(sig.integer)) {
+			return std::nullopt;
+		}
+
+		source.setPos(0);
+		source.read(&sig.integer, sizeof(sig.integer));
+		source.setPos(0);
+
+		std::optional<DBProbe> result = std::nullopt;
+
+		if (sig.integer == WDBC_MAGIC.integer) {
+			DBCHeader header;
+			readHeader(source, header);
+			result = DBProbe{ WDBC_MAGIC, std::nullopt, std::nullopt, header.recordCount, 0, header.fieldCount, 1, 0,
+				(uint64_t(header.recordCount) * header.recordSize) + header.stringBlockSize };
+		}
+		else if (sig.integer == DB2FileFormatWDB2::signature.integer) {
+			DB2FileFormatWDB2::Header header;
+			readHeader(source, header);
+			result = DBProbe{ DB2FileFormatWDB2::signature, header.table_hash, std::nullopt, header.record_count, 0, header.field_count, 1, 0,
+				(uint64_t(header.record_count) * header.record_size) + header.string_table_size };
+		}
+		else if (sig.integer == DB2FileFormatWDC3::signature.integer) {
+			result = probeModern<DB2FileFormatWDC3>(source);
+		}
+		else if (sig.integer == DB2FileFormatWDC4::signature.integer) {
+			result = probeModern<DB2FileFormatWDC4>(source);
+		}
+		else if (sig.integer == DB2FileFormatWDC5::signature.integer) {
+			result = probeModern<DB2FileFormatWDC5>(source);
+		}
+
+		source.setPos(0);
+		return result;
+	}
+}
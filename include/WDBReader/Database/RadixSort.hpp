@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	/// <summary>
+	/// Maps a value to an unsigned key with the same ordering, so signed and float columns can be radix sorted.
+	/// </summary>
+	template<typename T>
+	inline constexpr auto radixKey(T value) {
+		static_assert(std::is_arithmetic_v<T> && sizeof(T) <= sizeof(uint64_t));
+
+		if constexpr (std::is_floating_point_v<T>) {
+			using bits_t = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+			const auto bits = std::bit_cast<bits_t>(value);
+			constexpr bits_t sign = bits_t(1) << ((sizeof(bits_t) * 8) - 1);
+			// negatives are reversed entirely, positives only need to move above them.
+			return (bits & sign) != 0 ? bits_t(~bits) : bits_t(bits | sign);
+		}
+		else if constexpr (std::is_signed_v<T>) {
+			using unsigned_t = std::make_unsigned_t<std::conditional_t<(sizeof(T) < sizeof(uint32_t)), int32_t, T>>;
+			constexpr unsigned_t sign = unsigned_t(1) << ((sizeof(unsigned_t) * 8) - 1);
+			return unsigned_t(unsigned_t(value) ^ sign);
+		}
+		else {
+			using unsigned_t = std::conditional_t<(sizeof(T) < sizeof(uint32_t)), uint32_t, T>;
+			return unsigned_t(value);
+		}
+	}
+
+	/// <summary>
+	/// Stable LSD radix sort of the keys, returning the original positions in sorted order.
+	/// Byte passes where every key has the same digit are skipped, so narrow key ranges cost fewer passes.
+	/// </summary>
+	template<typename K>
+	std::vector<uint32_t> radixSortPermutation(std::vector<K> keys) {
+		static_assert(std::is_unsigned_v<K>, "Keys must be mapped with radixKey first.");
+
+		const size_t count = keys.size();
+		std::vector<uint32_t> order(count);
+		std::iota(order.begin(), order.end(), 0);
+
+		if (count < 2) {
+			return order;
+		}
+
+		std::vector<K> keys_out(count);
+		std::vector<uint32_t> order_out(count);
+
+		for (uint32_t shift = 0; shift < sizeof(K) * 8; shift += 8) {
+			std::array<size_t, 256> offsets{};
+			for (const auto key : keys) {
+				offsets[(key >> shift) & 0xFF]++;
+			}
+
+			if (offsets[(keys[0] >> shift) & 0xFF] == count) {
+				continue;
+			}
+
+			size_t total = 0;
+			for (auto& offset : offsets) {
+				const auto bucket = offset;
+				offset = total;
+				total += bucket;
+			}
+
+			for (size_t i = 0; i < count; i++) {
+				const auto dest = offsets[(keys[i] >> shift) & 0xFF]++;
+				keys_out[dest] = keys[i];
+				order_out[dest] = order[i];
+			}
+
+			keys.swap(keys_out);
+			order.swap(order_out);
+		}
+
+		return order;
+	}
+}
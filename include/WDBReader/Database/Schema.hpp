@@ -4,13 +4,16 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <stdexcept>	
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <variant>
@@ -24,7 +27,26 @@ namespace WDBReader::Database
     using lang_string_ref_t = uint32_t;
 
     static_assert(sizeof(char) == sizeof(uint8_t));
-    using string_data_t = std::unique_ptr<char[]>;
+
+    /// <summary>
+    /// String data is prefixed with a single byte describing who owns the memory.
+    /// Owned strings are freed with the value, storage strings are freed by the string storage which created them.
+    /// </summary>
+    enum class StringOwnership : uint8_t {
+        OWNED = 0,
+        STORAGE = 1
+    };
+
+    struct string_data_deleter {
+        inline void operator()(char* str) const noexcept
+        {
+            if (str != nullptr && static_cast<StringOwnership>(str[-1]) == StringOwnership::OWNED) {
+                delete[] (str - 1);
+            }
+        }
+    };
+
+    using string_data_t = std::unique_ptr<char[], string_data_deleter>;
     using string_data_ref_t = const char *;
 
     static_assert(sizeof(string_data_t) == sizeof(string_data_ref_t));
@@ -242,7 +264,7 @@ namespace WDBReader::Database
         {
         }
 
-        constexpr field_container_t fields() const
+        constexpr const field_container_t& fields() const
         {
             return _fields;
         }
@@ -267,6 +289,17 @@ namespace WDBReader::Database
         using field_container_t = std::vector<Field>;
         using field_name_t = std::string;
 
+        /// <summary>
+        /// A field resolved once by name, for reading the same fields across many records without looking the names up again.
+        /// Only valid with the schema it was created from.
+        /// </summary>
+        struct FieldHandle
+        {
+        public:
+            uint32_t index;
+            uint32_t offset;    // of the fields first element in the record.
+        };
+
         template <TRecord R>
         struct record_accessor
         {
@@ -392,43 +425,58 @@ namespace WDBReader::Database
 
             inline constexpr record_value_t operator[](const field_name_t& name) const
             {
-                const auto index = name_index(name);
-                const auto &field = _schema._fields[index];
-                const auto &offset = _schema._field_offsets[index];
+                return (*this)[_schema.handle(name)];
+            }
+
+            inline constexpr record_value_t operator[](const FieldHandle& handle) const
+            {
+                assert(handle.index < _schema._fields.size());
+                const auto &field = _schema._fields[handle.index];
 
                 return {
-                    reinterpret_cast<const runtime_value_ref_t*>(&_record.data[offset]),
+                    reinterpret_cast<const runtime_value_ref_t*>(&_record.data[handle.offset]),
                     field.size
                 };
             }
 
+            /// <summary>
+            /// Reads the fields by name or FieldHandle, converting each to the matching type.
+            /// </summary>
             template<typename... Ts>
             std::tuple<Ts...> get(const auto& ...names) const
             {
-                std::tuple<Ts...> result;
-
                 static_assert(sizeof...(Ts) == sizeof...(names));
 
-                std::array<bool, sizeof...(Ts)> found;
-                found.fill(false);
-                bool all_found = false;
+                const std::array<FieldHandle, sizeof...(Ts)> handles{ resolve(names)... };
+                return get<Ts...>(handles);
+            }
 
-                auto check = [&result, &found]<size_t idx>(auto & it, const auto & arg_name) -> bool {
+            /// <summary>
+            /// Reads fields resolved by RuntimeSchema::compile.
+            /// </summary>
+            template<typename... Ts>
+            std::tuple<Ts...> get(const std::array<FieldHandle, sizeof...(Ts)>& handles) const
+            {
+                std::tuple<Ts...> result;
 
+                auto read = [this, &result, &handles]<size_t idx>() {
 
-                    using dest_t = std::tuple_element<idx, decltype(result)>::type;
+                    using dest_t = typename std::tuple_element<idx, std::tuple<Ts...>>::type;
                     constexpr bool is_array = is_std_array_v<dest_t>;
                     using dest_val_t = element_value_t<dest_t>;
-                    using temp_t = std::conditional_t<
+                    using temp_t = typename std::conditional_t<
                         std::is_enum_v<dest_val_t>,
                         std::underlying_type<dest_val_t>,
                         std::type_identity<dest_val_t>
                     >::type;
 
-                    auto val_read = [&](size_t val_index, auto& it) -> dest_val_t {
+                    const Field& field = _schema._fields[handles[idx].index];
+                    const record_value_t value = (*this)[handles[idx]];
+
+                    auto val_read = [&](size_t val_index) -> dest_val_t {
                         dest_val_t out;
 
-                        std::visit([&out, &it](const auto& v) {
+                        std::visit([&out, &field](const auto& v) {
                             using val_t = std::decay_t<decltype(v)>;
 
                             auto bounds_check = [](const auto& val) {
@@ -444,7 +492,7 @@ namespace WDBReader::Database
                             if constexpr (std::is_convertible_v<val_t, temp_t>) {
 
                                 if constexpr (std::is_integral_v<val_t> && sizeof(dest_val_t) != sizeof(val_t) && std::is_signed_v<dest_val_t>) {
-                                    if (it->field->annotation.isSigned) {
+                                    if (field.annotation.isSigned) {
 
                                         auto signed_v = static_cast<std::make_signed_t<val_t>>(v);
                                         bounds_check(signed_v);
@@ -461,77 +509,54 @@ namespace WDBReader::Database
                                 throw std::runtime_error("Invalid type for index " + std::to_string(idx));
                             }
 
-                        }, it->value[val_index]);
+                        }, value[val_index]);
 
                         return out;
                     };
 
-                    if (*it->name == arg_name) {
-   
-                        if constexpr (is_array) {
-                            constexpr size_t max_dest_size = std::conditional_t<
-                                is_array,
-                                std::tuple_size<dest_t>,
-                                std::integral_constant<size_t, 1>
-                            >::value;
-                            static_assert(max_dest_size >= 1, "Destination size cannot be empty.");
-
-                            const auto max_size = std::min(max_dest_size, it->value.size());
-                            auto& result_array = std::get<idx>(result);
-
-                            for (size_t i = 0; i < max_size; i++) {
-                                result_array[i] = val_read(i, it);
-                            }
+                    if constexpr (is_array) {
+                        constexpr size_t max_dest_size = std::tuple_size<dest_t>::value;
+                        static_assert(max_dest_size >= 1, "Destination size cannot be empty.");
 
-                            for (size_t i = max_size; i < max_dest_size; i++) {
-                                // default init any excess values.
-                                result_array[i] = dest_val_t{};
-                            }
-                        }
-                        else {
-                            std::get<idx>(result) = val_read(0, it);
+                        const auto max_size = std::min(max_dest_size, value.size());
+                        auto& result_array = std::get<idx>(result);
+
+                        for (size_t i = 0; i < max_size; i++) {
+                            result_array[i] = val_read(i);
                         }
 
-                        found[idx] = true;
-                        return true;
+                        for (size_t i = max_size; i < max_dest_size; i++) {
+                            // default init any excess values.
+                            result_array[i] = dest_val_t{};
+                        }
                     }
-                    return false;
-                };
-
-                for (auto it = begin(); it != end(); ++it) {
-
-                    auto try_set = [&check, &it]<typename... Args, size_t... Is>(std::index_sequence<Is...>, const Args& ...arg_names) {
-                        (check.template operator()<Is>(it, arg_names) || ...);
-                    };
-
-                    try_set(std::index_sequence_for<Ts...>{}, names...);
-
-                    if (std::all_of(found.begin(), found.end(), [](bool test) {return test; })) {
-                        all_found = true;
-                        break;
+                    else {
+                        std::get<idx>(result) = val_read(0);
                     }
-                }
+                };
 
-                if (!all_found) {
-                    throw std::runtime_error("Unable to match all arguments.");
-                }
+                [&read]<size_t... Is>(std::index_sequence<Is...>) {
+                    (read.template operator()<Is>(), ...);
+                }(std::index_sequence_for<Ts...>{});
 
                 return result;
             }
 
-     
-
         private:
-            inline uint32_t name_index(const field_name_t& name) const
+            inline FieldHandle resolve(const FieldHandle& handle) const
             {
-                const auto it = std::find(_schema._names.cbegin(), _schema._names.cend(), name);
+                return handle;
+            }
 
-                if (it == _schema._names.cend())
+            inline FieldHandle resolve(std::string_view name) const
+            {
+                const auto index = _schema.fieldIndex(name);
+                if (!index.has_value())
                 {
-                    throw std::out_of_range("Name doesnt exist.");
+                    throw std::runtime_error("Unable to match all arguments.");
                 }
 
-                return std::distance(_schema._names.cbegin(), it);
+                return FieldHandle{ *index, _schema._field_offsets[*index] };
             }
 
             const R& _record;
@@ -555,6 +580,29 @@ namespace WDBReader::Database
                 pos += it->size;
                 _element_count += it->size;
             }
+
+            // open addressing at under half full, slots hold the field index + 1 so copies of the schema stay valid.
+            size_t table_size = 1;
+            while (table_size < _names.size() * 2)
+            {
+                table_size *= 2;
+            }
+
+            _name_table.assign(table_size, 0);
+            for (uint32_t index = 0; index < _names.size(); index++)
+            {
+                size_t slot = std::hash<std::string_view>{}(_names[index]) & (table_size - 1);
+                while (_name_table[slot] != 0 && _names[_name_table[slot] - 1] != _names[index])
+                {
+                    slot = (slot + 1) & (table_size - 1);
+                }
+
+                // the first field wins for duplicate names.
+                if (_name_table[slot] == 0)
+                {
+                    _name_table[slot] = index + 1;
+                }
+            }
         }
         RuntimeSchema(const RuntimeSchema&) = default;
         RuntimeSchema(RuntimeSchema&&) = default;
@@ -577,6 +625,49 @@ namespace WDBReader::Database
             return record_accessor<R>(*this, record);
         }
 
+        /// <summary>
+        /// Index of the named field, by hash rather than comparing every name.
+        /// </summary>
+        std::optional<uint32_t> fieldIndex(std::string_view name) const
+        {
+            if (_name_table.empty())
+            {
+                return std::nullopt;
+            }
+
+            const size_t mask = _name_table.size() - 1;
+            for (size_t slot = std::hash<std::string_view>{}(name) & mask; _name_table[slot] != 0; slot = (slot + 1) & mask)
+            {
+                const uint32_t index = _name_table[slot] - 1;
+                if (_names[index] == name)
+                {
+                    return index;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        FieldHandle handle(std::string_view name) const
+        {
+            const auto index = fieldIndex(name);
+            if (!index.has_value())
+            {
+                throw std::out_of_range("Name doesnt exist.");
+            }
+
+            return FieldHandle{ *index, _field_offsets[*index] };
+        }
+
+        /// <summary>
+        /// Resolves the names once, the handles can then be used with record_accessor::get and operator[] for any record.
+        /// </summary>
+        template<typename... Names>
+        std::array<FieldHandle, sizeof...(Names)> compile(const Names& ...names) const
+        {
+            return { handle(names)... };
+        }
+
         constexpr size_t elementCount() const
         {
             return _element_count;
@@ -587,6 +678,7 @@ namespace WDBReader::Database
         field_container_t _fields;
         std::vector<field_name_t> _names;
         std::vector<uint32_t> _field_offsets;
+        std::vector<uint32_t> _name_table;
         size_t _element_count;
     };
 
@@ -636,6 +728,16 @@ namespace WDBReader::Database
             uint8_t* const field_offset = ((uint8_t*)&record->data) + dest_data_offset;
             *((t_value*)field_offset) = std::move(value);
         }
+
+        /// <summary>
+        /// Reads a value previously inserted, element_index is the position across all fields.
+        /// </summary>
+        template <typename T>
+        inline constexpr static const T& extractValue(const R* record, uint32_t element_index, ptrdiff_t data_offset)
+        {
+            const uint8_t* const field_offset = ((const uint8_t*)&record->data) + data_offset;
+            return *((const T*)field_offset);
+        }
     };
 
     template <typename R>
@@ -657,6 +759,12 @@ namespace WDBReader::Database
         {
             record->data.emplace_back(std::move(value));
         }
+
+        template <typename T>
+        inline constexpr static const T& extractValue(const R* record, uint32_t element_index, ptrdiff_t data_offset)
+        {
+            return std::get<T>(record->data[element_index]);
+        }
     };
 
     struct RuntimeRecord : public VariableRecord<RuntimeRecord>
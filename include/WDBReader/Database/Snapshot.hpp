@@ -0,0 +1,582 @@
+#pragma once
+
+#include "../Database.hpp"
+#include "../Filesystem.hpp"
+#include "../Utility.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	/*
+		Snapshot files store already decoded table data, so repeated loads can skip the DBC/DB2 decoding entirely.
+		Layout:
+			SnapshotHeader
+			SnapshotFieldInfo[field_count], each followed by the field name.
+			rows[record_count], each row is the encryption state followed by fixed width elements (strings are heap offsets).
+			string heap, entries are [uint32_t length][bytes][\0], offset 0 is always the empty string.
+			SnapshotIdIndexEntry[id_index_count], sorted by id.
+	*/
+
+	constexpr Signature SNAPSHOT_MAGIC = "WDBS";
+	constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	/// <summary>
+	/// Identifies the source data of a snapshot, a snapshot is only valid for the exact key it was written with.
+	/// </summary>
+	struct SnapshotKey {
+	public:
+		uint32_t tableHash;
+		uint32_t layoutHash;
+		GameVersion build;
+
+		constexpr auto operator<=>(const SnapshotKey&) const = default;
+
+		inline std::string fileName() const {
+			return std::format("{:08x}_{:08x}_{}.wdbs", tableHash, layoutHash, build.toString());
+		}
+	};
+
+#pragma pack(push, 1)
+
+	struct SnapshotHeader {
+		uint32_t signature;
+		uint32_t version;
+		uint32_t table_hash;
+		uint32_t layout_hash;
+		uint16_t build_expansion;
+		uint16_t build_major;
+		uint16_t build_minor;
+		uint16_t padding;
+		uint32_t build_number;
+		uint32_t record_count;
+		uint32_t field_count;
+		uint32_t row_size;
+		uint32_t id_index_count;
+		uint64_t rows_offset;
+		uint64_t strings_offset;
+		uint64_t strings_size;
+		uint64_t id_index_offset;
+	};
+
+	struct SnapshotFieldInfo {
+		uint8_t type;
+		uint8_t bytes;
+		uint8_t size;
+		uint8_t annotation;
+		uint16_t name_length;
+	};
+
+	struct SnapshotIdIndexEntry {
+		uint32_t id;
+		uint32_t record_index;
+	};
+
+#pragma pack(pop)
+
+	namespace SnapshotDetail {
+
+		enum AnnotationFlags : uint8_t {
+			Id = 0x01,
+			Relation = 0x02,
+			Inline = 0x04,
+			Signed = 0x08
+		};
+
+		inline uint8_t packAnnotation(const Annotation& annotation) {
+			return (annotation.isId ? Id : 0) |
+				(annotation.isRelation ? Relation : 0) |
+				(annotation.isInline ? Inline : 0) |
+				(annotation.isSigned ? Signed : 0);
+		}
+
+		inline Annotation unpackAnnotation(uint8_t flags) {
+			return Annotation((flags & Id) != 0, (flags & Relation) != 0, (flags & Inline) != 0, (flags & Signed) != 0);
+		}
+
+		inline Field makeField(const SnapshotFieldInfo& info) {
+			const auto annotation = unpackAnnotation(info.annotation);
+			switch (static_cast<Field::Type>(info.type)) {
+			case Field::Type::INT:
+				return Field::integerArray(info.bytes * info.size, info.size, annotation);
+			case Field::Type::FLOAT:
+				return Field::floatingPointArray(info.bytes * info.size, info.size, annotation);
+			case Field::Type::STRING:
+				return Field::string(info.size, annotation);
+			case Field::Type::LANG_STRING:
+				return Field::langString(info.size, annotation);
+			}
+
+			throw WDBReaderException("Invalid snapshot field type.");
+		}
+
+		/// <summary>
+		/// Bytes used by a single element in a snapshot row.
+		/// </summary>
+		inline constexpr uint32_t elementSize(const Field& field) {
+			if (field.type == Field::Type::STRING || field.type == Field::Type::LANG_STRING) {
+				return sizeof(uint32_t);
+			}
+
+			return field.bytes;
+		}
+
+		inline constexpr uint32_t rowSize(const auto& fields) {
+			uint32_t size = sizeof(RecordEncryption);
+			for (const Field& field : fields) {
+				size += elementSize(field) * field.size;
+			}
+			return size;
+		}
+
+		inline std::optional<uint32_t> idFieldIndex(const auto& fields) {
+			uint32_t index = 0;
+			for (const Field& field : fields) {
+				if (field.annotation.isId && field.type == Field::Type::INT && field.bytes <= sizeof(uint32_t)) {
+					return index;
+				}
+				index++;
+			}
+			return std::nullopt;
+		}
+
+		/// <summary>
+		/// True when [offset, offset + length) lies within size, without overflowing.
+		/// </summary>
+		inline constexpr bool fits(uint64_t offset, uint64_t length, uint64_t size) {
+			return offset <= size && length <= size - offset;
+		}
+
+		/// <summary>
+		/// Lets the string heap map be searched with string_views, without building a std::string per lookup.
+		/// </summary>
+		struct StringHash {
+			using is_transparent = void;
+
+			size_t operator()(std::string_view value) const noexcept {
+				return std::hash<std::string_view>{}(value);
+			}
+		};
+
+		template<Filesystem::TFileSource FS>
+		SnapshotHeader readHeader(FS* source) {
+			SnapshotHeader header;
+			source->setPos(0);
+			source->read(&header, sizeof(header));
+
+			if (header.signature != SNAPSHOT_MAGIC.integer) {
+				throw WDBReaderException("Header signature doesnt match.");
+			}
+
+			if (header.version != SNAPSHOT_VERSION) {
+				throw WDBReaderException("Unsupported snapshot version.");
+			}
+
+			return header;
+		}
+
+		template<Filesystem::TFileSource FS>
+		RuntimeSchema readSchema(FS* source, const SnapshotHeader& header) {
+			// checked before reserving, a corrupt count would otherwise size huge vectors.
+			if (source->size() < sizeof(SnapshotHeader) || header.field_count > (source->size() - sizeof(SnapshotHeader)) / sizeof(SnapshotFieldInfo)) {
+				throw WDBReaderException("File too small for field infos.");
+			}
+
+			std::vector<Field> fields;
+			std::vector<RuntimeSchema::field_name_t> names;
+			fields.reserve(header.field_count);
+			names.reserve(header.field_count);
+
+			source->setPos(sizeof(SnapshotHeader));
+			for (uint32_t i = 0; i < header.field_count; i++) {
+				SnapshotFieldInfo info;
+				source->read(&info, sizeof(info));
+				fields.push_back(makeField(info));
+
+				std::string name(info.name_length, '\0');
+				source->read(name.data(), info.name_length);
+				names.push_back(std::move(name));
+			}
+
+			return RuntimeSchema(std::move(fields), std::move(names));
+		}
+	}
+
+	/// <summary>
+	/// Writes the decoded contents of a data source, the data source must already be loaded.
+	/// </summary>
+	template<TSchema S, TRecord R>
+	void writeSnapshot(std::ostream& stream, const S& schema, const DataSource<R>& source, const SnapshotKey& key)
+	{
+		WDBREADER_TRACE_SCOPE("database", "writeSnapshot");
+		const auto fields = schema.fields();
+		const uint32_t row_size = SnapshotDetail::rowSize(fields);
+		const auto id_field_index = SnapshotDetail::idFieldIndex(fields);
+
+		auto write = [&stream](const void* data, size_t bytes) {
+			stream.write(reinterpret_cast<const char*>(data), bytes);
+		};
+
+		SnapshotHeader header{};
+		header.signature = SNAPSHOT_MAGIC.integer;
+		header.version = SNAPSHOT_VERSION;
+		header.table_hash = key.tableHash;
+		header.layout_hash = key.layoutHash;
+		header.build_expansion = key.build.expansion;
+		header.build_major = key.build.major;
+		header.build_minor = key.build.minor;
+		header.build_number = key.build.build;
+		header.record_count = static_cast<uint32_t>(source.size());
+		header.field_count = static_cast<uint32_t>(fields.size());
+		header.row_size = row_size;
+
+		// header is rewritten once all offsets are known.
+		write(&header, sizeof(header));
+
+		uint32_t field_index = 0;
+		for (const Field& field : fields) {
+			SnapshotFieldInfo info{ static_cast<uint8_t>(field.type), field.bytes, field.size, SnapshotDetail::packAnnotation(field.annotation), 0 };
+			std::string_view name;
+			if constexpr (TNamedSchema<S>) {
+				name = schema.names()[field_index];
+			}
+			info.name_length = static_cast<uint16_t>(name.size());
+			write(&info, sizeof(info));
+			write(name.data(), name.size());
+			field_index++;
+		}
+
+		std::vector<char> string_heap;
+		std::unordered_map<std::string, uint32_t, SnapshotDetail::StringHash, std::equal_to<>> string_offsets;
+
+		auto store_string = [&](string_data_ref_t str) -> uint32_t {
+			const std::string_view view = str != nullptr ? std::string_view(str) : std::string_view();
+			auto found = string_offsets.find(view);
+			if (found != string_offsets.end()) {
+				return found->second;
+			}
+
+			const auto offset = static_cast<uint32_t>(string_heap.size());
+			const auto length = static_cast<uint32_t>(view.size());
+			string_heap.insert(string_heap.end(), reinterpret_cast<const char*>(&length), reinterpret_cast<const char*>(&length) + sizeof(length));
+			string_heap.insert(string_heap.end(), view.begin(), view.end());
+			string_heap.push_back('\0');
+
+			string_offsets.emplace(view, offset);
+			return offset;
+		};
+
+		store_string(nullptr);
+
+		header.rows_offset = static_cast<uint64_t>(stream.tellp());
+
+		std::vector<uint8_t> row(row_size);
+		std::vector<SnapshotIdIndexEntry> id_index;
+
+		for (uint32_t record_index = 0; record_index < header.record_count; record_index++) {
+			const R record = source[record_index];
+			std::fill(row.begin(), row.end(), 0);
+			row[0] = static_cast<uint8_t>(record.encryptionState);
+
+			if (record.encryptionState != RecordEncryption::ENCRYPTED) {
+				size_t row_offset = sizeof(RecordEncryption);
+				uint32_t element_index = 0;
+				ptrdiff_t view_offset = 0;
+				field_index = 0;
+
+				for (const Field& field : fields) {
+					for (auto z = 0; z < field.size; z++) {
+						schemaFieldHandler(field, [&]<typename T>() {
+							const T& value = R::template extractValue<T>(&record, element_index, view_offset);
+							if constexpr (std::is_same_v<string_data_t, T>) {
+								const uint32_t string_offset = store_string(value.get());
+								memcpy(row.data() + row_offset, &string_offset, sizeof(string_offset));
+								row_offset += sizeof(string_offset);
+							}
+							else {
+								if (id_field_index.has_value() && id_field_index.value() == field_index && z == 0) {
+									id_index.push_back({ static_cast<uint32_t>(value), record_index });
+								}
+
+								memcpy(row.data() + row_offset, &value, sizeof(T));
+								row_offset += sizeof(T);
+							}
+							view_offset += sizeof(T);
+						});
+						element_index++;
+					}
+					field_index++;
+				}
+
+				assert(row_offset == row_size);
+			}
+
+			write(row.data(), row.size());
+		}
+
+		header.strings_offset = static_cast<uint64_t>(stream.tellp());
+		header.strings_size = string_heap.size();
+		write(string_heap.data(), string_heap.size());
+
+		// keep the index aligned so mapped files can be searched in place.
+		const auto index_padding = (sizeof(uint32_t) - (static_cast<uint64_t>(stream.tellp()) % sizeof(uint32_t))) % sizeof(uint32_t);
+		const uint32_t zero = 0;
+		write(&zero, index_padding);
+
+		std::sort(id_index.begin(), id_index.end(), [](const SnapshotIdIndexEntry& a, const SnapshotIdIndexEntry& b) {
+			return a.id < b.id;
+		});
+
+		header.id_index_offset = static_cast<uint64_t>(stream.tellp());
+		header.id_index_count = static_cast<uint32_t>(id_index.size());
+		write(id_index.data(), id_index.size() * sizeof(SnapshotIdIndexEntry));
+
+		const auto end = stream.tellp();
+		stream.seekp(0);
+		write(&header, sizeof(header));
+		stream.seekp(end);
+
+		if (!stream) {
+			throw WDBReaderException("Error writing snapshot.");
+		}
+	}
+
+	/// <summary>
+	/// Reads the key stored in a snapshot, useful to check if a cached snapshot is still valid.
+	/// </summary>
+	template<Filesystem::TFileSource FS>
+	SnapshotKey readSnapshotKey(FS* source)
+	{
+		const auto header = SnapshotDetail::readHeader(source);
+		return SnapshotKey{
+			header.table_hash,
+			header.layout_hash,
+			GameVersion(header.build_expansion, header.build_major, header.build_minor, header.build_number)
+		};
+	}
+
+	/// <summary>
+	/// Reads the schema stored in a snapshot.
+	/// </summary>
+	template<Filesystem::TFileSource FS>
+	RuntimeSchema readSnapshotSchema(FS* source)
+	{
+		const auto header = SnapshotDetail::readHeader(source);
+		return SnapshotDetail::readSchema(source, header);
+	}
+
+	/// <summary>
+	/// Data source reading a previously written snapshot.
+	/// When the file source is memory mapped, rows and the id index are read in place.
+	/// </summary>
+	template<TSchema S, TRecord R, Filesystem::TFileSource FS, TStringStorage SS = HeapStringStorage>
+	class SnapshotFile final : public DataSource<R> {
+	public:
+		SnapshotFile(const S& schema, SS strings = SS()) : _schema(schema), _strings(std::move(strings)), _header{} {}
+		virtual ~SnapshotFile() = default;
+
+		void open(std::unique_ptr<FS> source) {
+			WDBREADER_TRACE_SCOPE("database", "SnapshotFile::open");
+			_file_source = std::move(source);
+			_header = SnapshotDetail::readHeader(_file_source.get());
+
+			const auto stored_schema = SnapshotDetail::readSchema(_file_source.get(), _header);
+			if (!std::ranges::equal(stored_schema.fields(), _schema.fields())) {
+				throw WDBReaderException("Schema doesnt match snapshot.");
+			}
+
+			if (_header.row_size != SnapshotDetail::rowSize(_schema.fields())) {
+				throw WDBReaderException("Snapshot row size doesnt match schema.");
+			}
+
+			// counts are 32 bit, so the region sizes cant overflow.
+			const uint64_t file_size = _file_source->size();
+			if (!SnapshotDetail::fits(_header.rows_offset, static_cast<uint64_t>(_header.record_count) * _header.row_size, file_size) ||
+				!SnapshotDetail::fits(_header.strings_offset, _header.strings_size, file_size) ||
+				!SnapshotDetail::fits(_header.id_index_offset, static_cast<uint64_t>(_header.id_index_count) * sizeof(SnapshotIdIndexEntry), file_size)) {
+				throw WDBReaderException("Snapshot is truncated.");
+			}
+		}
+
+		void load() {
+			WDBREADER_TRACE_SCOPE("database", "SnapshotFile::load");
+			if constexpr (Filesystem::TMappedFileSource<FS>) {
+				_id_index = std::span<const SnapshotIdIndexEntry>(
+					reinterpret_cast<const SnapshotIdIndexEntry*>(_file_source->data() + _header.id_index_offset),
+					_header.id_index_count
+				);
+			}
+			else {
+				_id_index_storage.resize(_header.id_index_count);
+				_file_source->setPos(_header.id_index_offset);
+				_file_source->read(_id_index_storage.data(), _header.id_index_count * sizeof(SnapshotIdIndexEntry));
+				_id_index = _id_index_storage;
+				_row_buffer.resize(_header.row_size);
+			}
+		}
+
+		size_t size() const override {
+			return _header.record_count;
+		}
+
+		DBFormat format() const override {
+			DBFormat format(SNAPSHOT_MAGIC);
+			format.tableHash = _header.table_hash;
+			format.layoutHash = _header.layout_hash;
+			return format;
+		}
+
+		/// <summary>
+		/// IDs from the stored id index, records without an entry (encrypted rows) are given 0.
+		/// </summary>
+		std::vector<uint32_t> recordIds() const override {
+			if (_id_index.empty() && _header.record_count > 0) {
+				return {};
+			}
+
+			std::vector<uint32_t> ids(_header.record_count, 0);
+			for (const auto& entry : _id_index) {
+				if (entry.record_index < ids.size()) {
+					ids[entry.record_index] = entry.id;
+				}
+			}
+			return ids;
+		}
+
+		SnapshotKey key() const {
+			return SnapshotKey{
+				_header.table_hash,
+				_header.layout_hash,
+				GameVersion(_header.build_expansion, _header.build_major, _header.build_minor, _header.build_number)
+			};
+		}
+
+		R operator[](uint32_t index) const override {
+			WDBREADER_TRACE_RECORD_SCOPE("record", "SnapshotFile::operator[]", std::to_string(index));
+			if (index >= _header.record_count) {
+				throw std::out_of_range("Snapshot record index out of range.");
+			}
+
+			const uint8_t* row = readRow(index);
+
+			R record;
+			record.recordIndex = index;
+			record.encryptionState = static_cast<RecordEncryption>(row[0]);
+
+			if (record.encryptionState == RecordEncryption::ENCRYPTED) {
+				return record;
+			}
+
+			R::make(&record, _schema.elementCount(), _header.row_size);
+
+			uint32_t schema_field_index = 0;
+			ptrdiff_t view_offset = 0;
+			size_t row_offset = sizeof(RecordEncryption);
+
+			for (const Field& field : _schema.fields()) {
+				R::insertField(&record, schema_field_index, field.size, view_offset);
+
+				for (auto z = 0; z < field.size; z++) {
+					schemaFieldHandler(field, [&]<typename T>() {
+						if constexpr (std::is_same_v<string_data_t, T>) {
+							uint32_t string_offset;
+							memcpy(&string_offset, row + row_offset, sizeof(string_offset));
+							row_offset += sizeof(string_offset);
+							R::insertValue(&record, schema_field_index, z, view_offset, readString(string_offset));
+						}
+						else {
+							T value;
+							memcpy(&value, row + row_offset, sizeof(T));
+							row_offset += sizeof(T);
+							R::insertValue(&record, schema_field_index, z, view_offset, std::move(value));
+						}
+						view_offset += sizeof(T);
+					});
+				}
+
+				schema_field_index++;
+			}
+
+			return record;
+		}
+
+		/// <summary>
+		/// Finds the record index for an ID, using the stored (sorted) id index.
+		/// </summary>
+		std::optional<uint32_t> findById(uint32_t id) const {
+			const auto found = std::lower_bound(_id_index.begin(), _id_index.end(), id, [](const SnapshotIdIndexEntry& entry, uint32_t val) {
+				return entry.id < val;
+			});
+
+			if (found != _id_index.end() && found->id == id) {
+				return found->record_index;
+			}
+
+			return std::nullopt;
+		}
+
+	protected:
+
+		inline const uint8_t* readRow(uint32_t index) const {
+			const uint64_t offset = _header.rows_offset + (static_cast<uint64_t>(_header.row_size) * index);
+			if constexpr (Filesystem::TMappedFileSource<FS>) {
+				return _file_source->data() + offset;
+			}
+			else {
+				_file_source->setPos(offset);
+				_file_source->read(_row_buffer.data(), _header.row_size);
+				return _row_buffer.data();
+			}
+		}
+
+		inline string_data_t readString(uint32_t string_offset) const {
+			uint32_t length;
+			if (!SnapshotDetail::fits(string_offset, sizeof(length), _header.strings_size)) {
+				throw WDBReaderException("Invalid snapshot string offset.");
+			}
+
+			const uint64_t offset = _header.strings_offset + string_offset;
+			if constexpr (Filesystem::TMappedFileSource<FS>) {
+				memcpy(&length, _file_source->data() + offset, sizeof(length));
+			}
+			else {
+				_file_source->setPos(offset);
+				_file_source->read(&length, sizeof(length));
+			}
+
+			if (!SnapshotDetail::fits(string_offset + sizeof(length), length, _header.strings_size)) {
+				throw WDBReaderException("Invalid snapshot string length.");
+			}
+
+			if constexpr (Filesystem::TMappedFileSource<FS>) {
+				return _strings.store(std::string_view(reinterpret_cast<const char*>(_file_source->data() + offset + sizeof(length)), length));
+			}
+			else {
+				_string_buffer.resize(length);
+				_file_source->read(_string_buffer.data(), length);
+				return _strings.store(_string_buffer);
+			}
+		}
+
+		const S _schema;
+		mutable SS _strings;
+		std::unique_ptr<FS> _file_source;
+		SnapshotHeader _header;
+		std::span<const SnapshotIdIndexEntry> _id_index;
+		std::vector<SnapshotIdIndexEntry> _id_index_storage;
+		mutable std::vector<uint8_t> _row_buffer;
+		mutable std::string _string_buffer;
+	};
+
+}
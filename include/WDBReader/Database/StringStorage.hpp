@@ -0,0 +1,261 @@
+#pragma once
+
+#include "Schema.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace WDBReader::Database {
+
+	template<typename T>
+	concept TStringStorage = requires(T t) {
+		{ t.store(std::string_view()) } -> std::same_as<string_data_t>;
+	};
+
+	/// <summary>
+	/// Creates string data which is owned by the value, and freed when the value is destroyed.
+	/// </summary>
+	inline string_data_t makeStringData(std::string_view str)
+	{
+		auto raw = new char[str.size() + 2];
+		raw[0] = static_cast<char>(StringOwnership::OWNED);
+		memcpy(raw + 1, str.data(), str.size());
+		raw[str.size() + 1] = '\0';
+		return string_data_t(raw + 1);
+	}
+
+	/// <summary>
+	/// Shared empty string, never allocated and never freed.
+	/// </summary>
+	inline string_data_t emptyStringData()
+	{
+		static constexpr char empty[2] = { static_cast<char>(StringOwnership::STORAGE), '\0' };
+		return string_data_t(const_cast<char*>(&empty[1]));
+	}
+
+	/// <summary>
+	/// Default storage, each string is individually allocated.
+	/// </summary>
+	class HeapStringStorage final {
+	public:
+		inline string_data_t store(std::string_view str) {
+			return makeStringData(str);
+		}
+	};
+
+	static_assert(TStringStorage<HeapStringStorage>);
+
+	/// <summary>
+	/// Bump allocator for strings, memory is allocated in large blocks and only released when the arena is reset or destroyed.
+	/// Strings created by the arena must not outlive it.
+	/// </summary>
+	class StringArena final {
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+		StringArena(size_t block_size = DEFAULT_BLOCK_SIZE) :
+			_current(nullptr), _block_size(block_size), _block_pos(0), _bytes_used(0), _bytes_reserved(0)
+		{}
+		StringArena(const StringArena&) = delete;
+		StringArena(StringArena&&) = default;
+		StringArena& operator=(const StringArena&) = delete;
+		StringArena& operator=(StringArena&&) = default;
+
+		string_data_t store(std::string_view str) {
+			if (str.empty()) {
+				return emptyStringData();
+			}
+
+			const size_t required = str.size() + 2; // ownership prefix + null terminator.
+			char* dest = allocate(required);
+			dest[0] = static_cast<char>(StringOwnership::STORAGE);
+			memcpy(dest + 1, str.data(), str.size());
+			dest[str.size() + 1] = '\0';
+			_bytes_used += required;
+
+			return string_data_t(dest + 1);
+		}
+
+		/// <summary>
+		/// Releases all blocks, any strings previously created become invalid.
+		/// </summary>
+		void reset() {
+			_blocks.clear();
+			_current = nullptr;
+			_block_pos = 0;
+			_bytes_used = 0;
+			_bytes_reserved = 0;
+		}
+
+		inline size_t blockCount() const {
+			return _blocks.size();
+		}
+
+		inline size_t bytesUsed() const {
+			return _bytes_used;
+		}
+
+		inline size_t bytesReserved() const {
+			return _bytes_reserved;
+		}
+
+	protected:
+		char* allocate(size_t bytes) {
+			if (bytes > _block_size) {
+				// oversized strings get a dedicated block, keeping the current block available.
+				_blocks.push_back(std::make_unique_for_overwrite<char[]>(bytes));
+				_bytes_reserved += bytes;
+				return _blocks.back().get();
+			}
+
+			if (_current == nullptr || _block_pos + bytes > _block_size) {
+				_blocks.push_back(std::make_unique_for_overwrite<char[]>(_block_size));
+				_current = _blocks.back().get();
+				_block_pos = 0;
+				_bytes_reserved += _block_size;
+			}
+
+			char* dest = _current + _block_pos;
+			_block_pos += bytes;
+			return dest;
+		}
+
+		std::vector<std::unique_ptr<char[]>> _blocks;
+		char* _current;
+		size_t _block_size;
+		size_t _block_pos;
+		size_t _bytes_used;
+		size_t _bytes_reserved;
+	};
+
+	/// <summary>
+	/// Arena backed storage, the arena can be shared between multiple files to release a whole batch together.
+	/// </summary>
+	class ArenaStringStorage final {
+	public:
+		ArenaStringStorage() : _arena(std::make_shared<StringArena>()) {}
+		ArenaStringStorage(std::shared_ptr<StringArena> arena) : _arena(std::move(arena))
+		{
+			assert(_arena != nullptr);
+		}
+
+		inline string_data_t store(std::string_view str) {
+			return _arena->store(str);
+		}
+
+		inline const std::shared_ptr<StringArena>& arena() const {
+			return _arena;
+		}
+
+	protected:
+		std::shared_ptr<StringArena> _arena;
+	};
+
+	static_assert(TStringStorage<ArenaStringStorage>);
+
+	/// <summary>
+	/// Thread safe pool of unique strings, intended to be shared between multiple data sources.
+	/// Interned strings are deduplicated by content and remain valid for the lifetime of the pool.
+	/// </summary>
+	class StringInternPool final {
+	public:
+		struct Stats {
+			size_t lookups;			// total intern requests (including empty strings).
+			size_t emptyLookups;	// requests for empty strings, these never allocate.
+			size_t uniqueStrings;
+			size_t uniqueBytes;		// bytes used by unique strings (including terminators).
+			size_t savedBytes;		// bytes which would have been allocated without deduplication.
+			size_t reservedBytes;	// total bytes allocated by the pool.
+		};
+
+		StringInternPool(size_t block_size = StringArena::DEFAULT_BLOCK_SIZE) : 
+			_arena(block_size), _lookups(0), _empty_lookups(0), _saved_bytes(0)
+		{}
+		StringInternPool(const StringInternPool&) = delete;
+		StringInternPool& operator=(const StringInternPool&) = delete;
+
+		/// <summary>
+		/// Returns a stable, null terminated view matching the input.
+		/// </summary>
+		std::string_view intern(std::string_view str) {
+			return internData(str);
+		}
+
+		string_data_t store(std::string_view str) {
+			return string_data_t(const_cast<char*>(internData(str).data()));
+		}
+
+		Stats stats() const {
+			std::scoped_lock lock(_mutex);
+			return {
+				_lookups.load(),
+				_empty_lookups.load(),
+				_strings.size(),
+				_arena.bytesUsed(),
+				_saved_bytes,
+				_arena.bytesReserved()
+			};
+		}
+
+	protected:
+		std::string_view internData(std::string_view str) {
+			_lookups++;
+
+			if (str.empty()) {
+				_empty_lookups++;
+				return std::string_view(emptyStringData().release(), 0);
+			}
+
+			std::scoped_lock lock(_mutex);
+			auto found = _strings.find(str);
+			if (found != _strings.end()) {
+				_saved_bytes += str.size() + 2;
+				return *found;
+			}
+
+			// arena data is never freed individually, so releasing ownership is safe.
+			const char* data = _arena.store(str).release();
+			const auto inserted = _strings.emplace(data, str.size());
+			return *inserted.first;
+		}
+
+		mutable std::mutex _mutex;
+		StringArena _arena;
+		std::unordered_set<std::string_view> _strings;
+		std::atomic<size_t> _lookups;
+		std::atomic<size_t> _empty_lookups;
+		size_t _saved_bytes;
+	};
+
+	/// <summary>
+	/// Interned storage, values are deduplicated across every data source sharing the same pool.
+	/// Records must not outlive the pool.
+	/// </summary>
+	class InternedStringStorage final {
+	public:
+		InternedStringStorage() : _pool(std::make_shared<StringInternPool>()) {}
+		InternedStringStorage(std::shared_ptr<StringInternPool> pool) : _pool(std::move(pool))
+		{
+			assert(_pool != nullptr);
+		}
+
+		inline string_data_t store(std::string_view str) {
+			return _pool->store(str);
+		}
+
+		inline const std::shared_ptr<StringInternPool>& pool() const {
+			return _pool;
+		}
+
+	protected:
+		std::shared_ptr<StringInternPool> _pool;
+	};
+
+	static_assert(TStringStorage<InternedStringStorage>);
+}
@@ -0,0 +1,975 @@
+#pragma once
+
+#include "../Database.hpp"
+#include "DB2File.hpp"
+#include "DBCFile.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+/*
+	Writes db files from a runtime schema and row data, mainly for generating test and benchmark corpora.
+	Only layouts the readers understand are produced, so the output can always be opened with DB2File / DBCFile.
+*/
+
+namespace WDBReader::Database {
+
+	/// <summary>
+	/// Single element of a row. Integers are truncated to the field size, signed values should be cast from their signed type.
+	/// </summary>
+	using writer_value_t = std::variant<uint64_t, float, std::string>;
+
+	/// <summary>
+	/// Elements of a row, in the same order as RuntimeRecord data (one element per array entry).
+	/// </summary>
+	using writer_row_t = std::vector<writer_value_t>;
+
+	/// <summary>
+	/// Fills the row for a record index. Rows are requested more than once, so the provider must be deterministic.
+	/// </summary>
+	using writer_row_provider_t = std::function<void(uint32_t index, writer_row_t& row)>;
+
+	struct DB2WriterOptions {
+	public:
+		uint32_t tableHash = 0;
+		uint32_t layoutHash = 0;
+		uint32_t locale = 0;
+		uint32_t build = 0;									// WDB2 only.
+
+		/// <summary>
+		/// Compression per schema field, missing entries are None. WDC3+ only.
+		/// Floats and strings are always uncompressed, arrays only support BitpackedIndexedArray.
+		/// </summary>
+		std::vector<DB2FieldCompression> compression;
+
+		bool sparse = false;								// offset map records with inline strings, WDC3+ only.
+		std::vector<uint32_t> sections;						// record count of each section, empty for a single section. WDC3+ only.
+		std::vector<WDC3CopyTableEntry> copyTable;			// requires a non inline id. WDC3+ only.
+	};
+
+	struct DBCWriterOptions {
+	public:
+		DBCVersion version = DBCVersion::CATA_PLUS;
+		DBCStringLocale locale = DBCStringLocale::ANY;		// slot lang strings are written to, other locales are empty.
+	};
+
+	namespace WriterDetail {
+
+		inline uint64_t intValue(const writer_value_t& value) {
+			if (const auto* val = std::get_if<uint64_t>(&value)) {
+				return *val;
+			}
+			throw WDBReaderException("Expected integer value.");
+		}
+
+		inline float floatValue(const writer_value_t& value) {
+			if (const auto* val = std::get_if<float>(&value)) {
+				return *val;
+			}
+			throw WDBReaderException("Expected float value.");
+		}
+
+		inline const std::string& stringValue(const writer_value_t& value) {
+			if (const auto* val = std::get_if<std::string>(&value)) {
+				return *val;
+			}
+			throw WDBReaderException("Expected string value.");
+		}
+
+		inline constexpr bool isString(const Field& field) {
+			return field.type == Field::Type::STRING || field.type == Field::Type::LANG_STRING;
+		}
+
+		inline uint64_t truncate(uint64_t value, uint8_t bytes) {
+			return bytes >= sizeof(uint64_t) ? value : value & ((uint64_t(1) << (bytes * 8)) - 1);
+		}
+
+		inline int64_t signExtend(uint64_t value, uint8_t bytes) {
+			const uint32_t shift = 64 - (bytes * 8);
+			return static_cast<int64_t>(value << shift) >> shift;
+		}
+
+		inline uint32_t bitWidth(uint64_t max_value) {
+			return std::max<uint32_t>(1, static_cast<uint32_t>(std::bit_width(max_value)));
+		}
+
+		inline uint32_t signedBitWidth(int64_t value) {
+			const uint64_t magnitude = value < 0 ? ~static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+			return static_cast<uint32_t>(std::bit_width(magnitude)) + 1;
+		}
+
+		inline void writeBits(uint8_t* dest, uint32_t bit_offset, uint32_t bit_width, uint64_t value) {
+			uint32_t written = 0;
+			while (written < bit_width) {
+				const uint32_t pos = bit_offset + written;
+				const uint32_t shift = pos & 7;
+				const uint32_t count = std::min(8 - shift, bit_width - written);
+				const uint8_t bits = static_cast<uint8_t>((value >> written) & ((1u << count) - 1));
+				dest[pos / 8] |= static_cast<uint8_t>(bits << shift);
+				written += count;
+			}
+		}
+
+		template<typename T>
+		inline void writePod(std::ostream& out, const T& value) {
+			out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template<typename T>
+		inline void writeSpan(std::ostream& out, const T* values, size_t count) {
+			if (count > 0) {
+				out.write(reinterpret_cast<const char*>(values), sizeof(T) * count);
+			}
+		}
+
+		inline void appendValue(std::vector<uint8_t>& buffer, const void* value, size_t bytes) {
+			const auto* begin = static_cast<const uint8_t*>(value);
+			buffer.insert(buffer.end(), begin, begin + bytes);
+		}
+
+		/// <summary>
+		/// Appends a non string element unpacked, as read by the WDBC, WDB2 and sparse loaders.
+		/// </summary>
+		inline void appendElement(std::vector<uint8_t>& buffer, const Field& field, const writer_value_t& value) {
+			if (field.type == Field::Type::FLOAT) {
+				const float val = floatValue(value);
+				appendValue(buffer, &val, sizeof(val));
+			}
+			else {
+				const uint64_t val = intValue(value);
+				appendValue(buffer, &val, field.bytes);
+			}
+		}
+
+		inline void checkRow(const RuntimeSchema& schema, const writer_row_t& row) {
+			if (row.size() != schema.elementCount()) {
+				throw WDBReaderException("Row element count doesnt match schema.");
+			}
+		}
+
+		/// <summary>
+		/// Deduplicated, null terminated string block.
+		/// </summary>
+		class StringTable {
+		public:
+			StringTable(bool leading_empty = false) {
+				if (leading_empty) {
+					add("");
+				}
+			}
+
+			uint32_t add(const std::string& str) {
+				auto found = _offsets.find(str);
+				if (found != _offsets.end()) {
+					return found->second;
+				}
+
+				const auto offset = static_cast<uint32_t>(_data.size());
+				_data.append(str);
+				_data.push_back('\0');
+				_offsets.emplace(str, offset);
+				return offset;
+			}
+
+			uint32_t find(const std::string& str) const {
+				return _offsets.at(str);
+			}
+
+			const std::string& data() const {
+				return _data;
+			}
+
+		private:
+			std::string _data;
+			std::unordered_map<std::string, uint32_t> _offsets;
+		};
+
+		template<TDB2FormatModern F>
+		void writeModern(std::ostream& out, const RuntimeSchema& schema, uint32_t record_count, const writer_row_provider_t& rows, const DB2WriterOptions& options) {
+			const auto& fields = schema.fields();
+			const bool use_id_list = fields.size() > 0 && fields[0].annotation.isId && !fields[0].annotation.isInline;
+
+			if (!options.copyTable.empty() && !use_id_list) {
+				throw WDBReaderException("Copy tables require a non inline id.");
+			}
+
+			std::vector<uint32_t> sections = options.sections;
+			if (sections.empty()) {
+				sections.push_back(record_count);
+			}
+
+			if (std::accumulate(sections.begin(), sections.end(), uint64_t(0)) != record_count) {
+				throw WDBReaderException("Section record counts dont match record count.");
+			}
+
+			struct Column {
+				uint32_t schemaIndex;
+				uint32_t elementOffset;
+				DB2FieldCompression compression;
+				typename F::FieldStorageInfo storage;
+				uint64_t maxValue;
+				int64_t minSigned;
+				int64_t maxSigned;
+				std::unordered_map<uint32_t, uint32_t> pallet;				// BitpackedIndexed, value -> pallet index.
+				std::map<std::vector<uint32_t>, uint32_t> arrayPallet;		// BitpackedIndexedArray, values -> pallet index.
+				std::vector<uint32_t> palletKey;
+				std::vector<uint32_t> commonValues;
+				uint32_t commonDefault;
+
+				uint32_t palletIndex(const Field& field, const writer_row_t& row, bool insert) {
+					if (compression == DB2FieldCompression::BitpackedIndexed) {
+						const auto value = static_cast<uint32_t>(truncate(intValue(row[elementOffset]), field.bytes));
+						if (insert) {
+							return pallet.emplace(value, static_cast<uint32_t>(pallet.size())).first->second;
+						}
+						return pallet.at(value);
+					}
+
+					palletKey.resize(field.size);
+					for (uint32_t z = 0; z < field.size; z++) {
+						palletKey[z] = static_cast<uint32_t>(truncate(intValue(row[elementOffset + z]), field.bytes));
+					}
+
+					if (insert) {
+						return arrayPallet.emplace(palletKey, 0).first->second;
+					}
+					return arrayPallet.at(palletKey);
+				}
+			};
+
+			std::vector<Column> columns;
+			std::optional<uint32_t> relation_element;
+			uint32_t id_element = 0;
+			bool has_id = use_id_list;
+			{
+				uint32_t element_offset = 0;
+				for (uint32_t i = 0; i < fields.size(); i++) {
+					const Field& field = fields[i];
+
+					if (field.annotation.isInline) {
+						Column column{};
+						column.schemaIndex = i;
+						column.elementOffset = element_offset;
+						column.compression = i < options.compression.size() ? options.compression[i] : DB2FieldCompression::None;
+						column.minSigned = std::numeric_limits<int64_t>::max();
+						column.maxSigned = std::numeric_limits<int64_t>::min();
+
+						const bool packed = column.compression != DB2FieldCompression::None;
+						if (packed && (options.sparse || field.type != Field::Type::INT)) {
+							throw WDBReaderException("Field compression not supported for field.");
+						}
+
+						if (packed && field.isArray() != (column.compression == DB2FieldCompression::BitpackedIndexedArray)) {
+							throw WDBReaderException("Arrays must use indexed array compression.");
+						}
+
+						if ((column.compression == DB2FieldCompression::CommonData ||
+							column.compression == DB2FieldCompression::BitpackedIndexed ||
+							column.compression == DB2FieldCompression::BitpackedIndexedArray) && field.bytes > sizeof(uint32_t)) {
+							throw WDBReaderException("Pallet and common values are limited to 32 bits.");
+						}
+
+						// common data is looked up by id, which the reader only knows once the id field has been read.
+						if (column.compression == DB2FieldCompression::CommonData && !has_id) {
+							throw WDBReaderException("Common data requires a preceding id field.");
+						}
+
+						if (field.annotation.isId && !has_id) {
+							has_id = true;
+							id_element = element_offset;
+						}
+
+						columns.push_back(std::move(column));
+					}
+					else if (field.annotation.isRelation && i + 1 == fields.size()) {
+						if (field.type != Field::Type::INT || field.isArray() || options.sparse) {
+							throw WDBReaderException("Unsupported relation field.");
+						}
+						relation_element = element_offset;
+					}
+					else if (i != 0 || !use_id_list) {
+						throw WDBReaderException("Unsupported non inline field.");
+					}
+
+					element_offset += field.size;
+				}
+			}
+
+			// first pass, collect strings, pallets and value ranges.
+
+			DynArray<uint32_t> ids(record_count);
+			DynArray<uint32_t> relations(relation_element.has_value() ? record_count : 0);
+			std::vector<StringTable> strings(sections.size());
+			std::vector<uint16_t> sparse_sizes;
+			writer_row_t row;
+			row.reserve(schema.elementCount());
+
+			for (uint32_t section_index = 0, index = 0; section_index < sections.size(); section_index++) {
+				for (const uint32_t end = index + sections[section_index]; index < end; index++) {
+					row.clear();
+					rows(index, row);
+					checkRow(schema, row);
+
+					ids[index] = has_id ? static_cast<uint32_t>(intValue(row[id_element])) : index;
+					if (relation_element.has_value()) {
+						relations[index] = static_cast<uint32_t>(intValue(row[*relation_element]));
+					}
+
+					uint64_t sparse_size = 0;
+
+					for (auto& column : columns) {
+						const Field& field = fields[column.schemaIndex];
+
+						for (uint32_t z = 0; z < field.size; z++) {
+							const auto& value = row[column.elementOffset + z];
+							if (isString(field)) {
+								if (options.sparse) {
+									sparse_size += stringValue(value).size() + 1;
+								}
+								else {
+									strings[section_index].add(stringValue(value));
+								}
+							}
+							else {
+								sparse_size += field.bytes;
+							}
+						}
+
+						switch (column.compression) {
+						case DB2FieldCompression::None:
+							if (field.type == Field::Type::FLOAT) {
+								floatValue(row[column.elementOffset]);
+							}
+							break;
+						case DB2FieldCompression::Bitpacked:
+							column.maxValue = std::max(column.maxValue, truncate(intValue(row[column.elementOffset]), field.bytes));
+							break;
+						case DB2FieldCompression::BitpackedSigned:
+						{
+							const auto value = signExtend(intValue(row[column.elementOffset]), field.bytes);
+							column.minSigned = std::min(column.minSigned, value);
+							column.maxSigned = std::max(column.maxSigned, value);
+						}
+							break;
+						case DB2FieldCompression::BitpackedIndexed:
+						case DB2FieldCompression::BitpackedIndexedArray:
+							column.palletIndex(field, row, true);
+							break;
+						case DB2FieldCompression::CommonData:
+							column.commonValues.push_back(static_cast<uint32_t>(truncate(intValue(row[column.elementOffset]), field.bytes)));
+							break;
+						}
+					}
+
+					if (options.sparse) {
+						if (sparse_size > std::numeric_limits<uint16_t>::max()) {
+							throw WDBReaderException("Sparse record too large.");
+						}
+						sparse_sizes.push_back(static_cast<uint16_t>(sparse_size));
+					}
+				}
+			}
+
+			// record layout, unpacked fields first followed by the bitpacked block.
+
+			uint32_t unpacked_bytes = 0;
+			for (auto& column : columns) {
+				const Field& field = fields[column.schemaIndex];
+				if (column.compression == DB2FieldCompression::None) {
+					const uint32_t element_bytes = isString(field) ? sizeof(string_ref_t) : field.bytes;
+					column.storage.field_offset_bits = static_cast<uint16_t>(unpacked_bytes * 8);
+					column.storage.field_size_bits = static_cast<uint16_t>(element_bytes * field.size * 8);
+					unpacked_bytes += element_bytes * field.size;
+				}
+			}
+
+			uint32_t packed_bits = 0;
+			uint32_t last_packed_byte = 0;
+			bool has_packed = false;
+			uint32_t pallet_data_size = 0;
+			uint32_t common_data_size = 0;
+
+			for (auto& column : columns) {
+				const Field& field = fields[column.schemaIndex];
+				auto& storage = column.storage;
+				storage.compression_type = column.compression;
+
+				switch (column.compression) {
+				case DB2FieldCompression::Bitpacked:
+				case DB2FieldCompression::BitpackedSigned:
+				{
+					const bool is_signed = column.compression == DB2FieldCompression::BitpackedSigned;
+					storage.compression_data.bitpacked.bit_offset = packed_bits;
+					storage.compression_data.bitpacked.bit_width = is_signed ?
+						std::max({ 1u, signedBitWidth(column.minSigned), signedBitWidth(column.maxSigned) }) :
+						bitWidth(column.maxValue);
+					storage.compression_data.bitpacked.is_signed = is_signed;
+
+					if (record_count == 0 && is_signed) {
+						storage.compression_data.bitpacked.bit_width = 1;
+					}
+				}
+					break;
+				case DB2FieldCompression::BitpackedIndexed:
+				case DB2FieldCompression::BitpackedIndexedArray:
+				{
+					size_t pallet_count = column.pallet.size();
+					if (column.compression == DB2FieldCompression::BitpackedIndexedArray) {
+						// sorted pallet, so the output doesnt depend on row order.
+						uint32_t pallet_index = 0;
+						for (auto& [key, index] : column.arrayPallet) {
+							index = pallet_index++;
+						}
+						pallet_count = column.arrayPallet.size();
+					}
+
+					storage.compression_data.pallet.bit_offset = packed_bits;
+					storage.compression_data.pallet.bit_width = bitWidth(pallet_count > 0 ? pallet_count - 1 : 0);
+					storage.compression_data.pallet.array_size = column.compression == DB2FieldCompression::BitpackedIndexedArray ? field.size : 0;
+					storage.additional_data_size = static_cast<uint32_t>(pallet_count * field.size * sizeof(typename F::PalletValue));
+					pallet_data_size += storage.additional_data_size;
+				}
+					break;
+				case DB2FieldCompression::CommonData:
+				{
+					std::unordered_map<uint32_t, uint32_t> frequency;
+					for (const auto value : column.commonValues) {
+						frequency[value]++;
+					}
+
+					const auto most_common = std::max_element(frequency.begin(), frequency.end(), [](const auto& a, const auto& b) {
+						return a.second < b.second || (a.second == b.second && a.first > b.first);
+					});
+
+					column.commonDefault = most_common != frequency.end() ? most_common->first : 0;
+					const size_t exceptions = column.commonValues.size() - (most_common != frequency.end() ? most_common->second : 0);
+
+					storage.compression_data.common_data.default_value = column.commonDefault;
+					storage.additional_data_size = static_cast<uint32_t>(exceptions * sizeof(typename F::CommonValue));
+					storage.field_offset_bits = static_cast<uint16_t>(unpacked_bytes * 8);
+					common_data_size += storage.additional_data_size;
+				}
+					break;
+				default:
+					break;
+				}
+
+				if (column.compression != DB2FieldCompression::None && column.compression != DB2FieldCompression::CommonData) {
+					const uint32_t bit_offset = storage.compression_data.raw.val1;
+					const uint32_t bit_width = storage.compression_data.raw.val2;
+
+					// the reader extracts values from a single 64 bit load.
+					if (bit_width > 57) {
+						throw WDBReaderException("Bitpacked field too wide.");
+					}
+
+					storage.field_offset_bits = static_cast<uint16_t>(unpacked_bytes * 8 + bit_offset);
+					storage.field_size_bits = static_cast<uint16_t>(bit_width);
+					last_packed_byte = bit_offset / 8;
+					packed_bits += bit_width;
+					has_packed = true;
+				}
+			}
+
+			if (unpacked_bytes * 8 + packed_bits > std::numeric_limits<uint16_t>::max()) {
+				throw WDBReaderException("Record too large.");
+			}
+
+			// every packed value is read with a 64 bit load, padding keeps those loads inside the record.
+			uint32_t record_size = options.sparse ? 0 : unpacked_bytes + ((packed_bits + 7) / 8);
+			if (has_packed) {
+				record_size = std::max(record_size, unpacked_bytes + last_packed_byte + static_cast<uint32_t>(sizeof(uint64_t)));
+			}
+
+			// file layout.
+
+			typename F::Header header{};
+			header.signature = F::signature.integer;
+			if constexpr (requires { header.versionNum; }) {
+				header.versionNum = 5;
+			}
+			header.record_count = record_count;
+			header.field_count = static_cast<uint32_t>(columns.size());
+			header.record_size = record_size;
+			header.table_hash = options.tableHash;
+			header.layout_hash = options.layoutHash;
+			header.locale = options.locale;
+			header.flags = static_cast<uint16_t>(
+				(options.sparse ? DB2HeaderFlags::HasOffsetMap : 0) |
+				(use_id_list ? DB2HeaderFlags::HasNonInlineIds : 0) |
+				(has_packed ? DB2HeaderFlags::IsBitpacked : 0)
+			);
+			header.total_field_count = header.field_count;
+			header.bitpacked_data_offset = unpacked_bytes;
+			header.lookup_column_count = relation_element.has_value() ? 1 : 0;
+			header.field_storage_info_size = static_cast<uint32_t>(columns.size() * sizeof(typename F::FieldStorageInfo));
+			header.common_data_size = common_data_size;
+			header.pallet_data_size = pallet_data_size;
+			header.section_count = static_cast<uint32_t>(sections.size());
+
+			for (uint32_t i = 0; i < columns.size(); i++) {
+				if (fields[columns[i].schemaIndex].annotation.isId) {
+					header.id_index = static_cast<uint16_t>(i);
+				}
+			}
+
+			if (record_count > 0) {
+				header.min_id = *std::min_element(ids.get(), ids.get() + record_count);
+				header.max_id = *std::max_element(ids.get(), ids.get() + record_count);
+				for (const auto& copy : options.copyTable) {
+					header.min_id = std::min(header.min_id, copy.id_of_new_row);
+					header.max_id = std::max(header.max_id, copy.id_of_new_row);
+				}
+			}
+
+			struct RelationshipHeader {
+				uint32_t count;
+				uint32_t min_id;
+				uint32_t max_id;
+			};
+
+			std::vector<typename F::SectionHeader> section_headers(sections.size());
+			uint64_t position = sizeof(header) +
+				(sizeof(typename F::SectionHeader) * sections.size()) +
+				(sizeof(typename F::FieldStructure) * columns.size()) +
+				header.field_storage_info_size +
+				pallet_data_size +
+				common_data_size;
+
+			for (uint32_t section_index = 0, index = 0; section_index < sections.size(); section_index++) {
+				auto& section = section_headers[section_index];
+				const uint32_t count = sections[section_index];
+
+				section.file_offset = static_cast<uint32_t>(position);
+				section.record_count = count;
+
+				if (options.sparse) {
+					for (uint32_t i = index; i < index + count; i++) {
+						position += sparse_sizes[i];
+					}
+					section.offset_records_end = static_cast<uint32_t>(position);
+					section.offset_map_id_count = count;
+				}
+				else {
+					section.string_table_size = static_cast<uint32_t>(strings[section_index].data().size());
+					position += (uint64_t(count) * record_size) + section.string_table_size;
+					header.string_table_size += section.string_table_size;
+				}
+
+				section.id_list_size = use_id_list ? count * sizeof(uint32_t) : 0;
+				section.copy_table_count = section_index == 0 ? static_cast<uint32_t>(options.copyTable.size()) : 0;
+				section.relationship_data_size = relation_element.has_value() ?
+					static_cast<uint32_t>(sizeof(RelationshipHeader) + (count * sizeof(typename F::RelationshipEntry))) : 0;
+
+				position += section.id_list_size;
+				position += section.copy_table_count * sizeof(typename F::CopyTableEntry);
+				position += section.offset_map_id_count * (sizeof(typename F::OffsetMapEntry) + sizeof(uint32_t));
+				position += section.relationship_data_size;
+
+				if (position > std::numeric_limits<uint32_t>::max()) {
+					throw WDBReaderException("File too large for format.");
+				}
+
+				index += count;
+			}
+
+			writePod(out, header);
+			writeSpan(out, section_headers.data(), section_headers.size());
+
+			for (const auto& column : columns) {
+				const Field& field = fields[column.schemaIndex];
+				typename F::FieldStructure structure{};
+				structure.size = static_cast<int16_t>(32 - ((isString(field) ? sizeof(string_ref_t) : field.bytes) * 8));
+				structure.position = static_cast<uint16_t>(column.storage.field_offset_bits / 8);
+				writePod(out, structure);
+			}
+
+			for (const auto& column : columns) {
+				writePod(out, column.storage);
+			}
+
+			for (const auto& column : columns) {
+				if (column.compression == DB2FieldCompression::BitpackedIndexed) {
+					std::vector<uint32_t> ordered(column.pallet.size());
+					for (const auto& [value, index] : column.pallet) {
+						ordered[index] = value;
+					}
+					writeSpan(out, ordered.data(), ordered.size());
+				}
+				else if (column.compression == DB2FieldCompression::BitpackedIndexedArray) {
+					for (const auto& [values, index] : column.arrayPallet) {
+						writeSpan(out, values.data(), values.size());
+					}
+				}
+			}
+
+			for (const auto& column : columns) {
+				if (column.compression == DB2FieldCompression::CommonData) {
+					for (uint32_t index = 0; index < record_count; index++) {
+						if (column.commonValues[index] != column.commonDefault) {
+							writePod(out, typename F::CommonValue{ ids[index], column.commonValues[index] });
+						}
+					}
+				}
+			}
+
+			// second pass, sections.
+
+			// string refs are relative to the field, the reader removes the size of the records outside the first section.
+			const uint64_t string_ref_adjust = uint64_t(record_count - sections[0]) * record_size;
+
+			std::vector<uint8_t> buffer;
+			std::vector<typename F::OffsetMapEntry> offset_map;
+
+			for (uint32_t section_index = 0, index = 0; section_index < sections.size(); section_index++) {
+				const auto& section = section_headers[section_index];
+				const auto& section_strings = strings[section_index];
+				const uint32_t section_start = index;
+				const uint64_t string_table_pos = section.file_offset + (uint64_t(section.record_count) * record_size);
+				uint64_t record_pos = section.file_offset;
+
+				offset_map.clear();
+
+				for (const uint32_t end = index + section.record_count; index < end; index++) {
+					row.clear();
+					rows(index, row);
+					checkRow(schema, row);
+
+					if (options.sparse) {
+						buffer.clear();
+						for (const auto& column : columns) {
+							const Field& field = fields[column.schemaIndex];
+							for (uint32_t z = 0; z < field.size; z++) {
+								const auto& value = row[column.elementOffset + z];
+								if (isString(field)) {
+									const auto& str = stringValue(value);
+									appendValue(buffer, str.c_str(), str.size() + 1);
+								}
+								else {
+									appendElement(buffer, field, value);
+								}
+							}
+						}
+
+						assert(buffer.size() == sparse_sizes[index]);
+						offset_map.push_back({ static_cast<uint32_t>(record_pos), sparse_sizes[index] });
+						out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+						record_pos += buffer.size();
+						continue;
+					}
+
+					buffer.assign(record_size, 0);
+					uint8_t* const packed_data = buffer.data() + unpacked_bytes;
+
+					for (auto& column : columns) {
+						const Field& field = fields[column.schemaIndex];
+						const auto& storage = column.storage;
+						uint8_t* const field_data = buffer.data() + (storage.field_offset_bits / 8);
+
+						switch (column.compression) {
+						case DB2FieldCompression::None:
+							for (uint32_t z = 0; z < field.size; z++) {
+								const auto& value = row[column.elementOffset + z];
+								if (isString(field)) {
+									const uint64_t string_pos = string_table_pos + section_strings.find(stringValue(value));
+									const auto ref = static_cast<string_ref_t>(string_pos - (record_pos + (storage.field_offset_bits / 8)) + string_ref_adjust);
+									memcpy(field_data + (sizeof(ref) * z), &ref, sizeof(ref));
+								}
+								else if (field.type == Field::Type::FLOAT) {
+									const float val = floatValue(value);
+									memcpy(field_data + (sizeof(val) * z), &val, sizeof(val));
+								}
+								else {
+									const uint64_t val = intValue(value);
+									memcpy(field_data + (field.bytes * z), &val, field.bytes);
+								}
+							}
+							break;
+						case DB2FieldCompression::Bitpacked:
+							writeBits(packed_data, storage.compression_data.bitpacked.bit_offset, storage.compression_data.bitpacked.bit_width,
+								truncate(intValue(row[column.elementOffset]), field.bytes));
+							break;
+						case DB2FieldCompression::BitpackedSigned:
+							writeBits(packed_data, storage.compression_data.bitpacked.bit_offset, storage.compression_data.bitpacked.bit_width,
+								static_cast<uint64_t>(signExtend(intValue(row[column.elementOffset]), field.bytes)));
+							break;
+						case DB2FieldCompression::BitpackedIndexed:
+						case DB2FieldCompression::BitpackedIndexedArray:
+							writeBits(packed_data, storage.compression_data.pallet.bit_offset, storage.compression_data.pallet.bit_width,
+								column.palletIndex(field, row, false));
+							break;
+						default:
+							break;
+						}
+					}
+
+					out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+					record_pos += buffer.size();
+				}
+
+				if (!options.sparse) {
+					out.write(section_strings.data().data(), section_strings.data().size());
+				}
+
+				if (use_id_list) {
+					writeSpan(out, ids.get() + section_start, section.record_count);
+				}
+
+				if (section_index == 0) {
+					writeSpan(out, options.copyTable.data(), options.copyTable.size());
+				}
+
+				if (options.sparse) {
+					writeSpan(out, offset_map.data(), offset_map.size());
+				}
+
+				if (relation_element.has_value()) {
+					RelationshipHeader relation_header{ section.record_count, 0, 0 };
+					if (section.record_count > 0) {
+						const auto [min_id, max_id] = std::minmax_element(relations.get() + section_start, relations.get() + index);
+						relation_header.min_id = *min_id;
+						relation_header.max_id = *max_id;
+					}
+					writePod(out, relation_header);
+
+					for (uint32_t i = section_start; i < index; i++) {
+						// record index is the position across all sections.
+						writePod(out, typename F::RelationshipEntry{ relations[i], i });
+					}
+				}
+
+				if (options.sparse) {
+					writeSpan(out, ids.get() + section_start, section.record_count);
+				}
+			}
+		}
+
+		inline void writeWDB2(std::ostream& out, const RuntimeSchema& schema, uint32_t record_count, const writer_row_provider_t& rows, const DB2WriterOptions& options) {
+			const auto& fields = schema.fields();
+			const uint32_t record_size = static_cast<uint32_t>(DB2FormatWDB2::recordSizeSrc(schema));
+
+			std::optional<uint32_t> id_element;
+			{
+				uint32_t element_offset = 0;
+				for (const auto& field : fields) {
+					if (field.annotation.isId && !id_element.has_value()) {
+						id_element = element_offset;
+					}
+					element_offset += field.size;
+				}
+			}
+
+			StringTable strings(true);
+			std::vector<uint32_t> ids;
+			writer_row_t row;
+
+			for (uint32_t index = 0; index < record_count; index++) {
+				row.clear();
+				rows(index, row);
+				checkRow(schema, row);
+
+				if (id_element.has_value()) {
+					ids.push_back(static_cast<uint32_t>(intValue(row[*id_element])));
+				}
+
+				uint32_t element = 0;
+				for (const auto& field : fields) {
+					for (uint32_t z = 0; z < field.size; z++, element++) {
+						if (isString(field)) {
+							strings.add(stringValue(row[element]));
+						}
+					}
+				}
+			}
+
+			DB2FileFormatWDB2::Header header{};
+			header.signature = DB2FileFormatWDB2::signature.integer;
+			header.record_count = record_count;
+			header.field_count = static_cast<uint32_t>(DB2FormatWDB2::elementCountSrc(schema));
+			header.record_size = record_size;
+			header.string_table_size = static_cast<uint32_t>(strings.data().size());
+			header.table_hash = options.tableHash;
+			header.build = options.build;
+			header.locale = options.locale;
+
+			if (!ids.empty()) {
+				header.min_id = *std::min_element(ids.begin(), ids.end());
+				header.max_id = *std::max_element(ids.begin(), ids.end());
+			}
+
+			writePod(out, header);
+
+			if (header.max_id != 0) {
+				// id index, followed by the string length table (unused by the reader).
+				const uint32_t id_range = header.max_id - header.min_id + 1;
+				std::vector<uint32_t> index_table(id_range, 0);
+				for (uint32_t i = 0; i < ids.size(); i++) {
+					index_table[ids[i] - header.min_id] = i;
+				}
+				writeSpan(out, index_table.data(), index_table.size());
+
+				const std::vector<uint16_t> string_lengths(id_range, 0);
+				writeSpan(out, string_lengths.data(), string_lengths.size());
+			}
+
+			std::vector<uint8_t> buffer;
+			for (uint32_t index = 0; index < record_count; index++) {
+				row.clear();
+				rows(index, row);
+				buffer.clear();
+
+				uint32_t element = 0;
+				for (const auto& field : fields) {
+					for (uint32_t z = 0; z < field.size; z++, element++) {
+						if (isString(field)) {
+							const string_ref_t ref = strings.find(stringValue(row[element]));
+							appendValue(buffer, &ref, sizeof(ref));
+						}
+						else {
+							appendElement(buffer, field, row[element]);
+						}
+					}
+				}
+
+				assert(buffer.size() == record_size);
+				out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+			}
+
+			out.write(strings.data().data(), strings.data().size());
+		}
+	}
+
+	/// <summary>
+	/// Writes a WDB2, WDC3, WDC4 or WDC5 file.
+	/// </summary>
+	template<TDB2Format F>
+	void writeDB2File(std::ostream& out, const RuntimeSchema& schema, uint32_t record_count, const writer_row_provider_t& rows, const DB2WriterOptions& options = DB2WriterOptions()) {
+		WDBREADER_TRACE_SCOPE("database", "writeDB2File", std::string(F::signature.str()));
+
+		if constexpr (std::is_same_v<F, DB2FileFormatWDB2>) {
+			WriterDetail::writeWDB2(out, schema, record_count, rows, options);
+		}
+		else {
+			WriterDetail::writeModern<F>(out, schema, record_count, rows, options);
+		}
+
+		if (!out) {
+			throw WDBReaderException("Unable to write db2 file.");
+		}
+	}
+
+	template<TDB2Format F>
+	void writeDB2File(std::ostream& out, const RuntimeSchema& schema, const std::vector<writer_row_t>& rows, const DB2WriterOptions& options = DB2WriterOptions()) {
+		writeDB2File<F>(out, schema, static_cast<uint32_t>(rows.size()), [&rows](uint32_t index, writer_row_t& row) {
+			row = rows[index];
+		}, options);
+	}
+
+	/// <summary>
+	/// Writes a WDBC file.
+	/// </summary>
+	inline void writeDBCFile(std::ostream& out, const RuntimeSchema& schema, uint32_t record_count, const writer_row_provider_t& rows, const DBCWriterOptions& options = DBCWriterOptions()) {
+		using namespace WriterDetail;
+		WDBREADER_TRACE_SCOPE("database", "writeDBCFile");
+
+		const auto& fields = schema.fields();
+		const uint32_t record_size = static_cast<uint32_t>(DBCFormat::recordSizeSrc(schema, options.version));
+
+		size_t lang_string_count = 1;
+		if (options.version == DBCVersion::VANILLA) {
+			lang_string_count = static_cast<size_t>(DBCStringLocale::VANILLA_SIZE);
+		}
+		else if (options.version == DBCVersion::BC_WOTLK) {
+			lang_string_count = static_cast<size_t>(DBCStringLocale::BC_WOTLK_SIZE);
+		}
+
+		if (static_cast<size_t>(options.locale) >= lang_string_count && options.version != DBCVersion::CATA_PLUS) {
+			throw WDBReaderException("Invalid dbc locale.");
+		}
+
+		StringTable strings(true);
+		writer_row_t row;
+
+		for (uint32_t index = 0; index < record_count; index++) {
+			row.clear();
+			rows(index, row);
+			checkRow(schema, row);
+
+			uint32_t element = 0;
+			for (const auto& field : fields) {
+				for (uint32_t z = 0; z < field.size; z++, element++) {
+					if (isString(field)) {
+						strings.add(stringValue(row[element]));
+					}
+				}
+			}
+		}
+
+		const DBCHeader header{
+			WDBC_MAGIC.integer,
+			record_count,
+			static_cast<uint32_t>(DBCFormat::elementCountSrc(schema, options.version)),
+			record_size,
+			static_cast<uint32_t>(strings.data().size())
+		};
+
+		writePod(out, header);
+
+		std::vector<uint8_t> buffer;
+		for (uint32_t index = 0; index < record_count; index++) {
+			row.clear();
+			rows(index, row);
+			buffer.clear();
+
+			uint32_t element = 0;
+			for (const auto& field : fields) {
+				for (uint32_t z = 0; z < field.size; z++, element++) {
+					if (field.type == Field::Type::LANG_STRING && options.version != DBCVersion::CATA_PLUS) {
+						const lang_string_ref_t empty = 0;
+						const lang_string_ref_t ref = strings.find(stringValue(row[element]));
+						for (size_t locale = 0; locale < lang_string_count; locale++) {
+							appendValue(buffer, locale == static_cast<size_t>(options.locale) ? &ref : &empty, sizeof(lang_string_ref_t));
+						}
+
+						const uint32_t flags = 0;
+						appendValue(buffer, &flags, sizeof(flags));
+					}
+					else if (isString(field)) {
+						const string_ref_t ref = strings.find(stringValue(row[element]));
+						appendValue(buffer, &ref, sizeof(ref));
+					}
+					else {
+						appendElement(buffer, field, row[element]);
+					}
+				}
+			}
+
+			assert(buffer.size() == record_size);
+			out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+		}
+
+		out.write(strings.data().data(), strings.data().size());
+
+		if (!out) {
+			throw WDBReaderException("Unable to write dbc file.");
+		}
+	}
+
+	inline void writeDBCFile(std::ostream& out, const RuntimeSchema& schema, const std::vector<writer_row_t>& rows, const DBCWriterOptions& options = DBCWriterOptions()) {
+		writeDBCFile(out, schema, static_cast<uint32_t>(rows.size()), [&rows](uint32_t index, writer_row_t& row) {
+			row = rows[index];
+		}, options);
+	}
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Trace.hpp"
 #include "Utility.hpp"
 #include <cassert>
 #include <cstdint>
@@ -20,6 +21,23 @@ namespace WDBReader::Filesystem {
 		{ t.getPos() } -> std::same_as<uint64_t>;
 	};
 
+	/// <summary>
+	/// File sources which expose their whole contents in memory.
+	/// </summary>
+	template<typename T>
+	concept TMappedFileSource = TFileSource<T> && requires(const T t) {
+		{ t.data() } -> std::convertible_to<const uint8_t*>;
+	};
+
+	/// <summary>
+	/// File sources which can read from an absolute position without using (or changing) the current position.
+	/// readAt must be safe to call from multiple threads at once.
+	/// </summary>
+	template<typename T>
+	concept TPositionlessFileSource = TFileSource<T> && requires(const T t) {
+		{ t.readAt(std::declval<void*>(), uint64_t(), uint64_t()) } -> std::same_as<void>;
+	};
+
 	template<typename T, typename FU, typename FS>
 	concept TFilesystem = requires(T t) {
 		TFileUri<FU>;
@@ -64,13 +82,21 @@ namespace WDBReader::Filesystem {
 
 		inline void setPos(uint64_t position) override {
 			_pos = position;
-			assert(_pos < _size);
+			assert(_pos <= _size);
 		}
 
 		inline uint64_t getPos() const override {
 			return _pos;
 		}
 
+		inline void readAt(void* dest, uint64_t position, uint64_t bytes) const {
+			if (position > _size || bytes > _size - position) {
+				throw WDBReaderException("Error reading memory source.");
+			}
+
+			memcpy(dest, &_data[position], bytes);
+		}
+
 	private:
 		std::unique_ptr<uint8_t[]> _data;
 		const uint64_t _size;
@@ -78,5 +104,6 @@ namespace WDBReader::Filesystem {
 	};
 
 	static_assert(TFileSource<MemoryFileSource>);
+	static_assert(TPositionlessFileSource<MemoryFileSource>);
 
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "../Filesystem.hpp"
+#include "../Utility.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace WDBReader::Filesystem {
+
+	/// <summary>
+	/// Decorator which reads the underlying source in aligned blocks, keeping the most recently used blocks in memory.
+	/// Small reads (records, strings) are then served from memory instead of each hitting the archive.
+	/// </summary>
+	template<TFileSource FS>
+	class CachedFileSource final : public FileSource {
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+		static constexpr size_t DEFAULT_BLOCK_COUNT = 16;
+
+		struct Stats {
+			size_t hits;
+			size_t misses;
+			uint64_t bytesRead;		// bytes read from the underlying source.
+		};
+
+		CachedFileSource(std::unique_ptr<FS> source, size_t block_size = DEFAULT_BLOCK_SIZE, size_t max_blocks = DEFAULT_BLOCK_COUNT) :
+			_source(std::move(source)), _size(0), _pos(0), _block_size(block_size), _max_blocks(std::max<size_t>(max_blocks, 1)),
+			_hits(0), _misses(0), _bytes_read(0)
+		{
+			assert(_source != nullptr);
+			assert(_block_size > 0);
+			_size = _source->size();
+			_pos = _source->getPos();
+		}
+
+		CachedFileSource(const CachedFileSource&) = delete;
+		CachedFileSource& operator=(const CachedFileSource&) = delete;
+
+		size_t size() const override {
+			return _size;
+		}
+
+		void read(void* dest, uint64_t bytes) override {
+			if (_pos + bytes > _size) {
+				throw WDBReaderException("Error reading cached source.");
+			}
+
+			uint8_t* out = static_cast<uint8_t*>(dest);
+			while (bytes > 0) {
+				const uint64_t block_index = _pos / _block_size;
+				const uint64_t block_offset = _pos % _block_size;
+				const Block& block = getBlock(block_index);
+
+				const uint64_t available = block.size - block_offset;
+				const uint64_t to_copy = std::min(available, bytes);
+				memcpy(out, block.data.get() + block_offset, to_copy);
+
+				out += to_copy;
+				bytes -= to_copy;
+				_pos += to_copy;
+			}
+		}
+
+		void setPos(uint64_t position) override {
+			_pos = position;
+		}
+
+		uint64_t getPos() const override {
+			return _pos;
+		}
+
+		Stats stats() const {
+			return { _hits, _misses, _bytes_read };
+		}
+
+		FS* source() const {
+			return _source.get();
+		}
+
+	protected:
+		struct Block {
+			uint64_t index;
+			uint64_t size;
+			std::unique_ptr<uint8_t[]> data;
+		};
+
+		using block_list_t = std::list<Block>;
+
+		const Block& getBlock(uint64_t index) {
+			auto found = _lookup.find(index);
+			if (found != _lookup.end()) {
+				_hits++;
+				_blocks.splice(_blocks.begin(), _blocks, found->second);
+				return _blocks.front();
+			}
+
+			_misses++;
+
+			// reuse the least recently used buffer once the limit is reached.
+			std::unique_ptr<uint8_t[]> buffer;
+			if (_blocks.size() >= _max_blocks) {
+				auto& oldest = _blocks.back();
+				_lookup.erase(oldest.index);
+				buffer = std::move(oldest.data);
+				_blocks.pop_back();
+			}
+			else {
+				buffer = std::make_unique_for_overwrite<uint8_t[]>(_block_size);
+			}
+
+			const uint64_t start = index * _block_size;
+			const uint64_t block_bytes = std::min<uint64_t>(_block_size, _size - start);
+
+			_source->setPos(start);
+			_source->read(buffer.get(), block_bytes);
+			_bytes_read += block_bytes;
+
+			_blocks.push_front(Block{ index, block_bytes, std::move(buffer) });
+			_lookup[index] = _blocks.begin();
+			return _blocks.front();
+		}
+
+		std::unique_ptr<FS> _source;
+		size_t _size;
+		uint64_t _pos;
+		const size_t _block_size;
+		const size_t _max_blocks;
+
+		block_list_t _blocks;	// most recently used first.
+		std::unordered_map<uint64_t, typename block_list_t::iterator> _lookup;
+
+		size_t _hits;
+		size_t _misses;
+		uint64_t _bytes_read;
+	};
+
+	template<TFileSource FS>
+	std::unique_ptr<CachedFileSource<FS>> makeCachedFileSource(std::unique_ptr<FS> source,
+		size_t block_size = CachedFileSource<FS>::DEFAULT_BLOCK_SIZE, size_t max_blocks = CachedFileSource<FS>::DEFAULT_BLOCK_COUNT)
+	{
+		return std::make_unique<CachedFileSource<FS>>(std::move(source), block_size, max_blocks);
+	}
+
+	static_assert(TFileSource<CachedFileSource<MemoryFileSource>>);
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "../Filesystem.hpp"
+#include "../Utility.hpp"
+#include "MappedFilesystem.hpp"
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace WDBReader::Filesystem {
+
+	/// <summary>
+	/// Directory of previously extracted files. Entries are checked by size whenever opened, and with a FNV-1a hash
+	/// the first time an entry from an earlier run is opened (entries written by this instance are trusted).
+	/// When a size limit is given, the least recently used entries are removed to stay within it.
+	/// </summary>
+	class DiskCache final {
+	public:
+		struct Stats {
+			size_t hits;
+			size_t misses;
+			size_t evictions;
+			size_t corrupted;	// entries discarded due to a size or hash mismatch.
+			uint64_t totalBytes;
+			size_t entries;
+		};
+
+		static constexpr uint64_t UNLIMITED = 0;
+
+		DiskCache(const std::filesystem::path& root, uint64_t max_bytes = UNLIMITED, bool verify = true);
+		DiskCache(const DiskCache&) = delete;
+		DiskCache& operator=(const DiskCache&) = delete;
+
+		/// <summary>
+		/// Returns the cached file, or nullptr when the key isnt cached (or failed verification).
+		/// </summary>
+		std::unique_ptr<MappedFileSource> find(const std::string& key);
+
+		/// <summary>
+		/// Stores the data under the key, replacing any existing entry.
+		/// </summary>
+		std::unique_ptr<MappedFileSource> insert(const std::string& key, const void* data, uint64_t size);
+
+		void remove(const std::string& key);
+		void clear();
+
+		Stats stats() const;
+
+		const std::filesystem::path& root() const {
+			return _root;
+		}
+
+		static uint64_t hash(const void* data, uint64_t size);
+
+	protected:
+		struct Entry {
+			std::string key;
+			uint64_t size;
+			uint64_t hash;
+			uint64_t generation;	// distinguishes a replaced entry of the same key.
+			bool verified;
+		};
+
+		using entry_list_t = std::list<Entry>;
+
+		std::filesystem::path dataPath(const std::string& key) const;
+		std::filesystem::path metaPath(const std::string& key) const;
+		bool eraseEntry(entry_list_t::iterator it);
+		void evict();
+
+		const std::filesystem::path _root;
+		const uint64_t _max_bytes;
+		const bool _verify;
+
+		mutable std::mutex _mutex;
+		entry_list_t _entries;	// most recently used first.
+		std::unordered_map<std::string, entry_list_t::iterator> _lookup;
+		uint64_t _generation;
+		uint64_t _total_bytes;
+		size_t _hits;
+		size_t _misses;
+		size_t _evictions;
+		size_t _corrupted;
+		std::atomic<uint64_t> _temp_sequence;
+	};
+
+	inline std::string diskCacheKey(uint32_t file_data_id) {
+		return std::to_string(file_data_id);
+	}
+
+	/// <summary>
+	/// MPQ paths are case insensitive and use backslashes, normalise so equivalent paths share an entry.
+	/// </summary>
+	inline std::string diskCacheKey(const std::string& path) {
+		std::string key;
+		key.reserve(path.size());
+		for (const auto c : path) {
+			if (c == '\\' || c == '/') {
+				if (!key.empty()) {
+					key.push_back('/');
+				}
+			}
+			else if (c == ':') {
+				key.push_back('_');
+			}
+			else {
+				key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+			}
+		}
+		return key;
+	}
+
+	/// <summary>
+	/// Wraps another filesystem (CASC, MPQ), files are extracted once per build and served from memory mapped local copies.
+	/// </summary>
+	template<typename FSys, TFileUri FU>
+	class DiskCacheFilesystem final {
+	public:
+		DiskCacheFilesystem(FSys&& filesystem, const std::filesystem::path& cache_dir, const GameVersion& build, uint64_t max_bytes = DiskCache::UNLIMITED, bool verify = true) :
+			_filesystem(std::move(filesystem)), _cache(cache_dir / build.toString(), max_bytes, verify)
+		{}
+
+		std::unique_ptr<MappedFileSource> open(const FU& uri) {
+			const auto key = diskCacheKey(uri);
+			WDBREADER_TRACE_SCOPE("filesystem", "DiskCacheFilesystem::open", key);
+
+			auto cached = _cache.find(key);
+			if (cached != nullptr) {
+				return cached;
+			}
+
+			auto source = _filesystem.open(uri);
+			if (source == nullptr) {
+				return nullptr;
+			}
+
+			const auto size = source->size();
+			auto buffer = std::make_unique_for_overwrite<uint8_t[]>(size);
+			source->read(buffer.get(), size);
+
+			return _cache.insert(key, buffer.get(), size);
+		}
+
+		FSys& filesystem() {
+			return _filesystem;
+		}
+
+		DiskCache& cache() {
+			return _cache;
+		}
+
+	protected:
+		FSys _filesystem;
+		DiskCache _cache;
+	};
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../Filesystem.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace WDBReader::Filesystem {
+
+	/// <summary>
+	/// Power of two bucketed histogram, bucket N counts values in the range [2^(N-1), 2^N).
+	/// </summary>
+	struct Histogram {
+	public:
+		static constexpr size_t BUCKET_COUNT = 48;
+
+		std::array<uint64_t, BUCKET_COUNT> buckets{};
+		uint64_t count = 0;
+		uint64_t total = 0;
+		uint64_t max = 0;
+
+		inline void record(uint64_t value) {
+			const size_t bucket = std::min<size_t>(std::bit_width(value), BUCKET_COUNT - 1);
+			buckets[bucket]++;
+			count++;
+			total += value;
+			max = std::max(max, value);
+		}
+
+		inline double mean() const {
+			return count > 0 ? static_cast<double>(total) / count : 0.0;
+		}
+
+		/// <summary>
+		/// Upper bound of the bucket containing the percentile (0 - 1).
+		/// </summary>
+		inline uint64_t percentile(double p) const {
+			if (count == 0) {
+				return 0;
+			}
+
+			const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(p * count + 0.5));
+			uint64_t seen = 0;
+			for (size_t i = 0; i < BUCKET_COUNT; i++) {
+				seen += buckets[i];
+				if (seen >= target) {
+					return i == 0 ? 0 : std::min(max, (uint64_t(1) << i) - 1);
+				}
+			}
+
+			return max;
+		}
+	};
+
+	struct IOStats {
+	public:
+		uint64_t readCalls = 0;
+		uint64_t setPosCalls = 0;
+		uint64_t redundantSetPosCalls = 0;	// setPos calls which didnt move the position.
+		uint64_t bytesRead = 0;
+		uint64_t seekDistance = 0;			// total absolute distance moved by setPos.
+		Histogram readSize;					// bytes per read call.
+		Histogram readLatency;				// nanoseconds per read call.
+		Histogram setPosLatency;			// nanoseconds per setPos call.
+
+		void report(std::ostream& out, const std::string& name = "") const {
+			if (!name.empty()) {
+				out << name << "\n";
+			}
+
+			out << "  reads: " << readCalls << ", bytes: " << bytesRead
+				<< ", mean size: " << readSize.mean() << ", p50 size: " << readSize.percentile(0.5) << "\n";
+			out << "  read latency (ns) mean: " << readLatency.mean()
+				<< ", p50: " << readLatency.percentile(0.5)
+				<< ", p99: " << readLatency.percentile(0.99)
+				<< ", max: " << readLatency.max
+				<< ", total: " << readLatency.total << "\n";
+			out << "  setPos: " << setPosCalls << " (redundant: " << redundantSetPosCalls << "), seek distance: " << seekDistance << "\n";
+			out << "  setPos latency (ns) mean: " << setPosLatency.mean()
+				<< ", p50: " << setPosLatency.percentile(0.5)
+				<< ", p99: " << setPosLatency.percentile(0.99)
+				<< ", max: " << setPosLatency.max
+				<< ", total: " << setPosLatency.total << "\n";
+		}
+	};
+
+	/// <summary>
+	/// Decorator recording call counts, bytes, seek distances and latencies of the wrapped source.
+	/// </summary>
+	template<TFileSource FS>
+	class InstrumentedFileSource final : public FileSource {
+	public:
+		using clock_t = std::chrono::steady_clock;
+
+		InstrumentedFileSource(std::unique_ptr<FS> source) : _source(std::move(source))
+		{
+			assert(_source != nullptr);
+		}
+
+		InstrumentedFileSource(const InstrumentedFileSource&) = delete;
+		InstrumentedFileSource& operator=(const InstrumentedFileSource&) = delete;
+
+		size_t size() const override {
+			return _source->size();
+		}
+
+		void read(void* dest, uint64_t bytes) override {
+			const auto start = clock_t::now();
+			_source->read(dest, bytes);
+			const auto elapsed = clock_t::now() - start;
+
+			_stats.readCalls++;
+			_stats.bytesRead += bytes;
+			_stats.readSize.record(bytes);
+			_stats.readLatency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		}
+
+		void setPos(uint64_t position) override {
+			const auto current = _source->getPos();
+
+			const auto start = clock_t::now();
+			_source->setPos(position);
+			const auto elapsed = clock_t::now() - start;
+
+			_stats.setPosCalls++;
+			if (position == current) {
+				_stats.redundantSetPosCalls++;
+			}
+			_stats.seekDistance += position > current ? position - current : current - position;
+			_stats.setPosLatency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		}
+
+		uint64_t getPos() const override {
+			return _source->getPos();
+		}
+
+		const IOStats& stats() const {
+			return _stats;
+		}
+
+		void resetStats() {
+			_stats = IOStats();
+		}
+
+		void report(std::ostream& out, const std::string& name = "") const {
+			_stats.report(out, name);
+		}
+
+		FS* source() const {
+			return _source.get();
+		}
+
+	protected:
+		std::unique_ptr<FS> _source;
+		IOStats _stats;
+	};
+
+	template<TFileSource FS>
+	std::unique_ptr<InstrumentedFileSource<FS>> makeInstrumentedFileSource(std::unique_ptr<FS> source)
+	{
+		return std::make_unique<InstrumentedFileSource<FS>>(std::move(source));
+	}
+
+	static_assert(TFileSource<InstrumentedFileSource<MemoryFileSource>>);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../Filesystem.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+namespace WDBReader::Filesystem
+{
+
+    using MappedFileUri = std::filesystem::path;
+    static_assert(TFileUri<MappedFileUri>);
+
+    /// <summary>
+    /// Read only memory mapped file, reads are plain copies from the mapped view.
+    /// </summary>
+    class MappedFileSource final : public FileSource
+    {
+    public:
+        MappedFileSource(const std::filesystem::path& path);
+        MappedFileSource(const MappedFileSource&) = delete;
+        MappedFileSource& operator=(const MappedFileSource&) = delete;
+        ~MappedFileSource();
+
+        size_t size() const override
+        {
+            return _size;
+        }
+
+        void read(void* dest, uint64_t bytes) override
+        {
+            readAt(dest, _pos, bytes);
+            _pos += bytes;
+        }
+
+        void setPos(uint64_t position) override
+        {
+            _pos = position;
+        }
+
+        uint64_t getPos() const override
+        {
+            return _pos;
+        }
+
+        /// <summary>
+        /// Reads from an absolute position, without changing the current position.
+        /// </summary>
+        void readAt(void* dest, uint64_t position, uint64_t bytes) const
+        {
+            if (position + bytes > _size) {
+                throw WDBReaderException("Error reading mapped file.");
+            }
+
+            memcpy(dest, _data + position, bytes);
+        }
+
+        const uint8_t* data() const
+        {
+            return _data;
+        }
+
+    protected:
+        const uint8_t* _data;
+        size_t _size;
+        uint64_t _pos;
+
+#ifdef WIN32
+        void* _file_handle;
+        void* _mapping_handle;
+#endif
+    };
+
+    static_assert(TFileSource<MappedFileSource>);
+    static_assert(TPositionlessFileSource<MappedFileSource>);
+
+    class MappedFilesystem
+    {
+    public:
+        std::unique_ptr<MappedFileSource> open(const MappedFileUri& uri)
+        {
+            WDBREADER_TRACE_SCOPE("filesystem", "MappedFilesystem::open", uri.string());
+            return std::make_unique<MappedFileSource>(uri);
+        }
+    };
+
+    static_assert(TFilesystem<MappedFilesystem, MappedFileUri, MappedFileSource>);
+}
@@ -63,6 +63,7 @@ namespace WDBReader::Filesystem
     public:
         std::unique_ptr<NativeFileSource> open(const NativeFileUri& uri)
         {
+            WDBREADER_TRACE_SCOPE("filesystem", "NativeFilesystem::open", uri.string());
             return std::make_unique<NativeFileSource>(std::ifstream(uri, std::ifstream::binary));
         }
     };
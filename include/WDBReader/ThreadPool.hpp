@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace WDBReader
+{
+    /// <summary>
+    /// Fixed size pool of worker threads, used to spread independent parts of loading across cores.
+    /// Each worker has its own queue, work submitted from a worker goes to its own queue (run newest first) and idle workers
+    /// steal the oldest work from others, so nested work stays local unless another worker is free.
+    /// </summary>
+    class ThreadPool final
+    {
+    public:
+        static constexpr size_t NOT_A_WORKER = SIZE_MAX;
+
+        ThreadPool(size_t thread_count = std::max(1u, std::thread::hardware_concurrency())) : _stopping(false), _pending(0)
+        {
+            _queues.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; i++) {
+                _queues.push_back(std::make_unique<Queue>());
+            }
+
+            _threads.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; i++) {
+                _threads.emplace_back([this, i]() { worker(i); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::scoped_lock lock(_mutex);
+                _stopping = true;
+            }
+            _condition.notify_all();
+
+            for (auto& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        inline size_t size() const
+        {
+            return _threads.size();
+        }
+
+        /// <summary>
+        /// Index of the calling thread within this pool, or NOT_A_WORKER.
+        /// </summary>
+        inline size_t currentWorker() const
+        {
+            return current().pool == this ? current().index : NOT_A_WORKER;
+        }
+
+        template<typename Fn>
+        auto submit(Fn&& fn) -> std::future<std::invoke_result_t<Fn>>
+        {
+            using result_t = std::invoke_result_t<Fn>;
+            auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<Fn>(fn));
+            auto future = task->get_future();
+
+            push([task]() { (*task)(); }, 1);
+
+            return future;
+        }
+
+        /// <summary>
+        /// Calls fn(index) for every index in [0, count), returning once all calls are complete.
+        /// The calling thread takes part, so nested use from a worker cant deadlock. The first exception thrown is rethrown.
+        /// </summary>
+        template<typename Fn>
+        void parallelFor(size_t count, Fn&& fn)
+        {
+            if (count == 0) {
+                return;
+            }
+
+            struct State {
+                std::atomic<size_t> next = 0;
+                std::atomic<size_t> done = 0;
+                std::mutex mutex;
+                std::condition_variable finished;
+                std::exception_ptr error;
+            };
+
+            // helpers can start after every index has been claimed, so only shared state outlives the call.
+            auto state = std::make_shared<State>();
+            auto* const func = &fn;
+
+            auto run = [state, func, count]() {
+                for (size_t index = state->next++; index < count; index = state->next++) {
+                    try {
+                        (*func)(index);
+                    }
+                    catch (...) {
+                        std::scoped_lock lock(state->mutex);
+                        if (!state->error) {
+                            state->error = std::current_exception();
+                        }
+                    }
+
+                    if (++state->done == count) {
+                        std::scoped_lock lock(state->mutex);
+                        state->finished.notify_all();
+                    }
+                }
+            };
+
+            push(run, std::min(count - 1, _threads.size()));
+
+            run();
+
+            std::unique_lock lock(state->mutex);
+            state->finished.wait(lock, [&state, count]() { return state->done == count; });
+
+            if (state->error) {
+                std::rethrow_exception(state->error);
+            }
+        }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        struct Worker {
+            const ThreadPool* pool = nullptr;
+            size_t index = NOT_A_WORKER;
+        };
+
+        static Worker& current()
+        {
+            static thread_local Worker worker;
+            return worker;
+        }
+
+        void push(const std::function<void()>& task, size_t copies)
+        {
+            if (copies == 0) {
+                return;
+            }
+
+            // counted first, so the count never drops below the queued tasks (a woken worker may briefly find nothing).
+            {
+                std::scoped_lock lock(_mutex);
+                _pending += copies;
+            }
+
+            const auto worker_index = currentWorker();
+            Queue& queue = worker_index != NOT_A_WORKER ? *_queues[worker_index] : _injected;
+            {
+                std::scoped_lock lock(queue.mutex);
+                for (size_t i = 0; i < copies; i++) {
+                    queue.tasks.push_back(task);
+                }
+            }
+
+            if (copies == 1) {
+                _condition.notify_one();
+            }
+            else {
+                _condition.notify_all();
+            }
+        }
+
+        bool tryPop(size_t index, std::function<void()>& task)
+        {
+            auto take = [&](Queue& queue, bool newest) {
+                std::scoped_lock lock(queue.mutex);
+                if (queue.tasks.empty()) {
+                    return false;
+                }
+
+                if (newest) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                return true;
+            };
+
+            if (take(*_queues[index], true) || take(_injected, false)) {
+                return true;
+            }
+
+            for (size_t i = 1; i < _queues.size(); i++) {
+                if (take(*_queues[(index + i) % _queues.size()], false)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void worker(size_t index)
+        {
+            current() = Worker{ this, index };
+
+            while (true) {
+                std::function<void()> task;
+                if (tryPop(index, task)) {
+                    {
+                        std::scoped_lock lock(_mutex);
+                        _pending--;
+                    }
+                    task();
+                    continue;
+                }
+
+                std::unique_lock lock(_mutex);
+                _condition.wait(lock, [this]() { return _stopping || _pending > 0; });
+
+                if (_stopping && _pending == 0) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::thread> _threads;
+        std::vector<std::unique_ptr<Queue>> _queues;
+        Queue _injected;    // work submitted from outside the pool.
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stopping;
+        size_t _pending;
+    };
+}
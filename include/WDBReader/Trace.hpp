@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*
+    Tracing is compiled out unless WDBREADER_TRACE is defined (cmake option WDBREADER_TRACE).
+    Per record events are very frequent, so additionally require WDBREADER_TRACE_RECORDS.
+*/
+
+namespace WDBReader::Trace
+{
+    struct Event
+    {
+    public:
+        std::string name;
+        std::string_view category;
+        std::string detail;
+        uint64_t start;     // microseconds since the recorder epoch.
+        uint64_t duration;  // microseconds.
+        uint32_t thread;
+    };
+
+    /// <summary>
+    /// Collects completed events while enabled, and writes them as chrome trace json (chrome://tracing, perfetto).
+    /// </summary>
+    class Recorder final
+    {
+    public:
+        using clock_t = std::chrono::steady_clock;
+
+        Recorder() : _enabled(false), _epoch(clock_t::now()) {}
+        Recorder(const Recorder&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+
+        inline void start()
+        {
+            std::scoped_lock lock(_mutex);
+            _events.clear();
+            _epoch = clock_t::now();
+            _enabled = true;
+        }
+
+        inline void stop()
+        {
+            _enabled = false;
+        }
+
+        inline bool enabled() const
+        {
+            return _enabled;
+        }
+
+        inline void record(std::string&& name, std::string_view category, std::string&& detail, clock_t::time_point begin, clock_t::time_point end)
+        {
+            if (!_enabled) {
+                return;
+            }
+
+            std::scoped_lock lock(_mutex);
+            _events.push_back(Event{
+                std::move(name),
+                category,
+                std::move(detail),
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(begin - _epoch).count()),
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()),
+                threadId()
+            });
+        }
+
+        inline std::vector<Event> events() const
+        {
+            std::scoped_lock lock(_mutex);
+            return _events;
+        }
+
+        void write(std::ostream& out) const
+        {
+            std::scoped_lock lock(_mutex);
+
+            out << "{\"traceEvents\":[";
+            bool first = true;
+            for (const auto& event : _events) {
+                if (!first) {
+                    out << ",";
+                }
+                first = false;
+
+                out << "\n{\"name\":\"";
+                writeEscaped(out, event.name);
+                out << "\",\"cat\":\"";
+                writeEscaped(out, event.category);
+                out << "\",\"ph\":\"X\",\"ts\":" << event.start
+                    << ",\"dur\":" << event.duration
+                    << ",\"pid\":1,\"tid\":" << event.thread;
+
+                if (!event.detail.empty()) {
+                    out << ",\"args\":{\"detail\":\"";
+                    writeEscaped(out, event.detail);
+                    out << "\"}";
+                }
+
+                out << "}";
+            }
+            out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+
+    private:
+        static uint32_t threadId()
+        {
+            // small sequential ids are easier to read in trace viewers than native ids.
+            static std::atomic<uint32_t> next_id = 1;
+            thread_local const uint32_t id = next_id++;
+            return id;
+        }
+
+        static void writeEscaped(std::ostream& out, std::string_view str)
+        {
+            for (const char c : str) {
+                switch (c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\r': out << "\\r"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        constexpr char hex[] = "0123456789abcdef";
+                        out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                    }
+                    else {
+                        out << c;
+                    }
+                    break;
+                }
+            }
+        }
+
+        std::atomic<bool> _enabled;
+        clock_t::time_point _epoch;
+        mutable std::mutex _mutex;
+        std::vector<Event> _events;
+    };
+
+    inline Recorder& recorder()
+    {
+        static Recorder instance;
+        return instance;
+    }
+
+    /// <summary>
+    /// Records a single event covering the lifetime of the scope.
+    /// </summary>
+    class Scope final
+    {
+    public:
+        Scope(std::string_view category, std::string name, std::string detail = "") :
+            _active(recorder().enabled()), _category(category)
+        {
+            if (_active) {
+                _name = std::move(name);
+                _detail = std::move(detail);
+                _begin = Recorder::clock_t::now();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            if (_active) {
+                recorder().record(std::move(_name), _category, std::move(_detail), _begin, Recorder::clock_t::now());
+            }
+        }
+
+    private:
+        const bool _active;
+        std::string_view _category;
+        std::string _name;
+        std::string _detail;
+        Recorder::clock_t::time_point _begin;
+    };
+}
+
+#define WDBREADER_TRACE_CONCAT_INNER(a, b) a##b
+#define WDBREADER_TRACE_CONCAT(a, b) WDBREADER_TRACE_CONCAT_INNER(a, b)
+
+#ifdef WDBREADER_TRACE
+#define WDBREADER_TRACE_SCOPE(category, ...) ::WDBReader::Trace::Scope WDBREADER_TRACE_CONCAT(_wdbreader_trace_, __LINE__)(category, __VA_ARGS__)
+#else
+#define WDBREADER_TRACE_SCOPE(category, ...) ((void)0)
+#endif
+
+#if defined(WDBREADER_TRACE) && defined(WDBREADER_TRACE_RECORDS)
+#define WDBREADER_TRACE_RECORD_SCOPE(category, ...) ::WDBReader::Trace::Scope WDBREADER_TRACE_CONCAT(_wdbreader_trace_, __LINE__)(category, __VA_ARGS__)
+#else
+#define WDBREADER_TRACE_RECORD_SCOPE(category, ...) ((void)0)
+#endif
@@ -8,6 +8,7 @@
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <system_error>	
 #include <type_traits>
 #include <vector>
@@ -70,48 +71,36 @@ namespace WDBReader {
         {
         }
 
-        GameVersion(const std::string& str) 
-        : expansion(0), major(0), minor(0), build(0)
+        GameVersion(const std::string& str)
+        : GameVersion(parseOrThrow(str))
         {
-            auto extract = [](const std::string& in, size_t start, auto& out, bool needs_end = true) -> size_t
-            {
-                size_t end;
+        }
 
-                if (needs_end)
-                {
-                    end = in.find_first_of('.', start);
-                    if (end == in.npos)
-                    {
-                        throw std::runtime_error("Build string is invalid.");
-                    }
-                }
-                else
+        // parses "a.b.c.d" without allocating or throwing, every part must be a number.
+        inline static std::optional<GameVersion> fromString(std::string_view str)
+        {
+            GameVersion version;
+            const char* pos = str.data();
+            const char* const end = str.data() + str.size();
+
+            auto extract = [&pos, end](auto& out, bool needs_end = true) -> bool
+            {
+                const auto [ptr, ec] = std::from_chars(pos, end, out);
+                if (ec != std::errc() || (needs_end ? (ptr == end || *ptr != '.') : ptr != end))
                 {
-                    end = in.npos;
+                    return false;
                 }
 
-                auto temp_str = in.substr(start, end - start);
-                std::from_chars(temp_str.data(), temp_str.data() + temp_str.size(), out);
-
-                return end;
+                pos = needs_end ? ptr + 1 : ptr;
+                return true;
             };
 
-            const auto first_pos = extract(str, 0, expansion);
-            const auto second_pos = extract(str, first_pos + 1, major);
-            const auto third_pos = extract(str, second_pos + 1, minor);
-            extract(str, third_pos + 1, build, false);
-        }
-
-        inline static std::optional<GameVersion> fromString(const std::string& str)
-        {
-            try
-            {
-                return GameVersion(str);
-            }
-            catch (...)
+            if (extract(version.expansion) && extract(version.major) && extract(version.minor) && extract(version.build, false))
             {
-                return std::nullopt;
+                return version;
             }
+
+            return std::nullopt;
         }
 
         constexpr auto operator<=>(const GameVersion&) const = default;
@@ -123,6 +112,17 @@ namespace WDBReader {
         inline std::string toString() const {
             return std::format("{}.{}.{}.{}", expansion, major, minor, build);
         }
+
+    private:
+        inline static GameVersion parseOrThrow(std::string_view str)
+        {
+            const auto version = fromString(str);
+            if (!version.has_value())
+            {
+                throw std::runtime_error("Build string is invalid.");
+            }
+            return *version;
+        }
     };
 
     template<std::invocable T>
@@ -165,6 +165,13 @@ namespace WDBReader {
             return _data[index];
         }
 
+        inline const T& operator[](size_t index) const {
+#ifdef _DEBUG
+            assert(index < _view.size());
+#endif
+            return _data[index];
+        }
+
         inline pointer get() {
             return _data.get();
         }
@@ -2,12 +2,18 @@
 
 #include "Utility.hpp"
 #include "Database.hpp"
+#include "ThreadPool.hpp"
 #include <array>
 #include <cstdint>
+#include <filesystem>
 #include <istream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace WDBReader::WoWDBDefs {
@@ -75,5 +81,115 @@ namespace WDBReader::WoWDBDefs {
 		static const std::array<std::string, 4> ValidTypes;
 	};
 
+	/// <summary>
+	/// Layout hash of a LAYOUT entry, as written in the file header.
+	/// </summary>
+	std::optional<uint32_t> parseLayoutHash(std::string_view layout);
+
+	/// <summary>
+	/// Field for a column of the type ("int", "float", "string" or "locstring") as defined by a single version.
+	/// </summary>
+	Database::Field makeField(std::string_view type, int32_t size, int32_t array_length, const Database::Annotation& annotation);
+
 	std::optional<Database::RuntimeSchema> makeSchema(const DBDefinition& db_definition, const GameVersion& target_version);
+	Database::RuntimeSchema makeSchema(const DBDefinition& db_definition, const VersionDefinitions& version_definition);
+
+	/// <summary>
+	/// Schema of the first version listing the layout hash, as read from a WDC3+ header.
+	/// </summary>
+	std::optional<Database::RuntimeSchema> makeSchemaForLayout(const DBDefinition& db_definition, uint32_t layout_hash);
+
+	/// <summary>
+	/// Definitions of every table in a WoWDBDefs definitions directory, with each tables versions indexed by exact build,
+	/// layout hash and build range. Resolved schemas are cached, resolving matches makeSchema (the first matching version wins).
+	/// </summary>
+	class DefinitionRegistry final {
+	public:
+		struct Failure {
+			std::string name;
+			std::string reason;
+		};
+
+		DefinitionRegistry() = default;
+
+		/// <summary>
+		/// Reads every .dbd file in the directory, across the pool when given. Files which fail to parse are listed in failures().
+		/// </summary>
+		explicit DefinitionRegistry(const std::filesystem::path& definitions_dir, ThreadPool* pool = nullptr);
+
+		DefinitionRegistry(DefinitionRegistry&&) = default;
+		DefinitionRegistry& operator=(DefinitionRegistry&&) = default;
+
+		void add(const std::string& name, DBDefinition definition);
+
+		bool contains(std::string_view name) const;
+		const DBDefinition* definition(std::string_view name) const;
+		std::vector<std::string> names() const;
+
+		inline size_t size() const {
+			return _tables.size();
+		}
+
+		inline const std::vector<Failure>& failures() const {
+			return _failures;
+		}
+
+		/// <summary>
+		/// Index into the tables versionDefinitions for the build, checking exact builds before ranges.
+		/// </summary>
+		std::optional<size_t> versionIndex(std::string_view name, const Build& build) const;
+		std::optional<size_t> versionIndexForLayout(std::string_view name, uint32_t layout_hash) const;
+
+		/// <summary>
+		/// Schema of the table for the build, or nullptr when the table or build isnt defined.
+		/// </summary>
+		std::shared_ptr<const Database::RuntimeSchema> schema(std::string_view name, const Build& build) const;
+		std::shared_ptr<const Database::RuntimeSchema> schemaForLayout(std::string_view name, uint32_t layout_hash) const;
+
+		/// <summary>
+		/// Table defining the layout hash across every table, when layouts collide the first table by name wins.
+		/// </summary>
+		std::optional<std::string_view> tableForLayout(uint32_t layout_hash) const;
+		std::shared_ptr<const Database::RuntimeSchema> schemaForLayout(uint32_t layout_hash) const;
+
+	protected:
+		struct RangeBoundary {
+			Build build;
+			uint8_t kind;	// 0 range starts at build, 1 range ends after build.
+
+			constexpr auto operator<=>(const RangeBoundary&) const = default;
+		};
+
+		struct Table {
+			Table(DBDefinition def);
+
+			DBDefinition definition;
+			std::vector<std::pair<Build, size_t>> builds;			// sorted, first version listing the build.
+			std::vector<std::pair<uint32_t, size_t>> layouts;		// sorted, first version listing the layout.
+			std::vector<RangeBoundary> rangeBoundaries;				// sorted, unique.
+			std::vector<size_t> rangeVersions;						// first version covering each segment between boundaries, or NO_VERSION.
+
+			mutable std::mutex cacheMutex;
+			mutable std::vector<std::shared_ptr<const Database::RuntimeSchema>> cache;	// per version.
+
+			std::optional<size_t> versionIndex(const Build& build) const;
+			std::optional<size_t> versionIndexForLayout(uint32_t layout_hash) const;
+			std::shared_ptr<const Database::RuntimeSchema> schema(size_t version_index) const;
+		};
+
+		struct LayoutEntry {
+			const std::string* name;
+			const Table* table;
+			size_t version;
+		};
+
+		static constexpr size_t NO_VERSION = SIZE_MAX;
+
+		const Table* find(std::string_view name) const;
+		void rebuildLayouts();
+
+		std::map<std::string, std::unique_ptr<Table>, std::less<>> _tables;
+		std::unordered_map<uint32_t, LayoutEntry> _layouts;
+		std::vector<Failure> _failures;
+	};
 }
\ No newline at end of file
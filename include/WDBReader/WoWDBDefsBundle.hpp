@@ -0,0 +1,233 @@
+#pragma once
+
+#include "WoWDBDefs.hpp"
+#include "Database.hpp"
+#include "Filesystem/MappedFilesystem.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WDBReader::WoWDBDefs {
+
+	/*
+		Bundles store a whole definitions directory already parsed, they are read in place (typically memory mapped).
+		Layout:
+			BundleHeader
+			BundleTable[table_count], sorted by name.
+			BundleColumn[column_count], each tables columns are contiguous and sorted by name.
+			BundleVersion[version_count], each tables versions are contiguous and in file order.
+			BundleBuild[build_count], each versions builds then its ranges (as min, max pairs).
+			BundleLayout[layout_count], each versions layout hashes.
+			BundleDefinition[definition_count], each versions definitions.
+			BundleBuildIndexEntry[build_index_count], each tables exact builds sorted, first version listing the build.
+			BundleRangeBoundary[range_boundary_count], each tables range starts and ends sorted and unique.
+			uint32_t[range_segment_count], each tables first version covering the builds between two boundaries (one more than its boundaries).
+			BundleTableLayoutEntry[table_layout_count], each tables layout hashes sorted, first version listing the hash.
+			BundleLayoutIndexEntry[layout_index_count], sorted by hash, first table by name listing the hash.
+			string pool, strings are interned and referenced by offset and length.
+		The output only depends on the definitions, so bundles of the same definitions are identical.
+	*/
+
+	constexpr Database::Signature BUNDLE_MAGIC = "WDBD";
+	constexpr uint32_t BUNDLE_VERSION = 2;
+	constexpr uint32_t BUNDLE_NO_VERSION = UINT32_MAX;
+
+#pragma pack(push, 1)
+
+	struct BundleString {
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	struct BundleHeader {
+		uint32_t signature;
+		uint32_t version;
+		uint32_t table_count;
+		uint32_t column_count;
+		uint32_t version_count;
+		uint32_t build_count;
+		uint32_t layout_count;
+		uint32_t definition_count;
+		uint32_t build_index_count;
+		uint32_t range_boundary_count;
+		uint32_t range_segment_count;
+		uint32_t table_layout_count;
+		uint32_t layout_index_count;
+		uint64_t tables_offset;
+		uint64_t columns_offset;
+		uint64_t versions_offset;
+		uint64_t builds_offset;
+		uint64_t layouts_offset;
+		uint64_t definitions_offset;
+		uint64_t build_index_offset;
+		uint64_t range_boundaries_offset;
+		uint64_t range_segments_offset;
+		uint64_t table_layouts_offset;
+		uint64_t layout_index_offset;
+		uint64_t strings_offset;
+		uint64_t strings_size;
+	};
+
+	struct BundleTable {
+		BundleString name;
+		uint32_t column_begin;
+		uint32_t column_count;
+		uint32_t version_begin;
+		uint32_t version_count;
+		uint32_t build_index_begin;
+		uint32_t build_index_count;
+		uint32_t range_boundary_begin;
+		uint32_t range_boundary_count;
+		uint32_t range_segment_begin;	// range_boundary_count + 1 segments.
+		uint32_t layout_begin;
+		uint32_t layout_count;
+	};
+
+	struct BundleColumn {
+		BundleString name;
+		BundleString type;
+		BundleString foreign_table;
+		BundleString foreign_column;
+		BundleString comment;
+		uint8_t verified;
+		uint8_t padding[3];
+	};
+
+	struct BundleVersion {
+		uint32_t build_begin;
+		uint32_t build_count;
+		uint32_t range_begin;		// into the builds, two per range.
+		uint32_t range_count;
+		uint32_t layout_begin;
+		uint32_t layout_count;
+		uint32_t definition_begin;
+		uint32_t definition_count;
+		BundleString comment;
+	};
+
+	struct BundleBuild {
+		uint16_t expansion;
+		uint16_t major;
+		uint16_t minor;
+		uint16_t padding;
+		uint32_t build;
+	};
+
+	struct BundleLayout {
+		BundleString text;
+		uint32_t hash;
+		uint32_t valid;		// 0 when the text isnt a hex hash.
+	};
+
+	struct BundleDefinition {
+		BundleString name;
+		BundleString comment;
+		uint32_t column;	// index into the tables columns.
+		int32_t size;
+		int32_t array_length;
+		uint8_t flags;
+		uint8_t padding[3];
+	};
+
+	struct BundleBuildIndexEntry {
+		BundleBuild build;
+		uint32_t version;
+	};
+
+	struct BundleRangeBoundary {
+		BundleBuild build;
+		uint32_t kind;		// 0 range starts at build, 1 range ends after build.
+	};
+
+	struct BundleTableLayoutEntry {
+		uint32_t hash;
+		uint32_t version;
+	};
+
+	struct BundleLayoutIndexEntry {
+		uint32_t hash;
+		uint32_t table;
+		uint32_t version;
+	};
+
+#pragma pack(pop)
+
+	/// <summary>
+	/// Writes every definition of the registry as a bundle.
+	/// </summary>
+	void writeDefinitionBundle(std::ostream& stream, const DefinitionRegistry& registry);
+
+	/// <summary>
+	/// Definitions read in place from a bundle, lookups resolve like the DefinitionRegistry without parsing any .dbd files.
+	/// Builds and layouts are binary searched in the tables precomputed indexes, as the registry does in memory.
+	/// Section bounds are checked when opened, every reference is checked when followed.
+	/// </summary>
+	class DefinitionBundle final {
+	public:
+		/// <summary>
+		/// Maps the bundle file.
+		/// </summary>
+		explicit DefinitionBundle(const std::filesystem::path& path);
+		explicit DefinitionBundle(std::vector<uint8_t> data);
+
+		DefinitionBundle(DefinitionBundle&&) = default;
+		DefinitionBundle& operator=(DefinitionBundle&&) = default;
+
+		/// <summary>
+		/// True when the path is a file starting with the bundle signature.
+		/// </summary>
+		static bool isBundle(const std::filesystem::path& path);
+
+		inline size_t size() const {
+			return _header.table_count;
+		}
+
+		bool contains(std::string_view name) const;
+		std::vector<std::string> names() const;
+
+		/// <summary>
+		/// Rebuilds the full definition of a table, for callers which need more than its schemas.
+		/// </summary>
+		std::optional<DBDefinition> definition(std::string_view name) const;
+
+		std::optional<size_t> versionIndex(std::string_view name, const Build& build) const;
+		std::optional<size_t> versionIndexForLayout(std::string_view name, uint32_t layout_hash) const;
+
+		std::optional<Database::RuntimeSchema> schema(std::string_view name, const Build& build) const;
+		std::optional<Database::RuntimeSchema> schemaForLayout(std::string_view name, uint32_t layout_hash) const;
+
+		/// <summary>
+		/// Table defining the layout hash across every table, when layouts collide the first table by name wins.
+		/// </summary>
+		std::optional<std::string_view> tableForLayout(uint32_t layout_hash) const;
+		std::optional<Database::RuntimeSchema> schemaForLayout(uint32_t layout_hash) const;
+
+	protected:
+		void validate();
+
+		template<typename T>
+		T element(uint64_t section_offset, uint32_t count, uint32_t index) const;
+
+		std::string_view string(const BundleString& str) const;
+		static Build toBuild(const BundleBuild& build);
+
+		std::optional<uint32_t> findTable(std::string_view name) const;
+		std::optional<size_t> versionIndex(const BundleTable& table, const Build& build) const;
+		std::optional<size_t> versionIndexForLayout(const BundleTable& table, uint32_t layout_hash) const;
+		Database::RuntimeSchema schema(const BundleTable& table, size_t version_index) const;
+
+		BundleTable tableAt(uint32_t index) const;
+		BundleVersion versionAt(const BundleTable& table, size_t index) const;
+
+		std::unique_ptr<Filesystem::MappedFileSource> _mapped;
+		std::vector<uint8_t> _owned;
+		std::span<const uint8_t> _data;
+		BundleHeader _header;
+	};
+}
@@ -45,6 +45,8 @@ namespace WDBReader::Filesystem {
 
 	std::unique_ptr<CASCFileSource> CASCFilesystem::open(CASCFileUri uri)
 	{
+		WDBREADER_TRACE_SCOPE("filesystem", "CASCFilesystem::open", std::to_string(uri));
+
 		HANDLE temp;
 		if (CascOpenFile(_storage.get(), CASC_FILE_DATA_ID(uri), _locale_mask, CASC_OPEN_BY_FILEID | CASC_OVERCOME_ENCRYPTED, &temp)) {
 			
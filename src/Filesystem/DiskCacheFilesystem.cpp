@@ -0,0 +1,296 @@
+#include "WDBReader/Filesystem/DiskCacheFilesystem.hpp"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace WDBReader::Filesystem {
+
+	namespace {
+		constexpr const char* META_EXTENSION = ".meta";
+		constexpr const char* TEMP_EXTENSION = ".tmp";
+
+		struct MetaData {
+			uint64_t size;
+			uint64_t hash;
+		};
+	}
+
+	DiskCache::DiskCache(const std::filesystem::path& root, uint64_t max_bytes, bool verify) :
+		_root(root), _max_bytes(max_bytes), _verify(verify),
+		_generation(0), _total_bytes(0), _hits(0), _misses(0), _evictions(0), _corrupted(0), _temp_sequence(0)
+	{
+		std::filesystem::create_directories(_root);
+
+		struct Found {
+			Entry entry;
+			std::filesystem::file_time_type accessed;
+		};
+
+		std::vector<Found> found;
+
+		for (const auto& dir_entry : std::filesystem::recursive_directory_iterator(_root)) {
+			if (!dir_entry.is_regular_file() || dir_entry.path().extension() != META_EXTENSION) {
+				continue;
+			}
+
+			MetaData meta;
+			std::ifstream meta_stream(dir_entry.path(), std::ios::binary);
+			if (!meta_stream.read(reinterpret_cast<char*>(&meta), sizeof(meta))) {
+				continue;
+			}
+
+			auto data_path = dir_entry.path();
+			data_path.replace_extension();
+
+			std::error_code ec;
+			if (std::filesystem::file_size(data_path, ec) != meta.size || ec) {
+				continue;
+			}
+
+			found.push_back({
+				Entry{ std::filesystem::relative(data_path, _root).generic_string(), meta.size, meta.hash, 0, false },
+				dir_entry.last_write_time()
+			});
+		}
+
+		std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) {
+			return a.accessed > b.accessed;
+		});
+
+		for (auto& item : found) {
+			item.entry.generation = ++_generation;
+			_total_bytes += item.entry.size;
+			_entries.push_back(std::move(item.entry));
+			_lookup.emplace(_entries.back().key, std::prev(_entries.end()));
+		}
+
+		evict();
+	}
+
+	std::unique_ptr<MappedFileSource> DiskCache::find(const std::string& key)
+	{
+		Entry entry;
+		{
+			std::scoped_lock lock(_mutex);
+
+			auto found = _lookup.find(key);
+			if (found == _lookup.end()) {
+				_misses++;
+				return nullptr;
+			}
+
+			entry = *found->second;
+		}
+
+		// mapped and hashed without the lock, so a large entry doesnt hold up other lookups.
+		std::unique_ptr<MappedFileSource> source;
+
+		try {
+			source = std::make_unique<MappedFileSource>(dataPath(key));
+		}
+		catch (const WDBReaderException&) {
+			source = nullptr;
+		}
+
+		const bool valid = source != nullptr &&
+			source->size() == entry.size &&
+			(!_verify || entry.verified || hash(source->data(), source->size()) == entry.hash);
+
+		std::scoped_lock lock(_mutex);
+
+		// the entry may have been replaced or removed meanwhile, only the one which was checked is updated.
+		auto found = _lookup.find(key);
+		const bool unchanged = found != _lookup.end() && found->second->generation == entry.generation;
+
+		if (!valid) {
+			source.reset();
+			_corrupted++;
+			_misses++;
+			if (unchanged) {
+				eraseEntry(found->second);
+			}
+			return nullptr;
+		}
+
+		if (unchanged) {
+			found->second->verified = true;
+			_entries.splice(_entries.begin(), _entries, found->second);
+
+			// access time is kept on the meta file, so the LRU order survives restarts.
+			std::error_code ec;
+			std::filesystem::last_write_time(metaPath(key), std::filesystem::file_time_type::clock::now(), ec);
+		}
+
+		_hits++;
+		return source;
+	}
+
+	std::unique_ptr<MappedFileSource> DiskCache::insert(const std::string& key, const void* data, uint64_t size)
+	{
+		if (key.empty() || key.find("..") != std::string::npos || std::filesystem::path(key).has_root_path()) {
+			throw WDBReaderException("Invalid cache key.");
+		}
+
+		const MetaData meta{ size, hash(data, size) };
+		const auto data_path = dataPath(key);
+
+		// written to a uniquely named temporary file without the lock, so a large entry doesnt hold up other lookups,
+		// concurrent inserts of the same key dont share a file, and a partially written entry is never picked up.
+		std::filesystem::create_directories(data_path.parent_path());
+
+		auto temp_path = data_path;
+		temp_path += "." + std::to_string(++_temp_sequence) + TEMP_EXTENSION;
+		{
+			std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+			stream.write(reinterpret_cast<const char*>(data), size);
+			if (!stream) {
+				stream.close();
+				std::error_code ec;
+				std::filesystem::remove(temp_path, ec);
+				throw WDBReaderException("Unable to write cache file.");
+			}
+		}
+
+		std::scoped_lock lock(_mutex);
+
+		auto existing = _lookup.find(key);
+		if (existing != _lookup.end()) {
+			eraseEntry(existing->second);
+		}
+
+		// fails when the old file couldnt be removed (still mapped on windows), any entry for it is still indexed.
+		std::error_code rename_error;
+		std::filesystem::rename(temp_path, data_path, rename_error);
+		if (rename_error) {
+			std::error_code ec;
+			std::filesystem::remove(temp_path, ec);
+			throw WDBReaderException("Unable to replace cache file.");
+		}
+
+		{
+			std::ofstream stream(metaPath(key), std::ios::binary | std::ios::trunc);
+			stream.write(reinterpret_cast<const char*>(&meta), sizeof(meta));
+			if (!stream) {
+				stream.close();
+				std::error_code ec;
+				std::filesystem::remove(data_path, ec);
+				std::filesystem::remove(metaPath(key), ec);
+				throw WDBReaderException("Unable to write cache meta file.");
+			}
+		}
+
+		// the rename replaced the old file even if it couldnt be removed beforehand.
+		if (auto replaced = _lookup.find(key); replaced != _lookup.end()) {
+			_total_bytes -= replaced->second->size;
+			_entries.erase(replaced->second);
+			_lookup.erase(replaced);
+		}
+
+		// written from the data which was just hashed, so doesnt need checking again.
+		_entries.push_front(Entry{ key, meta.size, meta.hash, ++_generation, true });
+		_lookup[key] = _entries.begin();
+		_total_bytes += size;
+
+		auto source = std::make_unique<MappedFileSource>(data_path);
+
+		evict();
+
+		return source;
+	}
+
+	void DiskCache::remove(const std::string& key)
+	{
+		std::scoped_lock lock(_mutex);
+
+		auto found = _lookup.find(key);
+		if (found != _lookup.end()) {
+			eraseEntry(found->second);
+		}
+	}
+
+	void DiskCache::clear()
+	{
+		std::scoped_lock lock(_mutex);
+
+		for (auto it = _entries.begin(); it != _entries.end();) {
+			eraseEntry(it++);
+		}
+	}
+
+	DiskCache::Stats DiskCache::stats() const
+	{
+		std::scoped_lock lock(_mutex);
+		return {
+			_hits,
+			_misses,
+			_evictions,
+			_corrupted,
+			_total_bytes,
+			_entries.size()
+		};
+	}
+
+	uint64_t DiskCache::hash(const void* data, uint64_t size)
+	{
+		constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+		constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		uint64_t result = FNV_OFFSET;
+		for (uint64_t i = 0; i < size; i++) {
+			result ^= bytes[i];
+			result *= FNV_PRIME;
+		}
+
+		return result;
+	}
+
+	std::filesystem::path DiskCache::dataPath(const std::string& key) const
+	{
+		return _root / std::filesystem::path(key);
+	}
+
+	std::filesystem::path DiskCache::metaPath(const std::string& key) const
+	{
+		auto path = dataPath(key);
+		path += META_EXTENSION;
+		return path;
+	}
+
+	bool DiskCache::eraseEntry(entry_list_t::iterator it)
+	{
+		// removal fails while a file is still mapped (windows), the entry is then kept, as its bytes are still on disk.
+		std::error_code ec;
+		std::filesystem::remove(dataPath(it->key), ec);
+		if (ec) {
+			return false;
+		}
+
+		std::filesystem::remove(metaPath(it->key), ec);
+
+		_total_bytes -= it->size;
+		_lookup.erase(it->key);
+		_entries.erase(it);
+		return true;
+	}
+
+	void DiskCache::evict()
+	{
+		if (_max_bytes == UNLIMITED) {
+			return;
+		}
+
+		if (_entries.empty()) {
+			return;
+		}
+
+		// the most recent entry is always kept, even if it alone exceeds the limit. Entries which cant be removed yet are skipped.
+		auto it = std::prev(_entries.end());
+		while (_total_bytes > _max_bytes && it != _entries.begin()) {
+			if (eraseEntry(it--)) {
+				_evictions++;
+			}
+		}
+	}
+}
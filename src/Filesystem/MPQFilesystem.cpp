@@ -48,6 +48,7 @@ namespace WDBReader::Filesystem {
 
 	std::unique_ptr<MPQFileSource> MPQFilesystem::open(MPQFileUri uri)
 	{
+		WDBREADER_TRACE_SCOPE("filesystem", "MPQFilesystem::open", uri);
 		HANDLE temp;
 		for (const auto& mpq : _archives) {
 			if (SFileOpenFileEx(mpq.second.get(), uri.c_str(), SFILE_OPEN_FROM_MPQ, &temp)) {
@@ -0,0 +1,110 @@
+#include "WDBReader/Filesystem/MappedFilesystem.hpp"
+#include "WDBReader/Utility.hpp"
+
+#ifdef WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace WDBReader::Filesystem {
+
+#ifdef WIN32
+
+    MappedFileSource::MappedFileSource(const std::filesystem::path& path) :
+        _data(nullptr), _size(0), _pos(0), _file_handle(INVALID_HANDLE_VALUE), _mapping_handle(nullptr)
+    {
+        _file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file_handle == INVALID_HANDLE_VALUE) {
+            throw WDBReaderException("Unable to open mapped file.", GetLastError());
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(_file_handle, &file_size)) {
+            const auto error = GetLastError();
+            CloseHandle(_file_handle);
+            throw WDBReaderException("Unable to get mapped file size.", error);
+        }
+
+        _size = static_cast<size_t>(file_size.QuadPart);
+
+        if (_size > 0) {
+            _mapping_handle = CreateFileMappingW(_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping_handle == nullptr) {
+                const auto error = GetLastError();
+                CloseHandle(_file_handle);
+                throw WDBReaderException("Unable to create file mapping.", error);
+            }
+
+            _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+            if (_data == nullptr) {
+                const auto error = GetLastError();
+                CloseHandle(_mapping_handle);
+                CloseHandle(_file_handle);
+                throw WDBReaderException("Unable to map file view.", error);
+            }
+        }
+    }
+
+    MappedFileSource::~MappedFileSource()
+    {
+        if (_data != nullptr) {
+            UnmapViewOfFile(_data);
+        }
+
+        if (_mapping_handle != nullptr) {
+            CloseHandle(_mapping_handle);
+        }
+
+        if (_file_handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(_file_handle);
+        }
+    }
+
+#else
+
+    MappedFileSource::MappedFileSource(const std::filesystem::path& path) :
+        _data(nullptr), _size(0), _pos(0)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw WDBReaderException("Unable to open mapped file.", errno);
+        }
+
+        auto fd_guard = ScopeGuard([fd]() {
+            ::close(fd);
+        });
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0) {
+            throw WDBReaderException("Unable to get mapped file size.", errno);
+        }
+
+        _size = static_cast<size_t>(file_stat.st_size);
+
+        if (_size > 0) {
+            void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                throw WDBReaderException("Unable to map file.", errno);
+            }
+
+            _data = static_cast<const uint8_t*>(mapped);
+        }
+    }
+
+    MappedFileSource::~MappedFileSource()
+    {
+        if (_data != nullptr) {
+            munmap(const_cast<uint8_t*>(_data), _size);
+        }
+    }
+
+#endif
+
+}
@@ -2,11 +2,102 @@
 
 #include <algorithm>
 #include <cassert>
+#include <charconv>
 #include <format>
+#include <fstream>
+#include <iterator>
 #include <ranges>
 
 namespace WDBReader::WoWDBDefs {
 
+	namespace {
+		std::string readAll(std::istream& stream) {
+			std::string buffer;
+
+			stream.seekg(0, std::ios::end);
+			const auto size = stream.tellg();
+			stream.seekg(0, std::ios::beg);
+
+			if (size >= 0 && !stream.fail()) {
+				buffer.resize(static_cast<size_t>(size));
+				stream.read(buffer.data(), size);
+				// text mode line ending conversion can read less than the size.
+				buffer.resize(static_cast<size_t>(stream.gcount()));
+			}
+			else {
+				stream.clear();
+				buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+			}
+
+			return buffer;
+		}
+
+		/// <summary>
+		/// Splits a buffer on '\n' the way repeated std::getline calls until eof would, including a final empty line after a trailing newline.
+		/// </summary>
+		class LineReader final {
+		public:
+			LineReader(std::string_view buffer) : _buffer(buffer), _pos(0), _done(false) {}
+
+			std::optional<std::string_view> next() {
+				if (_done) {
+					return std::nullopt;
+				}
+
+				const auto end = _buffer.find('\n', _pos);
+				if (end == _buffer.npos) {
+					_done = true;
+					return _buffer.substr(_pos);
+				}
+
+				const auto line = _buffer.substr(_pos, end - _pos);
+				_pos = end + 1;
+				return line;
+			}
+
+			inline bool done() const {
+				return _done;
+			}
+
+		private:
+			std::string_view _buffer;
+			size_t _pos;
+			bool _done;
+		};
+
+		std::string_view trimView(std::string_view str, std::string_view chars = " \t\n\r\f\v") {
+			const auto first = str.find_first_not_of(chars);
+			if (first == str.npos) {
+				return {};
+			}
+			return str.substr(first, str.find_last_not_of(chars) - first + 1);
+		}
+
+		std::string_view afterKeyword(std::string_view line, size_t length) {
+			return line.substr(std::min(length, line.size()));
+		}
+
+		/// <summary>
+		/// Calls fn(part) for each part as split_string would give them, without the copies.
+		/// </summary>
+		template<typename Fn>
+		void forEachPart(std::string_view input, std::string_view separator, Fn fn) {
+			if (input.empty()) {
+				return;
+			}
+
+			size_t start = 0;
+			auto end = input.find(separator);
+			while (end != input.npos) {
+				fn(input.substr(start, end - start));
+				start = end + separator.size();
+				end = input.find(separator, start);
+			}
+
+			fn(input.substr(start));
+		}
+	}
+
 	const std::array<std::string, 4> DBDReader::ValidTypes { 
 		"int", 
 		"float", 
@@ -20,21 +111,23 @@ namespace WDBReader::WoWDBDefs {
 		assert(stream.tellg() == 0);
 
 		// based on https://github.com/wowdev/WoWDBDefs/blob/master/code/C%23/DBDefsLib/DBDReader.cs
+		// the file is read into a single buffer and tokenized with views, only the stored names and comments are copied.
+
+		const std::string buffer = readAll(stream);
+		LineReader lines(buffer);
 
 		DBDefinition db_definition;
 
-		std::string first_line;
 		auto line_number = 1;
-		std::getline(stream, first_line);
+		const auto first_line = lines.next();
 
 		if (first_line != "COLUMNS") {
 			throw std::runtime_error("File does not start with column definitions!");
 		}
 
-		while (!stream.eof()) {
+		while (!lines.done()) {
 			line_number++;
-			std::string line;
-			std::getline(stream, line);
+			const std::string_view line = *lines.next();
 
 			// Column definitions are done after encountering a newline
 			if (line.find_first_not_of(' ') == line.npos) {
@@ -51,7 +144,7 @@ namespace WDBReader::WoWDBDefs {
 
 			const auto type_pos = line.find_first_of(" <");
 			assert(type_pos != line.npos);
-			auto type = line.substr(0, type_pos);
+			const auto type = line.substr(0, type_pos);
 			
 			if (std::ranges::find(ValidTypes, type) == ValidTypes.end()) {
 				throw std::runtime_error(std::format("Invalid type: {} on line {}", type, line_number));
@@ -68,21 +161,21 @@ namespace WDBReader::WoWDBDefs {
 						throw std::runtime_error("Unable to find foriegn key end token.");
 					}
 
-					const auto KEY_SEPARATOR = "::";
-					auto foreign_key = line.substr(type_pos + 1, (end_key_pos - type_pos) - 1);
+					constexpr std::string_view KEY_SEPARATOR = "::";
+					const auto foreign_key = line.substr(type_pos + 1, (end_key_pos - type_pos) - 1);
 					const auto separator_pos = foreign_key.find(KEY_SEPARATOR);
 					if (separator_pos == line.npos) {
 						throw std::runtime_error("Unable to find foriegn key separator token.");
 					}
 
 					column_definition.foreignTable = foreign_key.substr(0, separator_pos);
-					column_definition.foreignColumn = foreign_key.substr(separator_pos + std::strlen(KEY_SEPARATOR));
+					column_definition.foreignColumn = foreign_key.substr(separator_pos + KEY_SEPARATOR.size());
 				}
 			}
 
 			/* NAME READING */
 			const auto next_space_pos = line.find_first_of(' ', first_space_pos + 1);
-			std::string name = "";
+			std::string_view name;
 			if (next_space_pos == line.npos) {
 				name = line.substr(first_space_pos + 1);
 			}
@@ -93,24 +186,22 @@ namespace WDBReader::WoWDBDefs {
 
 			if (name.ends_with('?')) {
 				column_definition.verified = false;
-				name.pop_back();
+				name.remove_suffix(1);
 			}
 			else {
 				column_definition.verified = true;
 			}
 
-			const auto COMMENT_SEPARATOR = "//";
-			auto comment_pos = line.find("//");
+			constexpr std::string_view COMMENT_SEPARATOR = "//";
+			const auto comment_pos = line.find(COMMENT_SEPARATOR);
 			if (comment_pos != line.npos) {
-				column_definition.comment = trim(line.substr(comment_pos + std::strlen(COMMENT_SEPARATOR)));
+				column_definition.comment = trimView(line.substr(comment_pos + COMMENT_SEPARATOR.size()));
 			}
 
-			if (db_definition.columnDefinitions.contains(name)) {
+			const auto [it, inserted] = db_definition.columnDefinitions.try_emplace(std::string(name), std::move(column_definition));
+			if (!inserted) {
 				throw std::runtime_error(std::format("Column name '{}' already exists.", name));
 			}
-			else {
-				db_definition.columnDefinitions.emplace(name, column_definition);
-			}
 		}
 
 		std::vector<Definition> defintions;
@@ -122,11 +213,11 @@ namespace WDBReader::WoWDBDefs {
 		auto try_push_version_definition = [&]() {
 			if (builds.size() != 0 || build_ranges.size() != 0 || layout_hashes.size() != 0) {
 				VersionDefinitions ver_defs;
-				ver_defs.builds = builds;
-				ver_defs.buildRanges = build_ranges;
-				ver_defs.layoutHashes = layout_hashes;
-				ver_defs.comment = comment;
-				ver_defs.definitions = defintions;
+				ver_defs.builds = std::move(builds);
+				ver_defs.buildRanges = std::move(build_ranges);
+				ver_defs.layoutHashes = std::move(layout_hashes);
+				ver_defs.comment = std::move(comment);
+				ver_defs.definitions = std::move(defintions);
 
 				db_definition.versionDefinitions.push_back(std::move(ver_defs));
 			}
@@ -136,16 +227,25 @@ namespace WDBReader::WoWDBDefs {
 
 			defintions.clear();
 			layout_hashes.clear();
-			comment = "";
+			comment.clear();
 			builds.clear();
 			build_ranges.clear();
 		};
 
+		auto parse_build = [](std::string_view str) {
+			const auto build = Build::fromString(str);
+			if (!build.has_value()) {
+				throw std::runtime_error("Build string is invalid.");
+			}
+			return *build;
+		};
+
+		// definition lines have their annotations removed in place, the buffer is reused between lines.
+		std::string definition_line;
 
-		while (!stream.eof()) {
+		while (!lines.done()) {
 			line_number++;
-			std::string line;
-			std::getline(stream, line);
+			const std::string_view line = *lines.next();
 
 			const bool is_line_empty_or_whitespace = line.find_first_not_of(' ') == line.npos;
 
@@ -153,38 +253,34 @@ namespace WDBReader::WoWDBDefs {
 				try_push_version_definition();
 			}
 
-			constexpr auto KEYWORD_LAYOUT = "LAYOUT";
-			constexpr auto KEYWORD_BUILD = "BUILD";
-			constexpr auto KEYWORD_COMMENT = "COMMENT";
+			constexpr std::string_view KEYWORD_LAYOUT = "LAYOUT";
+			constexpr std::string_view KEYWORD_BUILD = "BUILD";
+			constexpr std::string_view KEYWORD_COMMENT = "COMMENT";
 
 			if (line.starts_with(KEYWORD_LAYOUT)) {
-
-				auto hashes_full = line.substr(std::strlen(KEYWORD_LAYOUT) + 1);
-				auto hashes_split = split_string(hashes_full, ", ");
-				layout_hashes.insert(layout_hashes.end(), hashes_split.begin(), hashes_split.end());
+				forEachPart(afterKeyword(line, KEYWORD_LAYOUT.size() + 1), ", ", [&](std::string_view hash) {
+					layout_hashes.emplace_back(hash);
+				});
 			}
 			else if (line.starts_with(KEYWORD_BUILD)) {
-				auto builds_full = line.substr(std::strlen(KEYWORD_BUILD) + 1);
-				auto builds_split = split_string(builds_full, ", ");
-				for (const auto& build_str : builds_split) {
+				forEachPart(afterKeyword(line, KEYWORD_BUILD.size() + 1), ", ", [&](std::string_view build_str) {
 					const auto range_sep_pos = build_str.find_first_of('-');
 					if (range_sep_pos != build_str.npos) {
-						auto str_min = build_str.substr(0, range_sep_pos);
-						auto str_max = build_str.substr(range_sep_pos + 1);
-						build_ranges.emplace_back(Build(str_min), Build(str_max));
+						build_ranges.emplace_back(parse_build(build_str.substr(0, range_sep_pos)), parse_build(build_str.substr(range_sep_pos + 1)));
 					}
 					else {
-						builds.emplace_back(build_str);
+						builds.push_back(parse_build(build_str));
 					}
-				}
+				});
 			}
 			else if (line.starts_with(KEYWORD_COMMENT)) {
-				comment = trim(line.substr(std::strlen(KEYWORD_COMMENT)));
+				comment = trimView(line.substr(KEYWORD_COMMENT.size()));
 			}
 			else if (!is_line_empty_or_whitespace) {
 
 				Definition def;
 				def.isNonInline = false;
+				definition_line.assign(line);
 
 				auto extract_between_tokens = [](std::string& str, char start_token, char end_token, auto callback) {
 					const auto start_pos = str.find_first_of(start_token);
@@ -194,30 +290,27 @@ namespace WDBReader::WoWDBDefs {
 							throw std::runtime_error("End token is missing.");
 						}
 
-						auto temp = str.substr(start_pos + 1, (end_pos - start_pos) - 1);
-						callback(temp);
+						callback(std::string_view(str).substr(start_pos + 1, (end_pos - start_pos) - 1));
 
 						str.erase(start_pos, (end_pos - start_pos) + 1);
 					}
 				};
 
-				extract_between_tokens(line, '$', '$', [&](const std::string& str) {
-					auto annotations = split_string(str, ",");
-
-					if (std::ranges::any_of(annotations, [](const auto& e) { return e == "id"; })) {
-						def.isID = true;
-					}
-
-					if (std::ranges::any_of(annotations, [](const auto& e) { return e == "noninline"; })) {
-						def.isNonInline = true;
-					}
-
-					if (std::ranges::any_of(annotations, [](const auto& e) { return e == "relation"; })) {
-						def.isRelation = true;
-					}
+				extract_between_tokens(definition_line, '$', '$', [&](std::string_view str) {
+					forEachPart(str, ",", [&](std::string_view annotation) {
+						if (annotation == "id") {
+							def.isID = true;
+						}
+						else if (annotation == "noninline") {
+							def.isNonInline = true;
+						}
+						else if (annotation == "relation") {
+							def.isRelation = true;
+						}
+					});
 				});
 
-				extract_between_tokens(line, '<', '>', [&](const std::string& str) {
+				extract_between_tokens(definition_line, '<', '>', [&](std::string_view str) {
 					if (str.length() > 0 && str[0] == 'u') {
 						def.isSigned = false;
 						std::from_chars(str.data() + 1, (str.data() + 1 + str.length()) - 1, def.size);
@@ -228,23 +321,24 @@ namespace WDBReader::WoWDBDefs {
 					}
 				});
 		
-				extract_between_tokens(line, '[', ']', [&](const std::string& str) {
+				extract_between_tokens(definition_line, '[', ']', [&](std::string_view str) {
 					std::from_chars(str.data(), str.data() + str.size(), def.arrLength);
 				});
 
-				def.name = line;
+				def.name = definition_line;
 
-				if (!db_definition.columnDefinitions.contains(def.name)) {
+				const auto column = db_definition.columnDefinitions.find(def.name);
+				if (column == db_definition.columnDefinitions.end()) {
 					throw std::runtime_error(std::format("Unable to find {} in column definitions!", def.name));
 				}
 				else {
 					// Temporary unsigned format update conversion code
-					if (db_definition.columnDefinitions[def.name].type == "uint") {
+					if (column->second.type == "uint") {
 						def.isSigned = false;
 					}
 				}
 
-				defintions.push_back(def);
+				defintions.push_back(std::move(def));
 			}
 		}
 
@@ -253,43 +347,55 @@ namespace WDBReader::WoWDBDefs {
 		return db_definition;
 	}
 
-	std::optional<Database::RuntimeSchema> makeSchema(const DBDefinition& db_definition, const GameVersion& target_version) {
+	std::optional<uint32_t> parseLayoutHash(std::string_view layout) {
+		uint32_t hash = 0;
+		const auto [ptr, ec] = std::from_chars(layout.data(), layout.data() + layout.size(), hash, 16);
+		if (ec != std::errc() || ptr != layout.data() + layout.size()) {
+			return std::nullopt;
+		}
+		return hash;
+	}
 
-        auto build_schema = [&db_definition](const std::vector<Definition>& definitions) -> Database::RuntimeSchema {
-            std::vector<Database::RuntimeSchema::field_name_t> names;
-            names.reserve(definitions.size());
-            std::vector<Database::Field> fields;
-            fields.reserve(definitions.size());
-
-            for (const auto& def : definitions) {
-                names.push_back(def.name);
-
-                const auto& type_str = db_definition.columnDefinitions.at(def.name).type;
-                const auto ann = Database::Annotation(def.isID, def.isRelation, !def.isNonInline, def.isSigned);
-
-				using array_size_t = decltype(Database::Field::size);
-				assert(def.arrLength < std::numeric_limits<array_size_t>::max());
-                const auto array_size = static_cast<array_size_t>(std::max(1, def.arrLength));
-
-                if (type_str == "int") {
-                    fields.push_back(Database::Field::integerArray((def.size / 8) * array_size, array_size, ann));
-                }
-                else if (type_str == "float") {
-                    fields.push_back(Database::Field::floatingPointArray(sizeof(float) * array_size, array_size, ann));
-                }
-                else if (type_str == "string") {
-                    fields.push_back(Database::Field::string(array_size, ann));
-                }
-                else if (type_str == "locstring") {
-                    fields.push_back(Database::Field::langString(array_size, ann));
-                }
-                else {
-                    throw std::runtime_error("Unexpected field type: " + type_str);
-                }
-            }
+	Database::Field makeField(std::string_view type, int32_t size, int32_t array_length, const Database::Annotation& annotation) {
+		using array_size_t = decltype(Database::Field::size);
+		assert(array_length < std::numeric_limits<array_size_t>::max());
+		const auto array_size = static_cast<array_size_t>(std::max(1, array_length));
+
+		if (type == "int") {
+			return Database::Field::integerArray((size / 8) * array_size, array_size, annotation);
+		}
+		else if (type == "float") {
+			return Database::Field::floatingPointArray(sizeof(float) * array_size, array_size, annotation);
+		}
+		else if (type == "string") {
+			return Database::Field::string(array_size, annotation);
+		}
+		else if (type == "locstring") {
+			return Database::Field::langString(array_size, annotation);
+		}
+
+		throw std::runtime_error("Unexpected field type: " + std::string(type));
+	}
+
+	Database::RuntimeSchema makeSchema(const DBDefinition& db_definition, const VersionDefinitions& version_definition) {
+        const auto& definitions = version_definition.definitions;
+        std::vector<Database::RuntimeSchema::field_name_t> names;
+        names.reserve(definitions.size());
+        std::vector<Database::Field> fields;
+        fields.reserve(definitions.size());
+
+        for (const auto& def : definitions) {
+            names.push_back(def.name);
 
-            return Database::RuntimeSchema(std::move(fields), std::move(names));
-        };
+            const auto& type_str = db_definition.columnDefinitions.at(def.name).type;
+            const auto ann = Database::Annotation(def.isID, def.isRelation, !def.isNonInline, def.isSigned);
+            fields.push_back(makeField(type_str, def.size, def.arrLength, ann));
+        }
+
+        return Database::RuntimeSchema(std::move(fields), std::move(names));
+	}
+
+	std::optional<Database::RuntimeSchema> makeSchema(const DBDefinition& db_definition, const GameVersion& target_version) {
 
         for (const auto& version_def : db_definition.versionDefinitions) {
             bool matched = std::ranges::find(version_def.builds, target_version) != version_def.builds.end();
@@ -301,11 +407,257 @@ namespace WDBReader::WoWDBDefs {
             }
 
             if (matched) {
-                return build_schema(version_def.definitions);
+                return makeSchema(db_definition, version_def);
             }
         }
 
         return std::nullopt;
 	}
 
-}
\ No newline at end of file
+	std::optional<Database::RuntimeSchema> makeSchemaForLayout(const DBDefinition& db_definition, uint32_t layout_hash) {
+		for (const auto& version_def : db_definition.versionDefinitions) {
+			const bool matched = std::ranges::any_of(version_def.layoutHashes, [layout_hash](const std::string& layout) {
+				return parseLayoutHash(layout) == layout_hash;
+			});
+
+			if (matched) {
+				return makeSchema(db_definition, version_def);
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	DefinitionRegistry::Table::Table(DBDefinition def) : definition(std::move(def)) {
+		const auto& versions = definition.versionDefinitions;
+		cache.resize(versions.size());
+
+		for (size_t v = 0; v < versions.size(); v++) {
+			for (const auto& build : versions[v].builds) {
+				builds.emplace_back(build, v);
+			}
+
+			for (const auto& layout : versions[v].layoutHashes) {
+				const auto hash = parseLayoutHash(layout);
+				if (hash.has_value()) {
+					layouts.emplace_back(*hash, v);
+				}
+			}
+
+			for (const auto& range : versions[v].buildRanges) {
+				rangeBoundaries.push_back({ range.minBuild, 0 });
+				rangeBoundaries.push_back({ range.maxBuild, 1 });
+			}
+		}
+
+		// stable, so the first version is kept for duplicates.
+		auto first_per_key = [](auto& pairs) {
+			std::ranges::stable_sort(pairs, {}, [](const auto& pair) { return pair.first; });
+			const auto [first, last] = std::ranges::unique(pairs, {}, [](const auto& pair) { return pair.first; });
+			pairs.erase(first, last);
+		};
+		first_per_key(builds);
+		first_per_key(layouts);
+
+		std::ranges::sort(rangeBoundaries);
+		rangeBoundaries.erase(std::unique(rangeBoundaries.begin(), rangeBoundaries.end()), rangeBoundaries.end());
+
+		// segment s holds builds with exactly s boundaries below them, a range covers the segments after its start up to its end.
+		rangeVersions.assign(rangeBoundaries.size() + 1, NO_VERSION);
+		auto boundary_index = [this](const RangeBoundary& boundary) {
+			return static_cast<size_t>(std::ranges::lower_bound(rangeBoundaries, boundary) - rangeBoundaries.begin());
+		};
+
+		for (size_t v = 0; v < versions.size(); v++) {
+			for (const auto& range : versions[v].buildRanges) {
+				const auto end = boundary_index({ range.maxBuild, 1 });
+				for (size_t segment = boundary_index({ range.minBuild, 0 }) + 1; segment <= end; segment++) {
+					if (rangeVersions[segment] == NO_VERSION) {
+						rangeVersions[segment] = v;
+					}
+				}
+			}
+		}
+	}
+
+	std::optional<size_t> DefinitionRegistry::Table::versionIndex(const Build& build) const {
+		size_t result = NO_VERSION;
+
+		const auto exact = std::ranges::lower_bound(builds, build, {}, [](const auto& pair) { return pair.first; });
+		if (exact != builds.end() && exact->first == build) {
+			result = exact->second;
+		}
+
+		const auto segment = static_cast<size_t>(std::ranges::lower_bound(rangeBoundaries, RangeBoundary{ build, 1 }) - rangeBoundaries.begin());
+		result = std::min(result, rangeVersions[segment]);
+
+		if (result == NO_VERSION) {
+			return std::nullopt;
+		}
+		return result;
+	}
+
+	std::optional<size_t> DefinitionRegistry::Table::versionIndexForLayout(uint32_t layout_hash) const {
+		const auto found = std::ranges::lower_bound(layouts, layout_hash, {}, [](const auto& pair) { return pair.first; });
+		if (found != layouts.end() && found->first == layout_hash) {
+			return found->second;
+		}
+		return std::nullopt;
+	}
+
+	std::shared_ptr<const Database::RuntimeSchema> DefinitionRegistry::Table::schema(size_t version_index) const {
+		{
+			std::scoped_lock lock(cacheMutex);
+			if (cache[version_index] != nullptr) {
+				return cache[version_index];
+			}
+		}
+
+		auto built = std::make_shared<const Database::RuntimeSchema>(makeSchema(definition, definition.versionDefinitions[version_index]));
+
+		std::scoped_lock lock(cacheMutex);
+		if (cache[version_index] == nullptr) {
+			cache[version_index] = std::move(built);
+		}
+		return cache[version_index];
+	}
+
+	DefinitionRegistry::DefinitionRegistry(const std::filesystem::path& definitions_dir, ThreadPool* pool) {
+		std::vector<std::filesystem::path> paths;
+		for (const auto& entry : std::filesystem::directory_iterator(definitions_dir)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".dbd") {
+				paths.push_back(entry.path());
+			}
+		}
+		std::ranges::sort(paths);
+
+		std::vector<std::unique_ptr<Table>> tables(paths.size());
+		std::vector<std::string> errors(paths.size());
+
+		auto read_file = [&](size_t index) {
+			try {
+				std::ifstream stream(paths[index], std::ios::binary);
+				if (!stream) {
+					throw std::runtime_error("Unable to open file.");
+				}
+				tables[index] = std::make_unique<Table>(DBDReader::read(stream));
+			}
+			catch (const std::exception& e) {
+				errors[index] = e.what();
+			}
+		};
+
+		if (pool != nullptr) {
+			pool->parallelFor(paths.size(), read_file);
+		}
+		else {
+			for (size_t i = 0; i < paths.size(); i++) {
+				read_file(i);
+			}
+		}
+
+		for (size_t i = 0; i < paths.size(); i++) {
+			auto name = paths[i].stem().string();
+			if (tables[i] != nullptr) {
+				_tables.emplace(std::move(name), std::move(tables[i]));
+			}
+			else {
+				_failures.push_back({ std::move(name), std::move(errors[i]) });
+			}
+		}
+
+		rebuildLayouts();
+	}
+
+	void DefinitionRegistry::add(const std::string& name, DBDefinition definition) {
+		const auto [it, inserted] = _tables.insert_or_assign(name, std::make_unique<Table>(std::move(definition)));
+		if (!inserted) {
+			rebuildLayouts();
+			return;
+		}
+
+		for (const auto& [hash, version] : it->second->layouts) {
+			const LayoutEntry entry{ &it->first, it->second.get(), version };
+			const auto [layout, layout_inserted] = _layouts.try_emplace(hash, entry);
+			if (!layout_inserted && it->first < *layout->second.name) {
+				layout->second = entry;
+			}
+		}
+	}
+
+	void DefinitionRegistry::rebuildLayouts() {
+		_layouts.clear();
+		for (const auto& [name, table] : _tables) {
+			for (const auto& [hash, version] : table->layouts) {
+				_layouts.try_emplace(hash, LayoutEntry{ &name, table.get(), version });
+			}
+		}
+	}
+
+	const DefinitionRegistry::Table* DefinitionRegistry::find(std::string_view name) const {
+		const auto found = _tables.find(name);
+		return found != _tables.end() ? found->second.get() : nullptr;
+	}
+
+	bool DefinitionRegistry::contains(std::string_view name) const {
+		return find(name) != nullptr;
+	}
+
+	const DBDefinition* DefinitionRegistry::definition(std::string_view name) const {
+		const auto* table = find(name);
+		return table != nullptr ? &table->definition : nullptr;
+	}
+
+	std::vector<std::string> DefinitionRegistry::names() const {
+		std::vector<std::string> result;
+		result.reserve(_tables.size());
+		for (const auto& [name, table] : _tables) {
+			result.push_back(name);
+		}
+		return result;
+	}
+
+	std::optional<size_t> DefinitionRegistry::versionIndex(std::string_view name, const Build& build) const {
+		const auto* table = find(name);
+		return table != nullptr ? table->versionIndex(build) : std::nullopt;
+	}
+
+	std::optional<size_t> DefinitionRegistry::versionIndexForLayout(std::string_view name, uint32_t layout_hash) const {
+		const auto* table = find(name);
+		return table != nullptr ? table->versionIndexForLayout(layout_hash) : std::nullopt;
+	}
+
+	std::shared_ptr<const Database::RuntimeSchema> DefinitionRegistry::schema(std::string_view name, const Build& build) const {
+		const auto* table = find(name);
+		if (table == nullptr) {
+			return nullptr;
+		}
+
+		const auto index = table->versionIndex(build);
+		return index.has_value() ? table->schema(*index) : nullptr;
+	}
+
+	std::shared_ptr<const Database::RuntimeSchema> DefinitionRegistry::schemaForLayout(std::string_view name, uint32_t layout_hash) const {
+		const auto* table = find(name);
+		if (table == nullptr) {
+			return nullptr;
+		}
+
+		const auto index = table->versionIndexForLayout(layout_hash);
+		return index.has_value() ? table->schema(*index) : nullptr;
+	}
+
+	std::optional<std::string_view> DefinitionRegistry::tableForLayout(uint32_t layout_hash) const {
+		const auto found = _layouts.find(layout_hash);
+		if (found == _layouts.end()) {
+			return std::nullopt;
+		}
+		return *found->second.name;
+	}
+
+	std::shared_ptr<const Database::RuntimeSchema> DefinitionRegistry::schemaForLayout(uint32_t layout_hash) const {
+		const auto found = _layouts.find(layout_hash);
+		return found != _layouts.end() ? found->second.table->schema(found->second.version) : nullptr;
+	}
+
+}
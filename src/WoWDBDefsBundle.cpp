@@ -0,0 +1,626 @@
+#include "WDBReader/WoWDBDefsBundle.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace WDBReader::WoWDBDefs {
+
+	namespace {
+		enum DefinitionFlags : uint8_t {
+			Id = 0x01,
+			Relation = 0x02,
+			NonInline = 0x04,
+			Signed = 0x08
+		};
+
+		constexpr size_t NO_VERSION = SIZE_MAX;
+
+		BundleBuild packBuild(const Build& build) {
+			return BundleBuild{ build.expansion, build.major, build.minor, 0, build.build };
+		}
+
+		std::pair<Build, uint32_t> boundaryKey(const BundleRangeBoundary& boundary) {
+			return { Build(boundary.build.expansion, boundary.build.major, boundary.build.minor, boundary.build.build), boundary.kind };
+		}
+
+		/// <summary>
+		/// Interns strings into a single pool, names shared across tables are only stored once.
+		/// </summary>
+		class StringPool final {
+		public:
+			BundleString add(std::string_view str) {
+				const auto found = _offsets.find(std::string(str));
+				if (found != _offsets.end()) {
+					return found->second;
+				}
+
+				const BundleString entry{ static_cast<uint32_t>(_bytes.size()), static_cast<uint32_t>(str.size()) };
+				_bytes.insert(_bytes.end(), str.begin(), str.end());
+				_offsets.emplace(str, entry);
+				return entry;
+			}
+
+			inline const std::vector<char>& bytes() const {
+				return _bytes;
+			}
+
+		private:
+			std::vector<char> _bytes;
+			std::unordered_map<std::string, BundleString> _offsets;
+		};
+
+		template<typename T>
+		uint32_t count(const std::vector<T>& items) {
+			if (items.size() > UINT32_MAX) {
+				throw WDBReaderException("Too many definitions for a bundle.");
+			}
+			return static_cast<uint32_t>(items.size());
+		}
+	}
+
+	void writeDefinitionBundle(std::ostream& stream, const DefinitionRegistry& registry) {
+		StringPool strings;
+		std::vector<BundleTable> tables;
+		std::vector<BundleColumn> columns;
+		std::vector<BundleVersion> versions;
+		std::vector<BundleBuild> builds;
+		std::vector<BundleLayout> layouts;
+		std::vector<BundleDefinition> definitions;
+		std::vector<BundleBuildIndexEntry> build_index;
+		std::vector<BundleRangeBoundary> range_boundaries;
+		std::vector<uint32_t> range_segments;
+		std::vector<BundleTableLayoutEntry> table_layouts;
+		std::map<uint32_t, BundleLayoutIndexEntry> layout_index;
+
+		for (const auto& name : registry.names()) {
+			const auto& db_definition = *registry.definition(name);
+
+			BundleTable table{};
+			table.name = strings.add(name);
+			table.column_begin = count(columns);
+			table.version_begin = count(versions);
+			table.build_index_begin = count(build_index);
+
+			std::unordered_map<std::string_view, uint32_t> column_indexes;
+			for (const auto& [column_name, column] : db_definition.columnDefinitions) {
+				column_indexes.emplace(column_name, count(columns) - table.column_begin);
+
+				BundleColumn entry{};
+				entry.name = strings.add(column_name);
+				entry.type = strings.add(column.type);
+				entry.foreign_table = strings.add(column.foreignTable);
+				entry.foreign_column = strings.add(column.foreignColumn);
+				entry.comment = strings.add(column.comment);
+				entry.verified = column.verified ? 1 : 0;
+				columns.push_back(entry);
+			}
+
+			std::vector<BundleBuildIndexEntry> table_builds;
+			std::vector<BundleRangeBoundary> table_boundaries;
+			std::vector<BundleTableLayoutEntry> table_layout_entries;
+			for (const auto& version_definition : db_definition.versionDefinitions) {
+				const auto version_index = count(versions) - table.version_begin;
+
+				BundleVersion version{};
+				version.comment = strings.add(version_definition.comment);
+
+				version.build_begin = count(builds);
+				version.build_count = count(version_definition.builds);
+				for (const auto& build : version_definition.builds) {
+					builds.push_back(packBuild(build));
+					table_builds.push_back({ packBuild(build), version_index });
+				}
+
+				version.range_begin = count(builds);
+				version.range_count = count(version_definition.buildRanges);
+				for (const auto& range : version_definition.buildRanges) {
+					builds.push_back(packBuild(range.minBuild));
+					builds.push_back(packBuild(range.maxBuild));
+					table_boundaries.push_back({ packBuild(range.minBuild), 0 });
+					table_boundaries.push_back({ packBuild(range.maxBuild), 1 });
+				}
+
+				version.layout_begin = count(layouts);
+				version.layout_count = count(version_definition.layoutHashes);
+				for (const auto& layout : version_definition.layoutHashes) {
+					const auto hash = parseLayoutHash(layout);
+					layouts.push_back({ strings.add(layout), hash.value_or(0), hash.has_value() ? 1u : 0u });
+					if (hash.has_value()) {
+						layout_index.try_emplace(*hash, BundleLayoutIndexEntry{ *hash, count(tables), version_index });
+						table_layout_entries.push_back({ *hash, version_index });
+					}
+				}
+
+				version.definition_begin = count(definitions);
+				version.definition_count = count(version_definition.definitions);
+				for (const auto& def : version_definition.definitions) {
+					BundleDefinition entry{};
+					entry.name = strings.add(def.name);
+					entry.comment = strings.add(def.comment);
+					entry.column = column_indexes.at(def.name);
+					entry.size = def.size;
+					entry.array_length = def.arrLength;
+					entry.flags = (def.isID ? Id : 0) |
+						(def.isRelation ? Relation : 0) |
+						(def.isNonInline ? NonInline : 0) |
+						(def.isSigned ? Signed : 0);
+					definitions.push_back(entry);
+				}
+
+				versions.push_back(version);
+			}
+
+			// stable, so the first version is kept for duplicates.
+			auto build_key = [](const BundleBuildIndexEntry& entry) {
+				return Build(entry.build.expansion, entry.build.major, entry.build.minor, entry.build.build);
+			};
+			std::ranges::stable_sort(table_builds, {}, build_key);
+			const auto [first, last] = std::ranges::unique(table_builds, {}, build_key);
+			table_builds.erase(first, last);
+			build_index.insert(build_index.end(), table_builds.begin(), table_builds.end());
+
+			std::ranges::stable_sort(table_layout_entries, {}, &BundleTableLayoutEntry::hash);
+			const auto [first_layout, last_layout] = std::ranges::unique(table_layout_entries, {}, &BundleTableLayoutEntry::hash);
+			table_layout_entries.erase(first_layout, last_layout);
+			table.layout_begin = count(table_layouts);
+			table.layout_count = count(table_layout_entries);
+			table_layouts.insert(table_layouts.end(), table_layout_entries.begin(), table_layout_entries.end());
+
+			// segment s holds builds with exactly s boundaries below them, a range covers the segments after its start up to its end.
+			std::ranges::sort(table_boundaries, {}, boundaryKey);
+			const auto [first_boundary, last_boundary] = std::ranges::unique(table_boundaries, {}, boundaryKey);
+			table_boundaries.erase(first_boundary, last_boundary);
+
+			std::vector<uint32_t> table_segments(table_boundaries.size() + 1, BUNDLE_NO_VERSION);
+			auto boundary_index = [&table_boundaries](const Build& build, uint32_t kind) {
+				return static_cast<size_t>(std::ranges::lower_bound(table_boundaries, std::make_pair(build, kind), {}, boundaryKey) - table_boundaries.begin());
+			};
+
+			for (uint32_t v = 0; v < db_definition.versionDefinitions.size(); v++) {
+				for (const auto& range : db_definition.versionDefinitions[v].buildRanges) {
+					const auto end = boundary_index(range.maxBuild, 1);
+					for (size_t segment = boundary_index(range.minBuild, 0) + 1; segment <= end; segment++) {
+						if (table_segments[segment] == BUNDLE_NO_VERSION) {
+							table_segments[segment] = v;
+						}
+					}
+				}
+			}
+
+			table.range_boundary_begin = count(range_boundaries);
+			table.range_boundary_count = count(table_boundaries);
+			table.range_segment_begin = count(range_segments);
+			range_boundaries.insert(range_boundaries.end(), table_boundaries.begin(), table_boundaries.end());
+			range_segments.insert(range_segments.end(), table_segments.begin(), table_segments.end());
+
+			table.column_count = count(columns) - table.column_begin;
+			table.version_count = count(versions) - table.version_begin;
+			table.build_index_count = count(build_index) - table.build_index_begin;
+			tables.push_back(table);
+		}
+
+		std::vector<BundleLayoutIndexEntry> layout_entries;
+		layout_entries.reserve(layout_index.size());
+		for (const auto& [hash, entry] : layout_index) {
+			layout_entries.push_back(entry);
+		}
+
+		BundleHeader header{};
+		header.signature = BUNDLE_MAGIC.integer;
+		header.version = BUNDLE_VERSION;
+		header.table_count = count(tables);
+		header.column_count = count(columns);
+		header.version_count = count(versions);
+		header.build_count = count(builds);
+		header.layout_count = count(layouts);
+		header.definition_count = count(definitions);
+		header.build_index_count = count(build_index);
+		header.range_boundary_count = count(range_boundaries);
+		header.range_segment_count = count(range_segments);
+		header.table_layout_count = count(table_layouts);
+		header.layout_index_count = count(layout_entries);
+
+		uint64_t offset = sizeof(BundleHeader);
+		auto place = [&offset](const auto& items) {
+			const uint64_t section_offset = offset;
+			offset += items.size() * sizeof(typename std::decay_t<decltype(items)>::value_type);
+			return section_offset;
+		};
+		header.tables_offset = place(tables);
+		header.columns_offset = place(columns);
+		header.versions_offset = place(versions);
+		header.builds_offset = place(builds);
+		header.layouts_offset = place(layouts);
+		header.definitions_offset = place(definitions);
+		header.build_index_offset = place(build_index);
+		header.range_boundaries_offset = place(range_boundaries);
+		header.range_segments_offset = place(range_segments);
+		header.table_layouts_offset = place(table_layouts);
+		header.layout_index_offset = place(layout_entries);
+		header.strings_offset = place(strings.bytes());
+		header.strings_size = strings.bytes().size();
+
+		auto write = [&stream](const auto& items) {
+			stream.write(reinterpret_cast<const char*>(items.data()), items.size() * sizeof(typename std::decay_t<decltype(items)>::value_type));
+		};
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		write(tables);
+		write(columns);
+		write(versions);
+		write(builds);
+		write(layouts);
+		write(definitions);
+		write(build_index);
+		write(range_boundaries);
+		write(range_segments);
+		write(table_layouts);
+		write(layout_entries);
+		write(strings.bytes());
+	}
+
+	DefinitionBundle::DefinitionBundle(const std::filesystem::path& path) :
+		_mapped(std::make_unique<Filesystem::MappedFileSource>(path))
+	{
+		_data = std::span<const uint8_t>(_mapped->data(), _mapped->size());
+		validate();
+	}
+
+	DefinitionBundle::DefinitionBundle(std::vector<uint8_t> data) :
+		_owned(std::move(data))
+	{
+		_data = std::span<const uint8_t>(_owned.data(), _owned.size());
+		validate();
+	}
+
+	bool DefinitionBundle::isBundle(const std::filesystem::path& path) {
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec)) {
+			return false;
+		}
+
+		std::ifstream stream(path, std::ios::binary);
+		uint32_t signature = 0;
+		stream.read(reinterpret_cast<char*>(&signature), sizeof(signature));
+		return stream.gcount() == sizeof(signature) && signature == BUNDLE_MAGIC.integer;
+	}
+
+	void DefinitionBundle::validate() {
+		if (_data.size() < sizeof(BundleHeader)) {
+			throw WDBReaderException("Definition bundle is too small.");
+		}
+
+		memcpy(&_header, _data.data(), sizeof(BundleHeader));
+
+		if (_header.signature != BUNDLE_MAGIC.integer) {
+			throw WDBReaderException("Header signature doesnt match.");
+		}
+
+		if (_header.version != BUNDLE_VERSION) {
+			throw WDBReaderException("Unsupported definition bundle version.");
+		}
+
+		auto check = [this](uint64_t offset, uint64_t bytes) {
+			if (offset > _data.size() || bytes > _data.size() - offset) {
+				throw WDBReaderException("Definition bundle is corrupt.");
+			}
+		};
+
+		check(_header.tables_offset, uint64_t(_header.table_count) * sizeof(BundleTable));
+		check(_header.columns_offset, uint64_t(_header.column_count) * sizeof(BundleColumn));
+		check(_header.versions_offset, uint64_t(_header.version_count) * sizeof(BundleVersion));
+		check(_header.builds_offset, uint64_t(_header.build_count) * sizeof(BundleBuild));
+		check(_header.layouts_offset, uint64_t(_header.layout_count) * sizeof(BundleLayout));
+		check(_header.definitions_offset, uint64_t(_header.definition_count) * sizeof(BundleDefinition));
+		check(_header.build_index_offset, uint64_t(_header.build_index_count) * sizeof(BundleBuildIndexEntry));
+		check(_header.range_boundaries_offset, uint64_t(_header.range_boundary_count) * sizeof(BundleRangeBoundary));
+		check(_header.range_segments_offset, uint64_t(_header.range_segment_count) * sizeof(uint32_t));
+		check(_header.table_layouts_offset, uint64_t(_header.table_layout_count) * sizeof(BundleTableLayoutEntry));
+		check(_header.layout_index_offset, uint64_t(_header.layout_index_count) * sizeof(BundleLayoutIndexEntry));
+		check(_header.strings_offset, _header.strings_size);
+	}
+
+	template<typename T>
+	T DefinitionBundle::element(uint64_t section_offset, uint32_t count, uint32_t index) const {
+		if (index >= count) {
+			throw WDBReaderException("Definition bundle is corrupt.");
+		}
+
+		T value;
+		memcpy(&value, _data.data() + section_offset + uint64_t(index) * sizeof(T), sizeof(T));
+		return value;
+	}
+
+	std::string_view DefinitionBundle::string(const BundleString& str) const {
+		if (str.offset > _header.strings_size || str.length > _header.strings_size - str.offset) {
+			throw WDBReaderException("Definition bundle is corrupt.");
+		}
+		return std::string_view(reinterpret_cast<const char*>(_data.data() + _header.strings_offset + str.offset), str.length);
+	}
+
+	Build DefinitionBundle::toBuild(const BundleBuild& build) {
+		return Build(build.expansion, build.major, build.minor, build.build);
+	}
+
+	BundleTable DefinitionBundle::tableAt(uint32_t index) const {
+		return element<BundleTable>(_header.tables_offset, _header.table_count, index);
+	}
+
+	BundleVersion DefinitionBundle::versionAt(const BundleTable& table, size_t index) const {
+		if (index >= table.version_count) {
+			throw WDBReaderException("Definition bundle is corrupt.");
+		}
+		return element<BundleVersion>(_header.versions_offset, _header.version_count, table.version_begin + static_cast<uint32_t>(index));
+	}
+
+	std::optional<uint32_t> DefinitionBundle::findTable(std::string_view name) const {
+		uint32_t first = 0;
+		uint32_t last = _header.table_count;
+		while (first < last) {
+			const uint32_t middle = first + (last - first) / 2;
+			if (string(tableAt(middle).name) < name) {
+				first = middle + 1;
+			}
+			else {
+				last = middle;
+			}
+		}
+
+		if (first < _header.table_count && string(tableAt(first).name) == name) {
+			return first;
+		}
+		return std::nullopt;
+	}
+
+	bool DefinitionBundle::contains(std::string_view name) const {
+		return findTable(name).has_value();
+	}
+
+	std::vector<std::string> DefinitionBundle::names() const {
+		std::vector<std::string> result;
+		result.reserve(_header.table_count);
+		for (uint32_t i = 0; i < _header.table_count; i++) {
+			result.emplace_back(string(tableAt(i).name));
+		}
+		return result;
+	}
+
+	std::optional<DBDefinition> DefinitionBundle::definition(std::string_view name) const {
+		const auto index = findTable(name);
+		if (!index.has_value()) {
+			return std::nullopt;
+		}
+
+		const auto table = tableAt(*index);
+		DBDefinition db_definition;
+
+		for (uint32_t i = 0; i < table.column_count; i++) {
+			const auto column = element<BundleColumn>(_header.columns_offset, _header.column_count, table.column_begin + i);
+			ColumnDefinition column_definition;
+			column_definition.type = string(column.type);
+			column_definition.foreignTable = string(column.foreign_table);
+			column_definition.foreignColumn = string(column.foreign_column);
+			column_definition.verified = column.verified != 0;
+			column_definition.comment = string(column.comment);
+			db_definition.columnDefinitions.emplace(string(column.name), std::move(column_definition));
+		}
+
+		for (uint32_t v = 0; v < table.version_count; v++) {
+			const auto version = versionAt(table, v);
+			VersionDefinitions version_definition;
+			version_definition.comment = string(version.comment);
+
+			for (uint32_t i = 0; i < version.build_count; i++) {
+				version_definition.builds.push_back(toBuild(element<BundleBuild>(_header.builds_offset, _header.build_count, version.build_begin + i)));
+			}
+
+			for (uint32_t i = 0; i < version.range_count; i++) {
+				const auto min = element<BundleBuild>(_header.builds_offset, _header.build_count, version.range_begin + i * 2);
+				const auto max = element<BundleBuild>(_header.builds_offset, _header.build_count, version.range_begin + i * 2 + 1);
+				version_definition.buildRanges.emplace_back(toBuild(min), toBuild(max));
+			}
+
+			for (uint32_t i = 0; i < version.layout_count; i++) {
+				version_definition.layoutHashes.emplace_back(string(element<BundleLayout>(_header.layouts_offset, _header.layout_count, version.layout_begin + i).text));
+			}
+
+			for (uint32_t i = 0; i < version.definition_count; i++) {
+				const auto entry = element<BundleDefinition>(_header.definitions_offset, _header.definition_count, version.definition_begin + i);
+				Definition def;
+				def.size = entry.size;
+				def.arrLength = entry.array_length;
+				def.name = string(entry.name);
+				def.isID = (entry.flags & Id) != 0;
+				def.isRelation = (entry.flags & Relation) != 0;
+				def.isNonInline = (entry.flags & NonInline) != 0;
+				def.isSigned = (entry.flags & Signed) != 0;
+				def.comment = string(entry.comment);
+				version_definition.definitions.push_back(std::move(def));
+			}
+
+			db_definition.versionDefinitions.push_back(std::move(version_definition));
+		}
+
+		return db_definition;
+	}
+
+	std::optional<size_t> DefinitionBundle::versionIndex(const BundleTable& table, const Build& build) const {
+		size_t result = NO_VERSION;
+
+		uint32_t first = 0;
+		uint32_t last = table.build_index_count;
+		auto entry_at = [&](uint32_t index) {
+			return element<BundleBuildIndexEntry>(_header.build_index_offset, _header.build_index_count, table.build_index_begin + index);
+		};
+
+		while (first < last) {
+			const uint32_t middle = first + (last - first) / 2;
+			if (toBuild(entry_at(middle).build) < build) {
+				first = middle + 1;
+			}
+			else {
+				last = middle;
+			}
+		}
+
+		if (first < table.build_index_count) {
+			const auto entry = entry_at(first);
+			if (toBuild(entry.build) == build) {
+				result = entry.version;
+			}
+		}
+
+		// an earlier version covering the build with a range still wins, as with makeSchema.
+		first = 0;
+		last = table.range_boundary_count;
+		const auto key = std::make_pair(build, 1u);
+		while (first < last) {
+			const uint32_t middle = first + (last - first) / 2;
+			const auto boundary = element<BundleRangeBoundary>(_header.range_boundaries_offset, _header.range_boundary_count, table.range_boundary_begin + middle);
+			if (boundaryKey(boundary) < key) {
+				first = middle + 1;
+			}
+			else {
+				last = middle;
+			}
+		}
+
+		const auto range_version = element<uint32_t>(_header.range_segments_offset, _header.range_segment_count, table.range_segment_begin + first);
+		if (range_version != BUNDLE_NO_VERSION) {
+			result = std::min<size_t>(result, range_version);
+		}
+
+		if (result == NO_VERSION) {
+			return std::nullopt;
+		}
+		if (result >= table.version_count) {
+			throw WDBReaderException("Definition bundle is corrupt.");
+		}
+		return result;
+	}
+
+	std::optional<size_t> DefinitionBundle::versionIndexForLayout(const BundleTable& table, uint32_t layout_hash) const {
+		uint32_t first = 0;
+		uint32_t last = table.layout_count;
+		auto entry_at = [&](uint32_t index) {
+			return element<BundleTableLayoutEntry>(_header.table_layouts_offset, _header.table_layout_count, table.layout_begin + index);
+		};
+
+		while (first < last) {
+			const uint32_t middle = first + (last - first) / 2;
+			if (entry_at(middle).hash < layout_hash) {
+				first = middle + 1;
+			}
+			else {
+				last = middle;
+			}
+		}
+
+		if (first < table.layout_count) {
+			const auto entry = entry_at(first);
+			if (entry.hash == layout_hash) {
+				if (entry.version >= table.version_count) {
+					throw WDBReaderException("Definition bundle is corrupt.");
+				}
+				return entry.version;
+			}
+		}
+		return std::nullopt;
+	}
+
+	Database::RuntimeSchema DefinitionBundle::schema(const BundleTable& table, size_t version_index) const {
+		const auto version = versionAt(table, version_index);
+
+		std::vector<Database::RuntimeSchema::field_name_t> names;
+		names.reserve(version.definition_count);
+		std::vector<Database::Field> fields;
+		fields.reserve(version.definition_count);
+
+		for (uint32_t i = 0; i < version.definition_count; i++) {
+			const auto def = element<BundleDefinition>(_header.definitions_offset, _header.definition_count, version.definition_begin + i);
+			if (def.column >= table.column_count) {
+				throw WDBReaderException("Definition bundle is corrupt.");
+			}
+			const auto column = element<BundleColumn>(_header.columns_offset, _header.column_count, table.column_begin + def.column);
+
+			names.emplace_back(string(def.name));
+			const auto annotation = Database::Annotation((def.flags & Id) != 0, (def.flags & Relation) != 0, (def.flags & NonInline) == 0, (def.flags & Signed) != 0);
+			fields.push_back(makeField(string(column.type), def.size, def.array_length, annotation));
+		}
+
+		return Database::RuntimeSchema(std::move(fields), std::move(names));
+	}
+
+	std::optional<size_t> DefinitionBundle::versionIndex(std::string_view name, const Build& build) const {
+		const auto index = findTable(name);
+		return index.has_value() ? versionIndex(tableAt(*index), build) : std::nullopt;
+	}
+
+	std::optional<size_t> DefinitionBundle::versionIndexForLayout(std::string_view name, uint32_t layout_hash) const {
+		const auto index = findTable(name);
+		return index.has_value() ? versionIndexForLayout(tableAt(*index), layout_hash) : std::nullopt;
+	}
+
+	std::optional<Database::RuntimeSchema> DefinitionBundle::schema(std::string_view name, const Build& build) const {
+		const auto index = findTable(name);
+		if (!index.has_value()) {
+			return std::nullopt;
+		}
+
+		const auto table = tableAt(*index);
+		const auto version = versionIndex(table, build);
+		if (!version.has_value()) {
+			return std::nullopt;
+		}
+		return schema(table, *version);
+	}
+
+	std::optional<Database::RuntimeSchema> DefinitionBundle::schemaForLayout(std::string_view name, uint32_t layout_hash) const {
+		const auto index = findTable(name);
+		if (!index.has_value()) {
+			return std::nullopt;
+		}
+
+		const auto table = tableAt(*index);
+		const auto version = versionIndexForLayout(table, layout_hash);
+		if (!version.has_value()) {
+			return std::nullopt;
+		}
+		return schema(table, *version);
+	}
+
+	std::optional<std::string_view> DefinitionBundle::tableForLayout(uint32_t layout_hash) const {
+		uint32_t first = 0;
+		uint32_t last = _header.layout_index_count;
+		auto entry_at = [this](uint32_t index) {
+			return element<BundleLayoutIndexEntry>(_header.layout_index_offset, _header.layout_index_count, index);
+		};
+
+		while (first < last) {
+			const uint32_t middle = first + (last - first) / 2;
+			if (entry_at(middle).hash < layout_hash) {
+				first = middle + 1;
+			}
+			else {
+				last = middle;
+			}
+		}
+
+		if (first < _header.layout_index_count) {
+			const auto entry = entry_at(first);
+			if (entry.hash == layout_hash) {
+				return string(tableAt(entry.table).name);
+			}
+		}
+		return std::nullopt;
+	}
+
+	std::optional<Database::RuntimeSchema> DefinitionBundle::schemaForLayout(uint32_t layout_hash) const {
+		const auto name = tableForLayout(layout_hash);
+		return name.has_value() ? schemaForLayout(*name, layout_hash) : std::nullopt;
+	}
+}
@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Database/BuildLoader.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Whole builds can be loaded on a pool.", "[database:buildloader]")
+{
+	const std::array<std::string, 4> names = { "Large", "Medium", "Small", "Legacy" };
+	const std::array<uint32_t, 4> row_counts = { 3000, 300, 10, 50 };
+
+	const GameVersion build(10, 2, 0, 52038);
+	const std::string dbd_text =
+		"COLUMNS\n"
+		"int ID\n"
+		"string Name\n"
+		"int Level\n"
+		"\n"
+		"BUILD 10.2.0.52038\n"
+		"$id$ID<u32>\n"
+		"Name\n"
+		"Level<u32>\n";
+
+	std::map<std::string, WoWDBDefs::DBDefinition> definitions;
+	for (const auto& name : names) {
+		std::istringstream stream(dbd_text);
+		definitions.emplace(name, WoWDBDefs::DBDReader::read(stream));
+	}
+
+	{
+		std::string old_text = dbd_text;
+		old_text.replace(old_text.find("10.2.0.52038"), 12, "1.12.1.5875");
+		std::istringstream stream(old_text);
+		definitions["OldOnly"] = WoWDBDefs::DBDReader::read(stream);
+	}
+
+	const auto schema = WoWDBDefs::makeSchema(definitions.at("Large"), build);
+	REQUIRE(schema.has_value());
+
+	std::vector<TempFile> files;
+	uint64_t largest = 0;
+	for (size_t t = 0; t < names.size(); t++) {
+		std::vector<writer_row_t> rows;
+		for (uint32_t i = 0; i < row_counts[t]; i++) {
+			rows.push_back({ uint64_t(i + 1), "row_" + std::to_string(i % 7), uint64_t(i) });
+		}
+
+		const auto file_name = "wdbreader_build_" + names[t] + ".db2";
+		files.push_back(names[t] == "Legacy" ?
+			writeLegacyFile(file_name, *schema, rows) :
+			writePackedFile(file_name, rows, DB2WriterOptions(), *schema));
+		largest = std::max<uint64_t>(largest, std::filesystem::file_size(files.back().path()));
+	}
+
+	std::vector<BuildTable<NativeFileUri>> tables;
+	for (size_t t = 0; t < names.size(); t++) {
+		tables.push_back({ names[t], files[t].path() });
+	}
+	tables.push_back({ "Undefined", files[0].path() });
+	tables.push_back({ "OldOnly", files[0].path() });
+
+	BuildLoadOptions options;
+	options.threads = 3;
+	options.maxInFlightBytes = largest;
+
+	std::mutex sink_mutex;
+	std::map<std::string, uint64_t> level_sums;
+	uint64_t in_sink_bytes = 0;
+	bool over_budget = false;
+
+	auto sink = [&](const BuildTable<NativeFileUri>& table, const RuntimeSchema& table_schema, const DataSource<RuntimeRecord>& source) {
+		const auto bytes = std::filesystem::file_size(table.file);
+		{
+			std::scoped_lock lock(sink_mutex);
+			in_sink_bytes += bytes;
+			over_budget |= in_sink_bytes > largest;
+		}
+
+		uint64_t sum = 0;
+		for (auto& record : source) {
+			auto [level] = table_schema(record).get<uint32_t>("Level");
+			sum += level;
+		}
+
+		std::scoped_lock lock(sink_mutex);
+		in_sink_bytes -= bytes;
+		level_sums[table.name] = sum;
+	};
+
+	const auto result = loadBuild<NativeFilesystem, NativeFileUri>([]() { return std::make_unique<NativeFilesystem>(); }, definitions, build, tables, options, sink);
+
+	REQUIRE(result.loaded == 4);
+	REQUIRE(result.failed.size() == 2);
+	REQUIRE(result.peakInFlightBytes <= largest);
+	REQUIRE_FALSE(over_budget);
+
+	for (size_t t = 0; t < names.size(); t++) {
+		const uint64_t n = row_counts[t];
+		REQUIRE(level_sums.at(names[t]) == n * (n - 1) / 2);
+	}
+
+	std::vector<std::string> failed;
+	for (const auto& failure : result.failed) {
+		failed.push_back(failure.name);
+	}
+	std::ranges::sort(failed);
+	REQUIRE(failed == std::vector<std::string>{ "OldOnly", "Undefined" });
+
+	WoWDBDefs::DefinitionRegistry registry;
+	for (const auto& [name, definition] : definitions) {
+		registry.add(name, definition);
+	}
+
+	level_sums.clear();
+	const auto registry_result = loadBuild<NativeFilesystem, NativeFileUri>([]() { return std::make_unique<NativeFilesystem>(); }, registry, build, tables, options, sink);
+	REQUIRE(registry_result.loaded == 4);
+	REQUIRE(registry_result.failed.size() == 2);
+	REQUIRE(level_sums.size() == 4);
+}
@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Database/Catalog.hpp>
+#include <WDBReader/Database/Index.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Catalog tables are opened lazily within a size limit.", "[database:catalog]")
+{
+	const std::array<std::string, 3> names = { "First", "Second", "Third" };
+
+	std::vector<TempFile> files;
+	uint64_t largest = 0;
+	for (uint32_t t = 0; t < names.size(); t++) {
+		files.push_back(writePackedFile("wdbreader_catalog_" + names[t] + ".db2", packedRows(200, t)));
+		largest = std::max<uint64_t>(largest, std::filesystem::file_size(files.back().path()));
+	}
+
+	auto native_fs = NativeFilesystem();
+	Catalog<NativeFilesystem, NativeFileUri> catalog(&native_fs, largest * 2);
+	for (uint32_t t = 0; t < names.size(); t++) {
+		catalog.add(names[t], files[t].path(), packed_schema);
+	}
+
+	REQUIRE(catalog.contains("Second"));
+	REQUIRE_FALSE(catalog.contains("Fourth"));
+	REQUIRE(catalog.stats().openTables == 0);
+	REQUIRE_THROWS_AS(catalog.add("First", files[1].path(), packed_schema), WDBReaderException);
+	REQUIRE_THROWS_AS(catalog.open("Fourth"), WDBReaderException);
+
+	auto first = catalog.open("First");
+	REQUIRE(first->size() == 200);
+	REQUIRE(catalog.open("First") == first);
+
+	size_t builds = 0;
+	auto build_levels = [&builds](const RuntimeSchema& schema, const DataSource<RuntimeRecord>& source) {
+		builds++;
+		return buildSortedIndex<uint32_t>(schema, source, "level");
+	};
+	const auto levels = catalog.index<SortedIndex<uint32_t>>("First", "level", build_levels);
+	REQUIRE(std::ranges::equal(levels->find(7 * 5), std::vector<uint32_t>{ 5 }));
+
+	catalog.open("Second");
+	catalog.open("Third");
+
+	auto stats = catalog.stats();
+	REQUIRE(stats.tables == 3);
+	REQUIRE(stats.openTables == 2);
+	REQUIRE(stats.evictions == 1);
+	REQUIRE(stats.misses == 3);
+	REQUIRE(stats.hits == 2);
+	REQUIRE(stats.residentBytes <= largest * 2);
+
+	// evicted, but still usable through the held pointer, and the index is kept.
+	auto [level] = packed_schema((*first)[5]).get<uint32_t>("level");
+	REQUIRE(level == 7 * 5);
+	REQUIRE(catalog.index<SortedIndex<uint32_t>>("First", "level", build_levels) == levels);
+	REQUIRE(builds == 1);
+	REQUIRE_THROWS_AS(catalog.index<HashIndex<uint32_t>>("First", "level", [](const auto&, const auto&) { return HashIndex<uint32_t>(IndexPostings<uint32_t>()); }), WDBReaderException);
+
+	REQUIRE(catalog.open("First") != first);
+	REQUIRE(catalog.stats().misses == 4);
+
+	catalog.release("First");
+	REQUIRE(catalog.stats().openTables == 1);
+
+	{
+		// opened sources share ownership of the schema, so they outlive the catalog.
+		std::shared_ptr<const DataSource<RuntimeRecord>> kept;
+		{
+			Catalog<NativeFilesystem, NativeFileUri> scoped(&native_fs);
+			scoped.add("First", files[0].path(), packed_schema);
+			kept = scoped.open("First");
+		}
+
+		REQUIRE(kept->size() == 200);
+		auto [kept_name, kept_level] = packed_schema((*kept)[5]).get<std::string, uint32_t>("name", "level");
+		REQUIRE(kept_name == "name_1");
+		REQUIRE(kept_level == 7 * 5);
+	}
+}
+
+TEST_CASE("Catalog tables can be read from several threads.", "[database:catalog]")
+{
+	const auto file = writePackedFile("wdbreader_catalog_threads.db2", packedRows(300));
+
+	auto native_fs = NativeFilesystem();
+	Catalog<NativeFilesystem, NativeFileUri> catalog(&native_fs);
+	catalog.add("Table", file.path(), packed_schema);
+
+	const auto table = catalog.open("Table");
+	REQUIRE(table->size() == 300);
+
+	std::array<bool, 4> matched{};
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < matched.size(); t++) {
+		threads.emplace_back([&, t]() {
+			bool all = true;
+			for (uint32_t i = 0; i < table->size(); i++) {
+				const uint32_t index = static_cast<uint32_t>((i + t * 75) % table->size());
+				auto [name, level] = packed_schema((*table)[index]).get<std::string, uint32_t>("name", "level");
+				all = all && name == "name_" + std::to_string(index % 4) && level == index * 7;
+			}
+
+			const auto levels = decodeColumn<uint32_t>(packed_schema, *table, namedFieldIndex(packed_schema, "level"));
+			for (uint32_t i = 0; i < levels.size(); i++) {
+				all = all && levels[i] == i * 7;
+			}
+			matched[t] = all;
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(std::ranges::all_of(matched, [](bool all) { return all; }));
+}
@@ -3,6 +3,8 @@
 #include <WDBReader/Database/DBCFile.hpp>
 #include <WDBReader/Filesystem/MPQFilesystem.hpp>
 #include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <filesystem>
+#include <fstream>
 
 using namespace WDBReader::Database;
 using namespace WDBReader::Filesystem;
@@ -180,6 +182,53 @@ TEST_CASE("Shorthand file creation.", "[database:dbc]")
 	auto static_type = makeDBCFile<StaticWOTLKDBCSpellItemEnchantmentRecord, MPQFileSource>(DBCVersion::BC_WOTLK);
 }
 
+TEST_CASE("Load stats are recorded.", "[database:dbc]")
+{
+	const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_load_stats_test.dbc";
+	auto file_guard = ScopeGuard([&temp_file_name]() {
+		if (std::filesystem::exists(temp_file_name)) {
+			std::filesystem::remove(temp_file_name);
+		}
+	});
+
+	const std::string strings("\0first\0second\0", 15);
+	const uint32_t records[2][2] = { { 1, 1 }, { 2, 7 } };
+	const DBCHeader header{ WDBC_MAGIC.integer, 2, 2, sizeof(records[0]), static_cast<uint32_t>(strings.size()) };
+
+	{
+		std::ofstream writer(temp_file_name, std::ios::binary);
+		writer.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		writer.write(reinterpret_cast<const char*>(records), sizeof(records));
+		writer.write(strings.data(), strings.size());
+	}
+
+	const auto schema = RuntimeSchema({
+		Field::value<uint32_t>(Annotation().Id()),
+		Field::string()
+	}, {
+		"id",
+		"name"
+	});
+
+	auto native_fs = NativeFilesystem();
+	auto dbc = makeDBCFile<NativeFileSource>(schema, DBCVersion::CATA_PLUS, DBCStringLocale::ANY);
+	dbc.open(native_fs.open(temp_file_name));
+	dbc.load();
+
+	REQUIRE(dbc.size() == 2);
+	auto [id, name] = schema(dbc[1]).get<uint32_t, std::string>("id", "name");
+	REQUIRE(id == 2);
+	REQUIRE(name == "second");
+
+	const auto stats = dbc.loadStats();
+	REQUIRE(stats[LoadPhase::HEADER].bytes == sizeof(DBCHeader));
+	REQUIRE(stats[LoadPhase::RECORDS].bytes == 0);
+	REQUIRE(stats.totalBytes() == sizeof(DBCHeader));
+	REQUIRE(stats.resident.size() == 2);
+	REQUIRE(stats.residentBytes() == sizeof(DBCHeader) + sizeof(records[0]));
+	REQUIRE(loadPhaseName(LoadPhase::COMMON_DATA) == "common_data");
+}
+
 TEST_CASE("DBC version detection.", "[database:dbc]")
 {
 	{
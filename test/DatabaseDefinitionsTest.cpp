@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Database/Definitions.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Schemas are chosen by the layout hash in the header.", "[database:definitions]")
+{
+	// both versions claim the build, as when a table changes mid patch.
+	std::istringstream dbd(
+		"COLUMNS\n"
+		"int ID\n"
+		"string Name\n"
+		"int Level\n"
+		"\n"
+		"LAYOUT AAAA0001\n"
+		"BUILD 10.2.0.52038\n"
+		"$id$ID<u32>\n"
+		"Name\n"
+		"\n"
+		"LAYOUT AAAA0002\n"
+		"BUILD 10.2.0.52038\n"
+		"$id$ID<u32>\n"
+		"Name\n"
+		"Level<u32>\n"
+	);
+	const auto definition = WoWDBDefs::DBDReader::read(dbd);
+	const GameVersion build(10, 2, 0, 52038);
+
+	const auto by_build = WoWDBDefs::makeSchema(definition, build);
+	const auto by_layout = WoWDBDefs::makeSchemaForLayout(definition, 0xAAAA0002);
+	REQUIRE(by_build->fields().size() == 2);
+	REQUIRE(by_layout.has_value());
+	REQUIRE(by_layout->fields().size() == 3);
+	REQUIRE_FALSE(WoWDBDefs::makeSchemaForLayout(definition, 0xAAAA0003).has_value());
+
+	std::vector<writer_row_t> rows;
+	std::vector<writer_row_t> legacy_rows;
+	for (uint32_t i = 0; i < 20; i++) {
+		rows.push_back({ uint64_t(i + 1), "row_" + std::to_string(i), uint64_t(i * 2) });
+		legacy_rows.push_back({ rows.back()[0], rows.back()[1] });
+	}
+
+	DB2WriterOptions options;
+	options.layoutHash = 0xAAAA0002;
+	const auto modern_file = writePackedFile("wdbreader_layout_test.db2", rows, options, *by_layout);
+	const auto legacy_file = writeLegacyFile("wdbreader_layout_test.dbc", *by_build, legacy_rows);
+
+	WoWDBDefs::DefinitionRegistry registry;
+	registry.add("Other", WoWDBDefs::DBDefinition());
+	registry.add("Spell", definition);
+	REQUIRE(registry.tableForLayout(0xAAAA0002) == "Spell");
+
+	auto native_fs = NativeFilesystem();
+	const auto table = openWithDefinitions(native_fs, modern_file.path(), registry);
+	REQUIRE(table.name == "Spell");
+	REQUIRE(table.schema->fields().size() == 3);
+	REQUIRE(table.source->size() == 20);
+	auto [level] = (*table.schema)((*table.source)[7]).get<uint32_t>("Level");
+	REQUIRE(level == 14);
+
+	const auto named = openWithDefinitions(native_fs, modern_file.path(), registry, "Spell", build);
+	REQUIRE(named.schema == table.schema);
+
+	// dbc files have no layout hash, so only the named overload can open them, by build.
+	REQUIRE_THROWS_AS(openWithDefinitions(native_fs, legacy_file.path(), registry), WDBReaderException);
+	const auto legacy = openWithDefinitions(native_fs, legacy_file.path(), registry, "Spell", build);
+	REQUIRE(legacy.schema->fields().size() == 2);
+	REQUIRE(legacy.source->size() == 20);
+	REQUIRE_THROWS_AS(openWithDefinitions(native_fs, legacy_file.path(), registry, "Missing", build), WDBReaderException);
+}
@@ -0,0 +1,52 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <algorithm>
+#include <string>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Pallet and common data are read on first use.", "[database:fielddata]")
+{
+	DB2WriterOptions options;
+	options.compression = {
+		DB2FieldCompression::None,
+		DB2FieldCompression::None,
+		DB2FieldCompression::BitpackedIndexed,
+		DB2FieldCompression::None,
+		DB2FieldCompression::None,
+		DB2FieldCompression::CommonData
+	};
+
+	const auto rows = packedRows(12);
+	const auto file = writePackedFile("wdbreader_fielddata_test.db2", rows, options);
+
+	auto native_fs = NativeFilesystem();
+	DB2File<DB2FileFormatWDC3, RuntimeSchema, RuntimeRecord, NativeFileSource> db2(packed_schema);
+	db2.open(native_fs.open(file.path()));
+	db2.load();
+
+	auto resident_bytes = [&db2](std::string_view name) {
+		const auto stats = db2.loadStats();
+		const auto found = std::ranges::find(stats.resident, name, &ResidentStats::name);
+		REQUIRE(found != stats.resident.end());
+		return found->bytes;
+	};
+
+	REQUIRE(resident_bytes("palletData") == 0);
+	REQUIRE(resident_bytes("commonData") == 0);
+
+	for (uint32_t i = 0; i < rows.size(); i++) {
+		auto [category, flags, name] = packed_schema(db2[i]).get<uint32_t, uint8_t, std::string>("category", "flags", "name");
+		REQUIRE(category == (i % 3) * 100);
+		REQUIRE(flags == (i % 5 == 0 ? 3 : 1));
+		REQUIRE(name == "name_" + std::to_string(i % 4));
+	}
+
+	REQUIRE(resident_bytes("palletData") == 3 * sizeof(WDC3PalletValue));
+	REQUIRE(resident_bytes("commonData") > 0);
+}
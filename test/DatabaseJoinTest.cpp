@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Database/Join.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Tables can be joined on foreign keys.", "[database:join]")
+{
+	std::istringstream dbd(
+		"COLUMNS\n"
+		"int ID\n"
+		"int<Parent::ID> ParentID\n"
+		"int<Parent::level> ParentLevel\n"
+		"int Count\n"
+		"\n"
+		"BUILD 10.2.0.52038\n"
+		"$id$ID<u32>\n"
+		"ParentID<u32>\n"
+		"ParentLevel<u32>\n"
+		"Count<u32>\n"
+	);
+	const auto definition = WoWDBDefs::DBDReader::read(dbd);
+	const auto child_schema = WoWDBDefs::makeSchema(definition, GameVersion(10, 2, 0, 52038));
+	REQUIRE(child_schema.has_value());
+
+	std::vector<writer_row_t> child_rows;
+	for (uint32_t i = 0; i < 40; i++) {
+		const uint64_t parent_id = i % 10 == 9 ? 0 : 10 + (i % 15) * 3;
+		child_rows.push_back({ uint64_t(i + 1), parent_id, uint64_t((i % 14) * 7), uint64_t(i) });
+	}
+
+	// parent ids are 10 + 3i (non inline), levels 7i.
+	const auto parent_file = writePackedFile("wdbreader_join_parent_test.db2", packedRows(12));
+	const auto child_file = writePackedFile("wdbreader_join_child_test.db2", child_rows, DB2WriterOptions(), *child_schema);
+
+	auto native_fs = NativeFilesystem();
+	auto parent = makeDB2File<NativeFileSource>(packed_schema, native_fs.open(parent_file.path()));
+	auto child = makeDB2File<NativeFileSource>(*child_schema, native_fs.open(child_file.path()));
+
+	auto expected_pairs = [&](const std::string& child_field, const std::string& parent_field) {
+		std::vector<std::pair<uint32_t, uint32_t>> expected;
+		for (uint32_t c = 0; c < child->size(); c++) {
+			auto [key] = (*child_schema)((*child)[c]).get<uint32_t>(child_field);
+			for (uint32_t p = 0; p < parent->size(); p++) {
+				auto [value] = packed_schema((*parent)[p]).get<uint32_t>(parent_field);
+				if (key == value) {
+					expected.emplace_back(c + 1, p);
+				}
+			}
+		}
+		return expected;
+	};
+
+	auto joined_pairs = [&](const auto& join) {
+		std::vector<std::pair<uint32_t, uint32_t>> joined;
+		join.forEach([&](const RuntimeRecord& record, const RuntimeRecord& parent_record) {
+			auto [id] = (*child_schema)(record).get<uint32_t>("ID");
+			auto [level] = packed_schema(parent_record).get<uint32_t>("level");
+			joined.emplace_back(id, level / 7);
+		});
+		return joined;
+	};
+
+	const auto by_id = joinForeignKey(definition, "ParentID", *child_schema, *child, packed_schema, *parent);
+	REQUIRE(by_id.lookup().keyCount() == parent->size());
+	REQUIRE(joined_pairs(by_id) == expected_pairs("ParentID", "id"));
+
+	const auto by_level = joinForeignKey(definition, "ParentLevel", *child_schema, *child, packed_schema, *parent);
+	REQUIRE(joined_pairs(by_level) == expected_pairs("ParentLevel", "level"));
+
+	const auto resolved = by_id.resolve((*child)[4]);
+	REQUIRE(resolved.has_value());
+	auto [resolved_id] = packed_schema(*resolved).get<uint32_t>("id");
+	REQUIRE(resolved_id == 10 + 4 * 3);
+	REQUIRE_FALSE(by_id.resolve((*child)[9]).has_value());
+	REQUIRE_FALSE(by_id.resolve((*child)[13]).has_value());
+
+	// categories repeat, so every matching record is chained.
+	const auto by_category = buildKeyLookup(packed_schema, *parent, 2);
+	std::vector<uint32_t> categories;
+	by_category.forEachIndex(100, [&](uint32_t index) { categories.push_back(index); });
+	REQUIRE(categories == std::vector<uint32_t>{ 1, 4, 7, 10 });
+	REQUIRE(by_category.findIndex(100) == 1u);
+	REQUIRE_FALSE(by_category.findIndex(150).has_value());
+
+	REQUIRE_THROWS_AS(joinForeignKey(definition, "Count", *child_schema, *child, packed_schema, *parent), WDBReaderException);
+	REQUIRE_THROWS_AS(buildKeyLookup(packed_schema, *parent, 1), WDBReaderException);
+}
@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Records can be visited in id and field order.", "[database:order]")
+{
+	// ids descending, so physical order is the reverse of id order.
+	auto rows = packedRows(12);
+	for (uint32_t i = 0; i < rows.size(); i++) {
+		rows[i][0] = uint64_t(1000 - i * 3);
+	}
+
+	DB2WriterOptions options;
+	options.sections = { 5, 7 };
+	options.copyTable = { { 1, 1000 }, { 995, 1000 } };
+
+	const auto file = writePackedFile("wdbreader_order_test.db2", rows, options);
+
+	auto native_fs = NativeFilesystem();
+	auto db2 = makeDB2File<NativeFileSource>(packed_schema, native_fs.open(file.path()));
+	REQUIRE(db2 != nullptr);
+
+	const auto by_id = db2->orderedById();
+	REQUIRE(by_id.size() == db2->size());
+
+	std::vector<uint32_t> ids;
+	for (auto& record : by_id) {
+		auto [id] = packed_schema(record).get<uint32_t>("id");
+		ids.push_back(id);
+	}
+
+	REQUIRE(std::ranges::is_sorted(ids));
+	REQUIRE(ids.front() == 1);
+	REQUIRE(ids.back() == 1000);
+	REQUIRE(std::ranges::count(ids, 995) == 1);
+	REQUIRE(&db2->orderedById().indexes() == &by_id.indexes());
+
+	{
+		// concurrent first calls share a single order.
+		auto fresh = makeDB2File<NativeFileSource>(packed_schema, native_fs.open(file.path()));
+		std::array<const std::vector<uint32_t>*, 4> orders{};
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < orders.size(); i++) {
+			threads.emplace_back([&, i]() {
+				orders[i] = &fresh->orderedById().indexes();
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		REQUIRE(std::ranges::all_of(orders, [&](const auto* order) { return order == orders[0]; }));
+		REQUIRE(*orders[0] == by_id.indexes());
+	}
+
+	auto check_sorted = [&]<typename T>(const std::string& name) {
+		const auto sorted = sortedBy(packed_schema, *db2, name);
+		REQUIRE(sorted.size() == db2->size());
+
+		std::vector<T> values;
+		for (uint32_t i = 0; i < sorted.size(); i++) {
+			auto [value] = packed_schema(sorted[i]).get<T>(name);
+			values.push_back(value);
+		}
+		REQUIRE(std::ranges::is_sorted(values));
+	};
+
+	check_sorted.template operator()<int16_t>("offset");
+	check_sorted.template operator()<float>("scale");
+	check_sorted.template operator()<std::string>("name");
+	check_sorted.template operator()<uint32_t>("parent");
+
+	const auto levels = decodeColumn<uint32_t>(packed_schema, *db2, 3);
+	REQUIRE(levels.size() == db2->size());
+	REQUIRE(levels[4] == 4 * 7);
+
+	REQUIRE_THROWS_AS(sortedBy(packed_schema, *db2, "missing"), WDBReaderException);
+}
+
+TEST_CASE("Columns decode single elements without whole records.", "[database:order]")
+{
+	DB2WriterOptions options;
+	options.compression = {
+		DB2FieldCompression::None,
+		DB2FieldCompression::None,
+		DB2FieldCompression::BitpackedIndexed,
+		DB2FieldCompression::Bitpacked,
+		DB2FieldCompression::BitpackedSigned,
+		DB2FieldCompression::CommonData,
+		DB2FieldCompression::None,
+		DB2FieldCompression::BitpackedIndexedArray
+	};
+	options.sections = { 5, 7 };
+	options.copyTable = { { 500, 10 } };
+
+	const auto file = writePackedFile("wdbreader_column_test.db2", packedRows(12), options);
+
+	auto native_fs = NativeFilesystem();
+	auto db2 = makeDB2File<NativeFileSource>(packed_schema, native_fs.open(file.path()));
+	REQUIRE(db2 != nullptr);
+
+	column_value_t element;
+	REQUIRE(db2->readElement(4, 3, 0, element) == RecordEncryption::NONE);
+	REQUIRE(std::get<uint64_t>(element) == 4 * 7);
+	REQUIRE(db2->readElement(12, 0, 0, element) == RecordEncryption::NONE);
+	REQUIRE(std::get<uint64_t>(element) == 500);
+
+	auto check_column = [&]<typename T>(const std::string& name, size_t array_index) {
+		const auto field_index = namedFieldIndex(packed_schema, name);
+		const auto values = decodeColumn<T>(packed_schema, *db2, field_index, array_index);
+		REQUIRE(values.size() == db2->size());
+
+		for (uint32_t i = 0; i < db2->size(); i++) {
+			const auto record = (*db2)[i];
+			auto [value] = packed_schema(record).get<T>(name);
+			REQUIRE(values[i] == value);
+		}
+	};
+
+	check_column.template operator()<uint32_t>("id", 0);
+	check_column.template operator()<std::string>("name", 0);
+	check_column.template operator()<uint32_t>("category", 0);
+	check_column.template operator()<uint16_t>("level", 0);
+	check_column.template operator()<int16_t>("offset", 0);
+	check_column.template operator()<uint8_t>("flags", 0);
+	check_column.template operator()<float>("scale", 0);
+	check_column.template operator()<uint32_t>("parent", 0);
+
+	const auto third_values = decodeColumn<uint32_t>(packed_schema, *db2, namedFieldIndex(packed_schema, "values"), 1);
+	for (uint32_t i = 0; i < 12; i++) {
+		REQUIRE(third_values[i] == i % 2 + 1);
+	}
+
+	const auto offsets = decodeColumn<int32_t>(packed_schema, *db2, namedFieldIndex(packed_schema, "offset"));
+	REQUIRE(offsets[0] == -300);
+	REQUIRE(offsets[11] == 250);
+}
+
+TEST_CASE("Legacy files read record ids from the records.", "[database:order]")
+{
+	const auto schema = RuntimeSchema({
+		Field::value<uint32_t>(Annotation().Id()),
+		Field::langString(),
+		Field::value<float>()
+	}, {
+		"id",
+		"name",
+		"scale"
+	});
+
+	const std::vector<writer_row_t> rows = {
+		{ uint64_t(9), "first", 1.5f },
+		{ uint64_t(4), "second", -2.0f }
+	};
+
+	auto native_fs = NativeFilesystem();
+
+	auto check_ids = [](const DataSource<RuntimeRecord>& source) {
+		REQUIRE(source.recordIds() == std::vector<uint32_t>{ 9, 4 });
+		REQUIRE(source.orderedById().indexes() == std::vector<uint32_t>{ 1, 0 });
+	};
+
+	DBCWriterOptions dbc_options;
+	dbc_options.version = DBCVersion::BC_WOTLK;
+	dbc_options.locale = DBCStringLocale::deDE;
+	const auto dbc_file = writeLegacyFile("wdbreader_order_legacy_test.dbc", schema, rows, dbc_options);
+
+	auto dbc = makeDBCFile<NativeFileSource>(schema, DBCVersion::BC_WOTLK, DBCStringLocale::deDE);
+	dbc.open(native_fs.open(dbc_file.path()));
+	dbc.load();
+	check_ids(dbc);
+	REQUIRE(decodeColumn<std::string>(schema, dbc, 1) == std::vector<std::string>{ "first", "second" });
+	REQUIRE(decodeColumn<float>(schema, dbc, 2) == std::vector<float>{ 1.5f, -2.0f });
+
+	const auto db2_file = writePackedFile<DB2FileFormatWDB2>("wdbreader_order_legacy_test.db2", rows, DB2WriterOptions(), schema);
+	auto db2 = makeDB2File<NativeFileSource>(schema, native_fs.open(db2_file.path()));
+	REQUIRE(db2 != nullptr);
+	check_ids(*db2);
+	REQUIRE(decodeColumn<std::string>(schema, *db2, 1) == std::vector<std::string>{ "first", "second" });
+	REQUIRE(decodeColumn<float>(schema, *db2, 2) == std::vector<float>{ 1.5f, -2.0f });
+}
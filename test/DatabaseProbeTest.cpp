@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Database/Probe.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Written files can be probed.", "[database:probe]")
+{
+	DB2WriterOptions options;
+	options.tableHash = 0x1234;
+	options.layoutHash = 0x5678;
+	options.sections = { 5, 7 };
+	options.copyTable = { { 500, 13 }, { 501, 16 } };
+
+	const auto file = writePackedFile<DB2FileFormatWDC4>("wdbreader_probe_test.db2", packedRows(12), options);
+
+	auto native_fs = NativeFilesystem();
+	auto source = native_fs.open(file.path());
+	const auto probe = probeDBFile(*source);
+
+	REQUIRE(probe.has_value());
+	REQUIRE(probe->signature.integer == WDC4_MAGIC.integer);
+	REQUIRE(probe->tableHash == 0x1234);
+	REQUIRE(probe->layoutHash == 0x5678);
+	REQUIRE(probe->recordCount == 12);
+	REQUIRE(probe->copyCount == 2);
+	REQUIRE(probe->fieldCount == 7);
+	REQUIRE(probe->sectionCount == 2);
+	REQUIRE((probe->flags & DB2HeaderFlags::HasNonInlineIds) != 0);
+	REQUIRE(probe->estimatedDecodedSize > 12 * DB2Format::recordSizeSrc(packed_schema) / 2);
+	REQUIRE(source->getPos() == 0);
+
+	{
+		// corrupt headers throw rather than allocating or estimating from garbage.
+		std::ifstream in(file.path(), std::ios::binary);
+		const std::string original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+
+		const TempFile corrupt_file("wdbreader_probe_corrupt_test.db2");
+		auto probe_corrupt = [&](auto&& corrupt) {
+			std::string bytes = original;
+			DB2FileFormatWDC4::Header header;
+			memcpy(&header, bytes.data(), sizeof(header));
+			DB2FileFormatWDC4::SectionHeader section;
+			memcpy(&section, bytes.data() + sizeof(header), sizeof(section));
+
+			corrupt(header, section);
+
+			memcpy(bytes.data(), &header, sizeof(header));
+			memcpy(bytes.data() + sizeof(header), &section, sizeof(section));
+			{
+				std::ofstream out(corrupt_file.path(), std::ios::binary | std::ios::trunc);
+				out.write(bytes.data(), bytes.size());
+			}
+
+			auto corrupt_source = native_fs.open(corrupt_file.path());
+			REQUIRE_THROWS_AS(probeDBFile(*corrupt_source), WDBReaderException);
+		};
+
+		probe_corrupt([](auto& header, auto& section) {
+			header.section_count = 0x7FFFFFFF;
+		});
+
+		probe_corrupt([](auto& header, auto& section) {
+			header.flags |= DB2HeaderFlags::HasOffsetMap;
+			section.offset_records_end = section.file_offset - 1;
+		});
+	}
+
+	const TempFile other_file("wdbreader_probe_other_test.db2");
+	{
+		std::ofstream out(other_file.path(), std::ios::binary | std::ios::trunc);
+		out << "not a db file";
+	}
+
+	auto other_source = native_fs.open(other_file.path());
+	REQUIRE_FALSE(probeDBFile(*other_source).has_value());
+}
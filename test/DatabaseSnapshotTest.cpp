@@ -0,0 +1,403 @@
+#include <catch2/catch_test_macros.hpp> 
+
+#include <WDBReader/Database/Index.hpp>
+#include <WDBReader/Database/Snapshot.hpp>
+#include <WDBReader/Filesystem/MappedFilesystem.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+namespace {
+
+	struct TestRow {
+		uint32_t id;
+		std::string name;
+		float scale;
+		uint16_t flags[2];
+		bool encrypted;
+	};
+
+	class TestDataSource final : public DataSource<RuntimeRecord> {
+	public:
+		TestDataSource(std::vector<TestRow> rows) : _rows(std::move(rows)) {}
+
+		size_t size() const override {
+			return _rows.size();
+		}
+
+		RuntimeRecord operator[](uint32_t index) const override {
+			const auto& row = _rows[index];
+			RuntimeRecord record;
+			record.recordIndex = index;
+			record.encryptionState = row.encrypted ? RecordEncryption::ENCRYPTED : RecordEncryption::NONE;
+			if (!row.encrypted) {
+				record.data.emplace_back(row.id);
+				record.data.emplace_back(makeStringData(row.name));
+				record.data.emplace_back(row.scale);
+				record.data.emplace_back(row.flags[0]);
+				record.data.emplace_back(row.flags[1]);
+			}
+			return record;
+		}
+
+		DBFormat format() const override {
+			DBFormat format(WDC3_MAGIC);
+			format.tableHash = 0x1234;
+			format.layoutHash = 0x5678;
+			return format;
+		}
+
+	private:
+		std::vector<TestRow> _rows;
+	};
+
+	RuntimeSchema makeTestSchema() {
+		return RuntimeSchema({
+			Field::value<uint32_t>(Annotation().Id()),
+			Field::string(),
+			Field::value<float>(),
+			Field::value<uint16_t[2]>()
+		}, {
+			"id",
+			"name",
+			"scale",
+			"flags"
+		});
+	}
+
+#pragma pack(push, 1)
+	struct TestFixedRecord : public FixedRecord<TestFixedRecord> {
+		struct Data {
+			uint32_t id;
+			string_data_t name;
+			float scale;
+			uint16_t flags[2];
+		} data;
+
+		size_t recordIndex;
+		RecordEncryption encryptionState;
+
+		constexpr static Schema schema = Schema(
+			Field::value<decltype(data.id)>(Annotation().Id()),
+			Field::string(),
+			Field::value<decltype(data.scale)>(),
+			Field::value<decltype(data.flags)>()
+		);
+	};
+#pragma pack(pop)
+}
+
+TEST_CASE("Snapshots can be written and read.", "[database:snapshot]")
+{
+	const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_snapshot_test.wdbs";
+	auto file_guard = ScopeGuard([&temp_file_name]() {
+		if (std::filesystem::exists(temp_file_name)) {
+			std::filesystem::remove(temp_file_name);
+		}
+	});
+
+	const auto schema = makeTestSchema();
+	const SnapshotKey key{ 0x1234, 0x5678, GameVersion(10, 2, 0, 52038) };
+	TestDataSource source({
+		{ 30, "third", 1.5f, { 1, 2 }, false },
+		{ 10, "first", 0.5f, { 3, 4 }, false },
+		{ 0, "", 0.0f, { 0, 0 }, true },
+		{ 20, "first", 2.0f, { 5, 6 }, false }
+	});
+
+	{
+		std::ofstream stream(temp_file_name, std::ios::binary);
+		writeSnapshot(stream, schema, source, key);
+	}
+
+	REQUIRE(key.fileName() == "00001234_00005678_10.2.0.52038.wdbs");
+
+	auto check = [&](const auto& snapshot) {
+		REQUIRE(snapshot.size() == 4);
+		REQUIRE(snapshot.key() == key);
+		REQUIRE(snapshot.format().signature.integer == SNAPSHOT_MAGIC.integer);
+		REQUIRE(snapshot.format().tableHash == key.tableHash);
+
+		const RuntimeRecord rec = snapshot[0];
+		REQUIRE(rec.encryptionState == RecordEncryption::NONE);
+		auto [id, name, scale, flags] = schema(rec).get<uint32_t, std::string, float, std::array<uint16_t, 2>>("id", "name", "scale", "flags");
+		REQUIRE(id == 30);
+		REQUIRE(name == "third");
+		REQUIRE(scale == 1.5f);
+		REQUIRE(flags[0] == 1);
+		REQUIRE(flags[1] == 2);
+
+		REQUIRE(snapshot[2].encryptionState == RecordEncryption::ENCRYPTED);
+
+		const RuntimeRecord rec3 = snapshot[3];
+		REQUIRE(std::string(std::get<string_data_ref_t>(schema(rec3)["name"][0])) == "first");
+
+		REQUIRE(snapshot.findById(10) == 1);
+		REQUIRE(snapshot.findById(20) == 3);
+		REQUIRE(snapshot.findById(30) == 0);
+		REQUIRE(!snapshot.findById(40).has_value());
+	};
+
+	{
+		MappedFilesystem fs;
+		auto mapped = fs.open(temp_file_name);
+		REQUIRE(readSnapshotKey(mapped.get()) == key);
+		REQUIRE(readSnapshotSchema(mapped.get()) == schema);
+
+		SnapshotFile<RuntimeSchema, RuntimeRecord, MappedFileSource> snapshot(schema);
+		snapshot.open(fs.open(temp_file_name));
+		snapshot.load();
+		check(snapshot);
+	}
+
+	{
+		// the schema is held by value, so a temporary is fine.
+		NativeFilesystem fs;
+		SnapshotFile<RuntimeSchema, RuntimeRecord, NativeFileSource> snapshot(makeTestSchema());
+		snapshot.open(fs.open(temp_file_name));
+		snapshot.load();
+		check(snapshot);
+	}
+
+	{
+		MappedFilesystem fs;
+		SnapshotFile<decltype(TestFixedRecord::schema), TestFixedRecord, MappedFileSource> snapshot(TestFixedRecord::schema);
+		snapshot.open(fs.open(temp_file_name));
+		snapshot.load();
+
+		const auto rec = snapshot[1];
+		REQUIRE(rec.data.id == 10);
+		REQUIRE(std::string(rec.data.name.get()) == "first");
+		REQUIRE(rec.data.flags[1] == 4);
+	}
+
+	{
+		const auto mismatched = RuntimeSchema({ Field::value<uint32_t>(Annotation().Id()) }, { "id" });
+		MappedFilesystem fs;
+		SnapshotFile<RuntimeSchema, RuntimeRecord, MappedFileSource> snapshot(mismatched);
+		REQUIRE_THROWS_AS(snapshot.open(fs.open(temp_file_name)), WDBReaderException);
+	}
+}
+
+TEST_CASE("Corrupt snapshots are rejected.", "[database:snapshot]")
+{
+	const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_snapshot_corrupt_test.wdbs";
+	auto file_guard = ScopeGuard([&temp_file_name]() {
+		if (std::filesystem::exists(temp_file_name)) {
+			std::filesystem::remove(temp_file_name);
+		}
+	});
+
+	const auto schema = makeTestSchema();
+	TestDataSource source({
+		{ 10, "first", 0.5f, { 3, 4 }, false },
+		{ 20, "second", 2.0f, { 5, 6 }, false }
+	});
+
+	std::ostringstream stream;
+	writeSnapshot(stream, schema, source, SnapshotKey{ 0x1234, 0x5678, GameVersion(10, 2, 0, 52038) });
+	const std::string original = stream.str();
+
+	SnapshotHeader header;
+	memcpy(&header, original.data(), sizeof(header));
+
+	auto write_file = [&temp_file_name](const std::string& bytes) {
+		std::ofstream out(temp_file_name, std::ios::binary | std::ios::trunc);
+		out.write(bytes.data(), bytes.size());
+	};
+
+	auto with_header = [&original](const SnapshotHeader& corrupt) {
+		std::string bytes = original;
+		memcpy(bytes.data(), &corrupt, sizeof(corrupt));
+		return bytes;
+	};
+
+	auto check_open_throws = [&]() {
+		{
+			MappedFilesystem fs;
+			SnapshotFile<RuntimeSchema, RuntimeRecord, MappedFileSource> snapshot(schema);
+			REQUIRE_THROWS_AS(snapshot.open(fs.open(temp_file_name)), WDBReaderException);
+		}
+		{
+			NativeFilesystem fs;
+			SnapshotFile<RuntimeSchema, RuntimeRecord, NativeFileSource> snapshot(schema);
+			REQUIRE_THROWS_AS(snapshot.open(fs.open(temp_file_name)), WDBReaderException);
+		}
+	};
+
+	SECTION("Field counts past the end of the file.")
+	{
+		auto corrupt = header;
+		corrupt.field_count = 0x7FFFFFFF;
+		write_file(with_header(corrupt));
+		check_open_throws();
+	}
+
+	SECTION("Rows past the end of the file.")
+	{
+		auto corrupt = header;
+		corrupt.record_count = 1000;
+		write_file(with_header(corrupt));
+		check_open_throws();
+	}
+
+	SECTION("Region offsets which overflow.")
+	{
+		auto corrupt = header;
+		corrupt.strings_offset = std::numeric_limits<uint64_t>::max() - 1;
+		write_file(with_header(corrupt));
+		check_open_throws();
+
+		corrupt = header;
+		corrupt.id_index_offset = std::numeric_limits<uint64_t>::max() - 1;
+		write_file(with_header(corrupt));
+		check_open_throws();
+	}
+
+	SECTION("String lengths past the string region.")
+	{
+		// rows are the encryption state, then the id followed by the name string offset.
+		uint32_t name_offset;
+		memcpy(&name_offset, original.data() + header.rows_offset + sizeof(RecordEncryption) + sizeof(uint32_t), sizeof(name_offset));
+
+		std::string bytes = original;
+		const uint32_t length = 0xFFFFFF00;
+		memcpy(bytes.data() + header.strings_offset + name_offset, &length, sizeof(length));
+		write_file(bytes);
+
+		{
+			MappedFilesystem fs;
+			SnapshotFile<RuntimeSchema, RuntimeRecord, MappedFileSource> snapshot(schema);
+			snapshot.open(fs.open(temp_file_name));
+			snapshot.load();
+			REQUIRE_THROWS_AS(snapshot[0], WDBReaderException);
+		}
+		{
+			NativeFilesystem fs;
+			SnapshotFile<RuntimeSchema, RuntimeRecord, NativeFileSource> snapshot(schema);
+			snapshot.open(fs.open(temp_file_name));
+			snapshot.load();
+			REQUIRE_THROWS_AS(snapshot[0], WDBReaderException);
+		}
+	}
+}
+
+TEST_CASE("Indexes can be built, written and read.", "[database:snapshot]")
+{
+	const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_index_test.wdbi";
+	auto file_guard = ScopeGuard([&temp_file_name]() {
+		if (std::filesystem::exists(temp_file_name)) {
+			std::filesystem::remove(temp_file_name);
+		}
+	});
+
+	const auto schema = makeTestSchema();
+	const SnapshotKey key{ 0x1234, 0x5678, GameVersion(10, 2, 0, 52038) };
+	TestDataSource source({
+		{ 30, "third", 1.5f, { 1, 2 }, false },
+		{ 10, "first", 0.5f, { 3, 4 }, false },
+		{ 0, "", 0.0f, { 0, 0 }, true },
+		{ 20, "first", 2.0f, { 5, 6 }, false },
+		{ 40, "second", -1.0f, { 3, 8 }, false }
+	});
+
+	const auto by_name = buildHashIndex<std::string>(schema, source, "name");
+	REQUIRE(by_name.keyCount() == 3);
+	REQUIRE(std::ranges::equal(by_name.find("first"), std::vector<uint32_t>{ 1, 3 }));
+	REQUIRE(std::ranges::equal(by_name.find("second"), std::vector<uint32_t>{ 4 }));
+	REQUIRE(by_name.find("").empty());
+
+	const auto by_scale = buildSortedIndex<float>(schema, source, "scale");
+	REQUIRE(by_scale.range(0.0f, 1.5f) == std::vector<uint32_t>{ 1, 0 });
+	REQUIRE(by_scale.range(-5.0f, 5.0f) == std::vector<uint32_t>{ 4, 1, 0, 3 });
+	REQUIRE(by_scale.range(3.0f, 4.0f).empty());
+
+	const auto by_flag = buildHashIndex<uint32_t>(schema, source, "flags", 0);
+	REQUIRE(std::ranges::equal(by_flag.find(3), std::vector<uint32_t>{ 1, 4 }));
+
+	REQUIRE_THROWS_AS(buildHashIndex<uint32_t>(schema, source, "name"), WDBReaderException);
+	REQUIRE(indexFileName(key, "name") == "00001234_00005678_10.2.0.52038.name.wdbi");
+
+	{
+		std::ofstream stream(temp_file_name, std::ios::binary);
+		by_name.write(stream, key);
+	}
+
+	{
+		MappedFilesystem fs;
+		auto mapped = fs.open(temp_file_name);
+		REQUIRE(readIndexKey(mapped.get()) == key);
+
+		const auto read_index = HashIndex<std::string>::read(mapped.get());
+		REQUIRE(read_index.keyCount() == 3);
+		REQUIRE(std::ranges::equal(read_index.find("first"), std::vector<uint32_t>{ 1, 3 }));
+		REQUIRE(read_index.postings().fieldIndex == 1);
+		REQUIRE(read_index.postings().recordCount == 5);
+
+		const auto sorted_from_hash = SortedIndex<std::string>::read(mapped.get());
+		REQUIRE(sorted_from_hash.range("f", "s") == std::vector<uint32_t>{ 1, 3 });
+
+		REQUIRE_THROWS_AS(HashIndex<uint32_t>::read(mapped.get()), WDBReaderException);
+	}
+
+	{
+		std::ofstream stream(temp_file_name, std::ios::binary | std::ios::trunc);
+		by_scale.write(stream, key);
+	}
+
+	{
+		NativeFilesystem fs;
+		auto native = fs.open(temp_file_name);
+		const auto read_index = SortedIndex<float>::read(native.get());
+		REQUIRE(read_index.range(0.0f, 1.5f) == std::vector<uint32_t>{ 1, 0 });
+	}
+}
+
+TEST_CASE("String columns can be searched.", "[database:snapshot]")
+{
+	const auto schema = makeTestSchema();
+	const std::vector<TestRow> rows{
+		{ 1, "Thunderfury, Blessed Blade", 0.0f, { 0, 0 }, false },
+		{ 2, "Sulfuras, Hand of Ragnaros", 0.0f, { 0, 0 }, false },
+		{ 3, "Secret Blade", 0.0f, { 0, 0 }, true },
+		{ 4, "thunderfury, blessed blade", 0.0f, { 0, 0 }, false },
+		{ 5, "Ashbringer", 0.0f, { 0, 0 }, false },
+		{ 6, "", 0.0f, { 0, 0 }, false }
+	};
+	TestDataSource source(rows);
+
+	const auto search = buildStringSearchIndex(schema, source, "name");
+	REQUIRE(search.stringCount() == 4);
+
+	REQUIRE(search.prefix("THUNDER") == std::vector<uint32_t>{ 0, 3 });
+	REQUIRE(search.prefix("sul") == std::vector<uint32_t>{ 1 });
+	REQUIRE(search.prefix("blade").empty());
+
+	REQUIRE(search.contains("BLADE") == std::vector<uint32_t>{ 0, 3 });
+	REQUIRE(search.contains("and of rag") == std::vector<uint32_t>{ 1 });
+	REQUIRE(search.contains("ash") == std::vector<uint32_t>{ 4 });
+	REQUIRE(search.contains("as") == std::vector<uint32_t>{ 1, 4 });
+	REQUIRE(search.contains("bladeblade").empty());
+	REQUIRE(search.contains("xyz").empty());
+	REQUIRE(search.contains("") == std::vector<uint32_t>{ 0, 1, 3, 4, 5 });
+
+	// every query agrees with a plain scan of the decoded column.
+	for (const auto query : { "a", "ur", "rag", "fury, b", "er", "ssed" }) {
+		std::vector<uint32_t> expected;
+		for (uint32_t i = 0; i < rows.size(); i++) {
+			if (!rows[i].encrypted && StringSearchIndex::lower(rows[i].name).find(query) != std::string::npos) {
+				expected.push_back(i);
+			}
+		}
+		REQUIRE(search.contains(query) == expected);
+	}
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp> 
 
 #include <WDBReader/Database.hpp>
+#include <WDBReader/Database/StringStorage.hpp>
 
 using namespace WDBReader::Database;
 
@@ -218,6 +219,65 @@ TEST_CASE("Runtime schema can read runtime records (array).", "[database]")
     REQUIRE(array1[0] == 11);
 }
 
+TEST_CASE("Runtime schema fields can be resolved once.", "[database]")
+{
+    auto schema = RuntimeSchema(
+        {
+            Field::value<uint32_t>(Annotation().Id().NonInline()),
+            Field::value<uint32_t[3]>(),
+            Field::value<int8_t>(),
+            Field::value<uint32_t>(),
+        },
+        {
+            "id",
+            "array",
+            "sbyte",
+            "id"
+        }
+    );
+
+    auto record = RuntimeRecord();
+    record.data.push_back(runtime_value_t(10u));
+    record.data.push_back(runtime_value_t(11u));
+    record.data.push_back(runtime_value_t(12u));
+    record.data.push_back(runtime_value_t(13u));
+    record.data.push_back(uint8_t(-1));
+    record.data.push_back(runtime_value_t(20u));
+
+    REQUIRE(schema.fieldIndex("id") == 0u);    // first duplicate wins.
+    REQUIRE(schema.fieldIndex("array") == 1u);
+    REQUIRE(schema.fieldIndex("sbyte") == 2u);
+    REQUIRE_FALSE(schema.fieldIndex("missing").has_value());
+    REQUIRE_THROWS_AS(schema.handle("missing"), std::out_of_range);
+    REQUIRE_FALSE(RuntimeSchema().fieldIndex("id").has_value());
+
+    const auto handles = schema.compile("sbyte", "array", "id");
+    REQUIRE(handles[1].offset == 1);
+
+    // copies keep working, as the handles are indexes.
+    const RuntimeSchema copy = schema;
+    const std::array<const RuntimeSchema*, 2> schemas = { &schema, &copy };
+    for (const auto* s : schemas) {
+        auto accessor = (*s)(record);
+
+        auto [sbyte, array, id] = accessor.get<int32_t, std::array<uint32_t, 3>, uint32_t>(handles);
+        REQUIRE(sbyte == -1);
+        REQUIRE(array[2] == 13);
+        REQUIRE(id == 10);
+
+        REQUIRE(std::get<uint32_t>(accessor[handles[2]][0]) == 10);
+        REQUIRE(std::get<uint32_t>(accessor["id"][0]) == 10);
+
+        // names and handles can be mixed.
+        auto [named_id, handle_sbyte] = accessor.get<uint32_t, int8_t>("id", handles[0]);
+        REQUIRE(named_id == 10);
+        REQUIRE(handle_sbyte == -1);
+    }
+
+    REQUIRE_THROWS_AS(schema(record).get<uint32_t>("missing"), std::runtime_error);
+    REQUIRE_THROWS_AS(schema(record)["missing"], std::out_of_range);
+}
+
 TEST_CASE("Runtime schema reading handles conversions.", "[database]")
 {
     SECTION("Handles casts")
@@ -351,4 +411,92 @@ TEST_CASE("Format Strings", "[database]")
 {
     auto str = WDB2_MAGIC.str();
     REQUIRE(str == "WDB2");
-}
\ No newline at end of file
+}
+
+TEST_CASE("String storage policies.", "[database]")
+{
+    SECTION("Heap storage")
+    {
+        HeapStringStorage storage;
+        auto str = storage.store("hello");
+        REQUIRE(std::string_view(str.get()) == "hello");
+    }
+
+    SECTION("Arena storage")
+    {
+        auto arena = std::make_shared<StringArena>(16);
+
+        {
+            ArenaStringStorage storage(arena);
+            auto str1 = storage.store("hello");
+            auto str2 = storage.store("world");
+            auto str3 = storage.store("a string longer than the block size");
+            auto empty = storage.store("");
+
+            REQUIRE(std::string_view(str1.get()) == "hello");
+            REQUIRE(std::string_view(str2.get()) == "world");
+            REQUIRE(std::string_view(str3.get()) == "a string longer than the block size");
+            REQUIRE(std::string_view(empty.get()) == "");
+
+            REQUIRE(arena->blockCount() == 2);
+        }
+
+        // values released, memory still held by the arena.
+        REQUIRE(arena->bytesUsed() > 0);
+
+        arena->reset();
+        REQUIRE(arena->blockCount() == 0);
+    }
+
+    SECTION("Storage values can be stored in runtime records")
+    {
+        ArenaStringStorage storage;
+        auto record = RuntimeRecord();
+        record.data.push_back(runtime_value_t(10u));
+        record.data.push_back(storage.store("name"));
+
+        REQUIRE(std::string_view(std::get<string_data_t>(record.data[1]).get()) == "name");
+    }
+}
+
+TEST_CASE("Strings can be interned.", "[database]")
+{
+    auto pool = std::make_shared<StringInternPool>();
+    InternedStringStorage table1(pool);
+    InternedStringStorage table2(pool);
+
+    auto str1 = table1.store("texture.blp");
+    auto str2 = table2.store("texture.blp");
+    auto str3 = table2.store("other.blp");
+    auto empty1 = table1.store("");
+    auto empty2 = table2.store("");
+
+    REQUIRE(str1.get() == str2.get());
+    REQUIRE(str1.get() != str3.get());
+    REQUIRE(empty1.get() == empty2.get());
+    REQUIRE(std::string_view(str3.get()) == "other.blp");
+    REQUIRE(pool->intern("other.blp").data() == str3.get());
+
+    const auto stats = pool->stats();
+    REQUIRE(stats.lookups == 6);
+    REQUIRE(stats.emptyLookups == 2);
+    REQUIRE(stats.uniqueStrings == 2);
+    REQUIRE(stats.savedBytes > 0);
+}
+
+TEST_CASE("Radix sort keeps ordering and stability.", "[database]")
+{
+    REQUIRE(radixKey(int16_t(-5)) < radixKey(int16_t(3)));
+    REQUIRE(radixKey(int32_t(-100)) < radixKey(int32_t(-1)));
+    REQUIRE(radixKey(-1.5f) < radixKey(-0.5f));
+    REQUIRE(radixKey(-0.5f) < radixKey(0.0f));
+    REQUIRE(radixKey(0.0f) < radixKey(2.0f));
+    REQUIRE(radixKey(uint64_t(1) << 40) > radixKey(uint64_t(7)));
+
+    const std::vector<uint32_t> keys = { 300, 5, 70000, 5, 0, 300, 1u << 31 };
+    const auto order = radixSortPermutation(keys);
+    REQUIRE(order == std::vector<uint32_t>{ 4, 1, 3, 0, 5, 2, 6 });
+
+    REQUIRE(radixSortPermutation(std::vector<uint32_t>{}).empty());
+    REQUIRE(radixSortPermutation(std::vector<uint64_t>{ 9, 9, 9 }) == std::vector<uint32_t>{ 0, 1, 2 });
+}
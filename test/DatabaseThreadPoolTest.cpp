@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Filesystem/MappedFilesystem.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <WDBReader/ThreadPool.hpp>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Files load the same with a thread pool.", "[database:threadpool]")
+{
+	ThreadPool pool(4);
+	auto native_fs = NativeFilesystem();
+	auto mapped_fs = MappedFilesystem();
+
+	// strings are compared by content, everything else by value.
+	auto values_of = [](const RuntimeRecord& record) {
+		std::vector<std::variant<uint64_t, float, std::string>> values;
+		for (const auto& value : record.data) {
+			std::visit([&values]<typename T>(const T& v) {
+				if constexpr (std::is_same_v<T, string_data_t>) {
+					values.emplace_back(std::string(v.get()));
+				}
+				else if constexpr (std::is_same_v<T, float>) {
+					values.emplace_back(v);
+				}
+				else {
+					values.emplace_back(uint64_t(v));
+				}
+			}, value);
+		}
+		return values;
+	};
+
+	auto check_options = [&](std::string_view name, const RuntimeSchema& schema, const std::vector<writer_row_t>& rows, const DB2WriterOptions& options) {
+		const auto file = writePackedFile<DB2FileFormatWDC4>(name, rows, options, schema);
+
+		DB2File<DB2FileFormatWDC4, RuntimeSchema, RuntimeRecord, NativeFileSource> sequential(schema);
+		sequential.open(native_fs.open(file.path()));
+		sequential.load();
+
+		DB2File<DB2FileFormatWDC4, RuntimeSchema, RuntimeRecord, MappedFileSource> parallel(schema);
+		parallel.setThreadPool(&pool);
+		parallel.open(mapped_fs.open(file.path()));
+		parallel.load();
+		parallel.preloadFieldData();
+
+		REQUIRE(parallel.size() == sequential.size());
+
+		size_t mismatches = 0;
+		for (uint32_t i = 0; i < sequential.size(); i++) {
+			mismatches += values_of(parallel[i]) != values_of(sequential[i]) ? 1 : 0;
+		}
+		REQUIRE(mismatches == 0);
+
+		const auto sequential_stats = sequential.loadStats();
+		const auto parallel_stats = parallel.loadStats();
+		for (const auto phase : { LoadPhase::ID_LIST, LoadPhase::COPY_TABLE, LoadPhase::OFFSET_MAP, LoadPhase::RELATIONSHIPS }) {
+			REQUIRE(parallel_stats[phase].bytes == sequential_stats[phase].bytes);
+		}
+	};
+
+	// enough rows for the section blocks to be read across the pool.
+	auto rows = packedRows(30000);
+
+	DB2WriterOptions options;
+	options.compression = {
+		DB2FieldCompression::None,
+		DB2FieldCompression::None,
+		DB2FieldCompression::BitpackedIndexed,
+		DB2FieldCompression::Bitpacked,
+		DB2FieldCompression::BitpackedSigned,
+		DB2FieldCompression::CommonData,
+		DB2FieldCompression::None,
+		DB2FieldCompression::BitpackedIndexedArray
+	};
+	options.sections = { 12000, 0, 18000 };
+	options.copyTable = { { 500, 13 }, { 501, 16 } };
+	check_options("wdbreader_pool_packed_test.db2", packed_schema, rows, options);
+
+	// sparse files cant hold relationships, so the trailing relation field is dropped.
+	const auto sparse_schema = RuntimeSchema(
+		std::vector<Field>(packed_schema.fields().begin(), packed_schema.fields().end() - 1),
+		std::vector<RuntimeSchema::field_name_t>(packed_schema.names().begin(), packed_schema.names().end() - 1)
+	);
+	for (auto& row : rows) {
+		row.pop_back();
+	}
+
+	options.compression.clear();
+	options.copyTable.clear();
+	options.sparse = true;
+	check_options("wdbreader_pool_sparse_test.db2", sparse_schema, rows, options);
+}
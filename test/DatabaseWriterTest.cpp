@@ -0,0 +1,204 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <WDBReader/Database/Writer.hpp>
+#include <WDBReader/Filesystem/NativeFilesystem.hpp>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "WriterFixture.hpp"
+
+using namespace WDBReader::Database;
+using namespace WDBReader::Filesystem;
+using namespace WDBReader;
+
+TEST_CASE("Packed DB2 files can be written and read.", "[database:writer]")
+{
+	const auto rows = packedRows(12);
+
+	DB2WriterOptions options;
+	options.compression = {
+		DB2FieldCompression::None,
+		DB2FieldCompression::None,
+		DB2FieldCompression::BitpackedIndexed,
+		DB2FieldCompression::Bitpacked,
+		DB2FieldCompression::BitpackedSigned,
+		DB2FieldCompression::CommonData,
+		DB2FieldCompression::None,
+		DB2FieldCompression::BitpackedIndexedArray
+	};
+	options.sections = { 5, 7 };
+	options.copyTable = { { 500, 13 } };
+
+	auto check_format = [&]<TDB2FormatModern F>() {
+		const auto file = writePackedFile<F>("wdbreader_writer_packed_test.db2", rows, options);
+
+		auto native_fs = NativeFilesystem();
+		auto db2 = makeDB2File<NativeFileSource>(packed_schema, native_fs.open(file.path()));
+
+		REQUIRE(db2 != nullptr);
+		REQUIRE(db2->size() == rows.size() + 1);
+
+		for (uint32_t i = 0; i < rows.size(); i++) {
+			auto [id, name, category, level, offset, flags, scale, values, parent] = packed_schema((*db2)[i]).get<
+				uint32_t, std::string, uint32_t, uint16_t, int16_t, uint8_t, float, std::array<uint32_t, 3>, uint32_t
+			>("id", "name", "category", "level", "offset", "flags", "scale", "values", "parent");
+
+			REQUIRE(id == 10 + i * 3);
+			REQUIRE(name == "name_" + std::to_string(i % 4));
+			REQUIRE(category == (i % 3) * 100);
+			REQUIRE(level == i * 7);
+			REQUIRE(offset == int16_t(i * 50) - 300);
+			REQUIRE(flags == (i % 5 == 0 ? 3 : 1));
+			REQUIRE(scale == i * 0.25f);
+			REQUIRE(values == std::array<uint32_t, 3>{ i % 2, i % 2 + 1, 9 });
+			REQUIRE(parent == 1000 + i);
+		}
+
+		auto [copy_id, copy_name] = packed_schema((*db2)[rows.size()]).get<uint32_t, std::string>("id", "name");
+		REQUIRE(copy_id == 500);
+		REQUIRE(copy_name == "name_1");
+	};
+
+	check_format.template operator()<DB2FileFormatWDC3>();
+	check_format.template operator()<DB2FileFormatWDC5>();
+}
+
+TEST_CASE("Sparse DB2 files can be written and read.", "[database:writer]")
+{
+	const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_writer_sparse_test.db2";
+	auto file_guard = ScopeGuard([&temp_file_name]() {
+		if (std::filesystem::exists(temp_file_name)) {
+			std::filesystem::remove(temp_file_name);
+		}
+	});
+
+	const auto schema = RuntimeSchema({
+		Field::value<uint32_t>(Annotation().Id()),
+		Field::string(),
+		Field::value<uint16_t[2]>()
+	}, {
+		"id",
+		"name",
+		"values"
+	});
+
+	auto rows = [](uint32_t index, writer_row_t& row) {
+		row = { uint64_t(index + 1), std::string(index, 'a'), uint64_t(index), uint64_t(index * 2) };
+	};
+
+	DB2WriterOptions options;
+	options.sparse = true;
+	options.sections = { 3, 0, 4 };
+
+	{
+		std::ofstream out(temp_file_name, std::ios::binary | std::ios::trunc);
+		writeDB2File<DB2FileFormatWDC4>(out, schema, 7, rows, options);
+	}
+
+	auto native_fs = NativeFilesystem();
+	auto db2 = makeDB2File<NativeFileSource>(schema, native_fs.open(temp_file_name));
+
+	REQUIRE(db2 != nullptr);
+	REQUIRE(db2->size() == 7);
+
+	for (uint32_t i = 0; i < 7; i++) {
+		auto [id, name, values] = schema((*db2)[i]).get<uint32_t, std::string, std::array<uint16_t, 2>>("id", "name", "values");
+		REQUIRE(id == i + 1);
+		REQUIRE(name == std::string(i, 'a'));
+		REQUIRE(values == std::array<uint16_t, 2>{ uint16_t(i), uint16_t(i * 2) });
+	}
+}
+
+TEST_CASE("Legacy files can be written and read.", "[database:writer]")
+{
+	const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_writer_legacy_test.db";
+	auto file_guard = ScopeGuard([&temp_file_name]() {
+		if (std::filesystem::exists(temp_file_name)) {
+			std::filesystem::remove(temp_file_name);
+		}
+	});
+
+	const auto schema = RuntimeSchema({
+		Field::value<uint32_t>(Annotation().Id()),
+		Field::langString(),
+		Field::value<float>()
+	}, {
+		"id",
+		"name",
+		"scale"
+	});
+
+	const std::vector<writer_row_t> rows = {
+		{ uint64_t(4), "first", 1.5f },
+		{ uint64_t(9), "second", -2.0f }
+	};
+
+	auto native_fs = NativeFilesystem();
+
+	auto check_rows = [&](const DataSource<RuntimeRecord>& source) {
+		for (uint32_t i = 0; i < rows.size(); i++) {
+			auto [id, name, scale] = schema(source[i]).get<uint32_t, std::string, float>("id", "name", "scale");
+			REQUIRE(id == std::get<uint64_t>(rows[i][0]));
+			REQUIRE(name == std::get<std::string>(rows[i][1]));
+			REQUIRE(scale == std::get<float>(rows[i][2]));
+		}
+	};
+
+	{
+		std::ofstream out(temp_file_name, std::ios::binary | std::ios::trunc);
+		DBCWriterOptions options;
+		options.version = DBCVersion::BC_WOTLK;
+		options.locale = DBCStringLocale::deDE;
+		writeDBCFile(out, schema, rows, options);
+	}
+
+	auto dbc = makeDBCFile<NativeFileSource>(schema, DBCVersion::BC_WOTLK, DBCStringLocale::deDE);
+	dbc.open(native_fs.open(temp_file_name));
+	dbc.load();
+
+	REQUIRE(dbc.size() == rows.size());
+	check_rows(dbc);
+
+	{
+		std::ofstream out(temp_file_name, std::ios::binary | std::ios::trunc);
+		writeDB2File<DB2FileFormatWDB2>(out, schema, rows);
+	}
+
+	auto db2 = makeDB2File<NativeFileSource>(schema, native_fs.open(temp_file_name));
+	REQUIRE(db2 != nullptr);
+	REQUIRE(db2->size() == rows.size());
+	check_rows(*db2);
+}
+
+TEST_CASE("Writer rejects unsupported layouts.", "[database:writer]")
+{
+	std::ostringstream out;
+	const auto schema = RuntimeSchema({
+		Field::value<uint32_t>(Annotation().Id()),
+		Field::value<float>()
+	}, {
+		"id",
+		"scale"
+	});
+
+	const std::vector<writer_row_t> rows = { { uint64_t(1), 1.0f } };
+
+	DB2WriterOptions options;
+	options.compression = { DB2FieldCompression::None, DB2FieldCompression::Bitpacked };
+	REQUIRE_THROWS_AS(writeDB2File<DB2FileFormatWDC3>(out, schema, rows, options), WDBReaderException);
+
+	options.compression = { DB2FieldCompression::None };
+	options.copyTable = { { 2, 1 } };
+	REQUIRE_THROWS_AS(writeDB2File<DB2FileFormatWDC3>(out, schema, rows, options), WDBReaderException);
+
+	options.copyTable.clear();
+	options.sections = { 2 };
+	REQUIRE_THROWS_AS(writeDB2File<DB2FileFormatWDC3>(out, schema, rows, options), WDBReaderException);
+
+	const std::vector<writer_row_t> short_rows = { { uint64_t(1) } };
+	REQUIRE_THROWS_AS(writeDBCFile(out, schema, short_rows), WDBReaderException);
+}
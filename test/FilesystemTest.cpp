@@ -1,10 +1,15 @@
 #include <catch2/catch_test_macros.hpp> 
 
 #include <WDBReader/Filesystem.hpp>
+#include <WDBReader/Filesystem/CachedFileSource.hpp>
+#include <WDBReader/Filesystem/DiskCacheFilesystem.hpp>
+#include <WDBReader/Filesystem/InstrumentedFileSource.hpp>
+#include <WDBReader/Filesystem/MappedFilesystem.hpp>
 #include <WDBReader/Filesystem/NativeFilesystem.hpp>
 #include <WDBReader/Utility.hpp>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
 
 using namespace WDBReader::Filesystem;
 using namespace WDBReader;
@@ -37,6 +42,237 @@ TEST_CASE("Native filesystem can be read.", "[filesystem]")
     REQUIRE(out == msg);
 }
 
+TEST_CASE("Mapped filesystem can be read.", "[filesystem]")
+{
+    const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_mapped_test.txt";
+    auto file_guard = ScopeGuard([&temp_file_name]() {
+        if (std::filesystem::exists(temp_file_name)) {
+            std::filesystem::remove(temp_file_name);
+        }
+    });
+
+    const std::string msg = "Hello world.";
+    {
+        std::ofstream writer(temp_file_name, std::ios::binary);
+        writer << msg;
+    }
+
+    MappedFilesystem mapped_fs;
+    auto mapped_source = mapped_fs.open(temp_file_name);
+
+    REQUIRE(mapped_source->size() == msg.size());
+    REQUIRE(mapped_source->getPos() == 0);
+
+    std::string out;
+    out.resize(msg.size());
+    mapped_source->read(out.data(), out.size());
+    REQUIRE(out == msg);
+
+    std::string world(5, '\0');
+    mapped_source->readAt(world.data(), 6, world.size());
+    REQUIRE(world == "world");
+    REQUIRE(mapped_source->getPos() == msg.size());
+
+    REQUIRE_THROWS_AS(mapped_source->readAt(world.data(), 10, world.size()), WDBReaderException);
+}
+
+TEST_CASE("Disk cache serves extracted files.", "[filesystem]")
+{
+    const auto temp_dir = std::filesystem::temp_directory_path() / "wdbreader_disk_cache_test";
+    auto dir_guard = ScopeGuard([&temp_dir]() {
+        std::filesystem::remove_all(temp_dir);
+    });
+
+    const auto source_dir = temp_dir / "source";
+    const auto cache_dir = temp_dir / "cache";
+    std::filesystem::create_directories(source_dir);
+
+    auto write_file = [&source_dir](const std::string& name, const std::string& content) {
+        std::ofstream writer(source_dir / name, std::ios::binary);
+        writer << content;
+    };
+
+    write_file("a.txt", std::string(100, 'a'));
+    write_file("b.txt", std::string(100, 'b'));
+    write_file("c.txt", std::string(100, 'c'));
+
+    const GameVersion build(3, 3, 5, 12340);
+
+    auto read_all = [](auto& source) {
+        std::string out(source->size(), '\0');
+        source->read(out.data(), out.size());
+        return out;
+    };
+
+    {
+        DiskCacheFilesystem<NativeFilesystem, std::string> fs(NativeFilesystem(), cache_dir, build, 250);
+
+        auto a = fs.open((source_dir / "a.txt").string());
+        REQUIRE(read_all(a) == std::string(100, 'a'));
+        REQUIRE(fs.cache().stats().misses == 1);
+
+        auto a_again = fs.open((source_dir / "a.txt").string());
+        REQUIRE(read_all(a_again) == std::string(100, 'a'));
+        REQUIRE(fs.cache().stats().hits == 1);
+
+        fs.open((source_dir / "b.txt").string());
+        fs.open((source_dir / "a.txt").string());
+        fs.open((source_dir / "c.txt").string());
+
+        // b is least recently used.
+        const auto stats = fs.cache().stats();
+        REQUIRE(stats.evictions == 1);
+        REQUIRE(stats.entries == 2);
+        REQUIRE(stats.totalBytes == 200);
+    }
+
+    {
+        // entries persist between instances, keyed by build.
+        DiskCache cache(cache_dir / build.toString());
+        REQUIRE(cache.stats().entries == 2);
+        REQUIRE(cache.find(diskCacheKey((source_dir / "a.txt").string())) != nullptr);
+        REQUIRE(cache.find(diskCacheKey((source_dir / "b.txt").string())) == nullptr);
+
+        const std::string content = "original";
+        cache.insert("corrupt.bin", content.data(), content.size());
+        cache.insert("resized.bin", content.data(), content.size());
+
+        // replacing an entry counts only the new bytes, and leaves no temporary files behind.
+        const auto before = cache.stats();
+        const std::string first = "first", second = "second!";
+        cache.insert("replaced.bin", first.data(), first.size());
+        cache.insert("replaced.bin", second.data(), second.size());
+        REQUIRE(cache.stats().entries == before.entries + 1);
+        REQUIRE(cache.stats().totalBytes == before.totalBytes + second.size());
+        auto replaced = cache.find("replaced.bin");
+        REQUIRE(read_all(replaced) == second);
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(cache.root())) {
+            REQUIRE(entry.path().extension() != ".tmp");
+        }
+    }
+
+    {
+        // entries from an earlier run are hashed when first opened, corrupted entries are discarded.
+        DiskCache cache(cache_dir / build.toString());
+        {
+            std::ofstream writer(cache.root() / "corrupt.bin", std::ios::binary);
+            writer << "modified";
+        }
+        REQUIRE(cache.find("corrupt.bin") == nullptr);
+        REQUIRE(cache.stats().corrupted == 1);
+
+        // size is checked on every open.
+        REQUIRE(cache.find("resized.bin") != nullptr);
+        {
+            std::ofstream writer(cache.root() / "resized.bin", std::ios::binary);
+            writer << "truncated";
+        }
+        REQUIRE(cache.find("resized.bin") == nullptr);
+        REQUIRE(cache.stats().corrupted == 2);
+    }
+
+    REQUIRE(diskCacheKey("DBFilesClient\\Item.dbc") == "dbfilesclient/item.dbc");
+    REQUIRE(diskCacheKey(uint32_t(1349477)) == "1349477");
+}
+
+TEST_CASE("Cached file source serves reads from blocks.", "[filesystem]")
+{
+    const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_cached_test.txt";
+    auto file_guard = ScopeGuard([&temp_file_name]() {
+        if (std::filesystem::exists(temp_file_name)) {
+            std::filesystem::remove(temp_file_name);
+        }
+    });
+
+    std::string msg;
+    for (int i = 0; i < 100; i++) {
+        msg.push_back(static_cast<char>('a' + (i % 26)));
+    }
+
+    {
+        std::ofstream writer(temp_file_name, std::ios::binary);
+        writer << msg;
+    }
+
+    NativeFilesystem native_fs;
+    auto cached = makeCachedFileSource(native_fs.open(temp_file_name), 16, 2);
+
+    REQUIRE(cached->size() == msg.size());
+
+    auto read_at = [&cached](uint64_t pos, size_t bytes) {
+        std::string out(bytes, '\0');
+        cached->setPos(pos);
+        cached->read(out.data(), bytes);
+        return out;
+    };
+
+    REQUIRE(read_at(0, 4) == msg.substr(0, 4));
+    REQUIRE(read_at(4, 4) == msg.substr(4, 4));
+    REQUIRE(cached->stats().misses == 1);
+    REQUIRE(cached->stats().hits == 1);
+
+    // spans blocks 0 - 2.
+    REQUIRE(read_at(10, 30) == msg.substr(10, 30));
+    REQUIRE(cached->getPos() == 40);
+
+    // final partial block.
+    REQUIRE(read_at(90, 10) == msg.substr(90, 10));
+    REQUIRE(cached->stats().bytesRead == 16 * 4 + 4);
+
+    // block 0 was evicted.
+    const auto misses = cached->stats().misses;
+    REQUIRE(read_at(0, 1) == msg.substr(0, 1));
+    REQUIRE(cached->stats().misses == misses + 1);
+
+    REQUIRE_THROWS_AS(read_at(95, 10), WDBReaderException);
+}
+
+TEST_CASE("Instrumented file source records reads.", "[filesystem]")
+{
+    const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_instrumented_test.txt";
+    auto file_guard = ScopeGuard([&temp_file_name]() {
+        if (std::filesystem::exists(temp_file_name)) {
+            std::filesystem::remove(temp_file_name);
+        }
+    });
+
+    {
+        std::ofstream writer(temp_file_name, std::ios::binary);
+        writer << std::string(256, 'x');
+    }
+
+    NativeFilesystem native_fs;
+    auto source = makeInstrumentedFileSource(native_fs.open(temp_file_name));
+
+    std::array<char, 64> buffer;
+    source->read(buffer.data(), 32);
+    source->read(buffer.data(), 32);
+    source->setPos(200);
+    source->read(buffer.data(), 8);
+    source->setPos(208);
+    source->setPos(100);
+
+    const auto& stats = source->stats();
+    REQUIRE(stats.readCalls == 3);
+    REQUIRE(stats.bytesRead == 72);
+    REQUIRE(stats.setPosCalls == 3);
+    REQUIRE(stats.redundantSetPosCalls == 1);
+    REQUIRE(stats.seekDistance == (200 - 64) + (208 - 100));
+    REQUIRE(stats.readSize.count == 3);
+    REQUIRE(stats.readSize.max == 32);
+    REQUIRE(stats.readSize.percentile(0.5) == 32);
+    REQUIRE(stats.readSize.percentile(0.1) == 15);
+    REQUIRE(stats.readLatency.count == 3);
+
+    std::stringstream report;
+    source->report(report, "test");
+    REQUIRE(report.str().find("reads: 3") != std::string::npos);
+
+    source->resetStats();
+    REQUIRE(source->stats().readCalls == 0);
+}
+
 #ifdef TESTING_CASC_DIR
 #include <WDBReader/Filesystem/CASCFilesystem.hpp>
 
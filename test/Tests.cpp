@@ -1,6 +1,12 @@
 #include <catch2/catch_test_macros.hpp> 
 
+#include <WDBReader/ThreadPool.hpp>
+#include <WDBReader/Trace.hpp>
 #include <WDBReader/Utility.hpp>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 using namespace WDBReader;
 
@@ -24,6 +30,12 @@ TEST_CASE("Game versions can be parsed.", "[utility]")
 
     REQUIRE(parsed.has_value());
     REQUIRE(expected == parsed.value());
+    REQUIRE(GameVersion(std::string("3.3.5.12340")) == expected);
+
+    for (const auto invalid : { "", "3.3.5", "3.3.5.", "3..5.12340", "3.3.5.12340a", "a.3.5.12340", "3.3.5.99999999999" }) {
+        REQUIRE_FALSE(GameVersion::fromString(invalid).has_value());
+    }
+    REQUIRE_THROWS_AS(GameVersion(std::string("3.3")), std::runtime_error);
 }
 
 
@@ -40,4 +52,73 @@ TEST_CASE("Scope guard called.", "[utility]")
     }
 
     REQUIRE(called);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Trace events are recorded.", "[utility]")
+{
+    auto& recorder = Trace::recorder();
+
+    {
+        Trace::Scope ignored("test", "ignored");
+    }
+    REQUIRE(recorder.events().empty());
+
+    recorder.start();
+    {
+        Trace::Scope outer("test", "outer", "detail \"quoted\"");
+        Trace::Scope inner("test", "inner");
+    }
+    recorder.stop();
+
+    {
+        Trace::Scope ignored("test", "ignored");
+    }
+
+    const auto events = recorder.events();
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[0].name == "inner");
+    REQUIRE(events[1].name == "outer");
+    REQUIRE(events[1].start <= events[0].start);
+
+    std::stringstream json;
+    recorder.write(json);
+    REQUIRE(json.str().find("\"name\":\"outer\"") != std::string::npos);
+    REQUIRE(json.str().find("detail \\\"quoted\\\"") != std::string::npos);
+    REQUIRE(json.str().find("\"ph\":\"X\"") != std::string::npos);
+}
+
+TEST_CASE("Thread pool runs nested work.", "[utility]")
+{
+    ThreadPool pool(3);
+    REQUIRE(pool.currentWorker() == ThreadPool::NOT_A_WORKER);
+
+    std::atomic<size_t> total = 0;
+    std::atomic<bool> workers_known = true;
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < 8; i++) {
+        futures.push_back(pool.submit([&]() {
+            if (pool.currentWorker() >= pool.size()) {
+                workers_known = false;
+            }
+
+            // nested from a worker, helpers go to its own queue and can be stolen.
+            pool.parallelFor(100, [&](size_t index) {
+                total += index;
+            });
+        }));
+    }
+
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    REQUIRE(workers_known);
+    REQUIRE(total == 8 * 4950);
+    REQUIRE(pool.submit([]() { return 42; }).get() == 42);
+
+    REQUIRE_THROWS_AS(pool.parallelFor(10, [](size_t index) {
+        if (index == 7) {
+            throw std::runtime_error("failed");
+        }
+    }), std::runtime_error);
+}
@@ -1,9 +1,331 @@
 #include <catch2/catch_test_macros.hpp> 
 
 #include <WDBReader/WoWDBDefs.hpp>
+#include <WDBReader/WoWDBDefsBundle.hpp>
+#include <WDBReader/Utility.hpp>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
 
 using namespace WDBReader::WoWDBDefs;
+using namespace WDBReader;
+
+TEST_CASE("Definition text is parsed.", "[wowdbdefs]")
+{
+    std::istringstream stream(
+        "COLUMNS\n"
+        "int ID\n"
+        "int<Spell::ID> SpellID // the spell cast\n"
+        "string Name?\n"
+        "locstring Description_lang\n"
+        "float Coefficient\n"
+        "\n"
+        "LAYOUT 1A2B3C4D, 5E6F7A8B\n"
+        "BUILD 3.3.5.12340, 3.3.3.11723\n"
+        "BUILD 3.0.1.8303-3.2.2.10505\n"
+        "COMMENT  not verified \n"
+        "$noninline,id$ID<u32>\n"
+        "$relation$SpellID<32>\n"
+        "Name\n"
+        "Description_lang\n"
+        "Coefficient[3]\n"
+        "\n"
+        "LAYOUT 0E84A21C\n"
+        "$id$ID<32>\n"
+        "Name\n"
+        "\n"
+    );
+
+    const auto definition = DBDReader::read(stream);
+
+    REQUIRE(definition.columnDefinitions.size() == 5);
+    const auto& spell = definition.columnDefinitions.at("SpellID");
+    REQUIRE(spell.type == "int");
+    REQUIRE(spell.foreignTable == "Spell");
+    REQUIRE(spell.foreignColumn == "ID");
+    REQUIRE(spell.comment == "the spell cast");
+    REQUIRE(spell.verified);
+    REQUIRE_FALSE(definition.columnDefinitions.at("Name").verified);
+
+    REQUIRE(definition.versionDefinitions.size() == 2);
+    const auto& version = definition.versionDefinitions[0];
+    REQUIRE(version.layoutHashes == std::vector<std::string>{ "1A2B3C4D", "5E6F7A8B" });
+    REQUIRE(version.builds == std::vector<Build>{ Build(3, 3, 5, 12340), Build(3, 3, 3, 11723) });
+    REQUIRE(version.buildRanges.size() == 1);
+    REQUIRE(version.buildRanges[0].minBuild == Build(3, 0, 1, 8303));
+    REQUIRE(version.buildRanges[0].maxBuild == Build(3, 2, 2, 10505));
+    REQUIRE(version.comment == "not verified");
+    REQUIRE(version.definitions.size() == 5);
+
+    const auto& id = version.definitions[0];
+    REQUIRE(id.name == "ID");
+    REQUIRE(id.isID);
+    REQUIRE(id.isNonInline);
+    REQUIRE_FALSE(id.isSigned);
+    REQUIRE(id.size == 32);
+
+    REQUIRE(version.definitions[1].isRelation);
+    REQUIRE(version.definitions[1].isSigned);
+    REQUIRE(version.definitions[4].name == "Coefficient");
+    REQUIRE(version.definitions[4].arrLength == 3);
+
+    REQUIRE(definition.versionDefinitions[1].builds.empty());
+    REQUIRE(definition.versionDefinitions[1].definitions.size() == 2);
+
+    for (const auto text : {
+        "COLUMN\n",
+        "COLUMNS\nint ID\n\nBUILD 3.3.5\nID\n",
+        "COLUMNS\nint ID\n\nBUILD 3.3.5.12340\nLevel\n",
+        "COLUMNS\nint ID\nint ID\n",
+        "COLUMNS\nnumber ID\n" }) {
+        std::istringstream invalid(text);
+        REQUIRE_THROWS_AS(DBDReader::read(invalid), std::runtime_error);
+    }
+}
+
+TEST_CASE("Definition registry resolves like makeSchema.", "[wowdbdefs]")
+{
+    const auto temp_dir = std::filesystem::temp_directory_path() / "wdbreader_registry_test";
+    auto dir_guard = ScopeGuard([&temp_dir]() {
+        std::filesystem::remove_all(temp_dir);
+    });
+    std::filesystem::create_directories(temp_dir);
+
+    {
+        std::ofstream out(temp_dir / "Spell.dbd", std::ios::binary);
+        out << "COLUMNS\n"
+            "int ID\n"
+            "string Name\n"
+            "int Level\n"
+            "float Scale\n"
+            "\n"
+            "LAYOUT 0E84A21C\n"
+            "BUILD 1.12.1.5875\n"
+            "BUILD 2.0.0.5610-2.4.3.8606\n"
+            "$id$ID<32>\n"
+            "Name\n"
+            "Level<32>\n"
+            "\n"
+            "LAYOUT 1A2B3C4D, 5E6F7A8B\n"
+            "BUILD 3.3.5.12340\n"
+            "BUILD 3.0.1.8303-3.3.3.11723\n"
+            "$id$ID<32>\n"
+            "Name\n"
+            "Level<32>\n"
+            "Scale\n"
+            "\n"
+            "BUILD 2.4.0.8000-3.1.0.9000, 2.4.3.8606\n"
+            "$id$ID<32>\n"
+            "Name\n"
+            "\n"
+            "LAYOUT 5E6F7A8B\n"
+            "BUILD 10.0.0.40000-10.2.5.53000\n"
+            "$id$ID<u32>\n"
+            "Name\n"
+            "Level<u16>\n";
+    }
+
+    {
+        std::ofstream out(temp_dir / "Broken.dbd", std::ios::binary);
+        out << "NOT COLUMNS\n";
+    }
+
+    {
+        std::ofstream out(temp_dir / "readme.txt", std::ios::binary);
+        out << "ignored";
+    }
+
+    ThreadPool pool(2);
+    const DefinitionRegistry registry(temp_dir, &pool);
+
+    REQUIRE(registry.size() == 1);
+    REQUIRE(registry.contains("Spell"));
+    REQUIRE(registry.failures().size() == 1);
+    REQUIRE(registry.failures()[0].name == "Broken");
+
+    const auto& definition = *registry.definition("Spell");
+    auto linear_index = [&definition](const Build& build) -> std::optional<size_t> {
+        for (size_t v = 0; v < definition.versionDefinitions.size(); v++) {
+            const auto& version = definition.versionDefinitions[v];
+            if (std::ranges::find(version.builds, build) != version.builds.end() ||
+                std::ranges::any_of(version.buildRanges, [&build](const BuildRange& range) { return range.contains(build); })) {
+                return v;
+            }
+        }
+        return std::nullopt;
+    };
+
+    const std::vector<Build> builds = {
+        Build(1, 12, 1, 5875), Build(1, 12, 1, 5876), Build(2, 0, 0, 5610), Build(2, 4, 0, 7999), Build(2, 4, 0, 8000),
+        Build(2, 4, 3, 8606), Build(2, 4, 3, 8607), Build(3, 0, 1, 8303), Build(3, 1, 0, 9000), Build(3, 1, 0, 9001),
+        Build(3, 3, 3, 11723), Build(3, 3, 5, 12340), Build(4, 0, 0, 1), Build(10, 0, 0, 40000), Build(10, 2, 5, 53000),
+        Build(10, 2, 5, 53001), Build(0, 0, 0, 0)
+    };
+
+    size_t mismatches = 0;
+    for (const auto& build : builds) {
+        const auto expected = linear_index(build);
+        if (registry.versionIndex("Spell", build) != expected) {
+            mismatches++;
+        }
+
+        const auto schema = registry.schema("Spell", build);
+        const auto made = makeSchema(definition, build);
+        if ((schema != nullptr) != made.has_value() || (schema != nullptr && *schema != *made)) {
+            mismatches++;
+        }
+    }
+    REQUIRE(mismatches == 0);
+
+    REQUIRE(registry.versionIndex("Spell", Build(2, 4, 3, 8606)) == 0u);
+    REQUIRE(registry.versionIndex("Spell", Build(3, 1, 0, 9000)) == 1u);
+    REQUIRE(registry.versionIndex("Spell", Build(2, 4, 0, 8000)) == 0u);
+    REQUIRE(registry.versionIndex("Spell", Build(2, 5, 0, 1)) == 2u);
+    REQUIRE(registry.schema("Spell", Build(3, 3, 5, 12340)) == registry.schema("Spell", Build(3, 2, 0, 10000)));
+
+    REQUIRE(registry.versionIndexForLayout("Spell", 0x0E84A21C) == 0u);
+    REQUIRE(registry.versionIndexForLayout("Spell", 0x5E6F7A8B) == 1u);
+    REQUIRE(registry.schemaForLayout("Spell", 0x5E6F7A8B) == registry.schema("Spell", Build(3, 3, 5, 12340)));
+    REQUIRE(registry.schemaForLayout("Spell", 0x12345678) == nullptr);
+    REQUIRE(registry.schema("Missing", Build(3, 3, 5, 12340)) == nullptr);
+}
+
+TEST_CASE("Definition bundles resolve like the registry.", "[wowdbdefs]")
+{
+    const auto temp_file_name = std::filesystem::temp_directory_path() / "wdbreader_definitions_test.wdbd";
+    auto file_guard = ScopeGuard([&temp_file_name]() {
+        if (std::filesystem::exists(temp_file_name)) {
+            std::filesystem::remove(temp_file_name);
+        }
+    });
+
+    auto read = [](const char* text) {
+        std::istringstream stream(text);
+        return DBDReader::read(stream);
+    };
+
+    DefinitionRegistry registry;
+    registry.add("Spell", read(
+        "COLUMNS\n"
+        "int ID\n"
+        "string Name // display name\n"
+        "int Level\n"
+        "float Scale?\n"
+        "\n"
+        "LAYOUT 0E84A21C\n"
+        "BUILD 1.12.1.5875\n"
+        "BUILD 2.0.0.5610-2.4.3.8606\n"
+        "$id$ID<32>\n"
+        "Name\n"
+        "Level<32>\n"
+        "\n"
+        "LAYOUT 1A2B3C4D, 5E6F7A8B\n"
+        "BUILD 3.3.5.12340, 1.12.1.5875\n"
+        "BUILD 3.0.1.8303-3.3.3.11723\n"
+        "COMMENT second\n"
+        "$id$ID<32>\n"
+        "Name\n"
+        "Level<32>\n"
+        "Scale[2]\n"
+        "\n"
+        "BUILD 2.4.0.8000-3.1.0.9000\n"
+        "$id,noninline$ID<u32>\n"
+        "Name\n"
+    ));
+    registry.add("Item", read(
+        "COLUMNS\n"
+        "int ID\n"
+        "int<Spell::ID> SpellID\n"
+        "\n"
+        "LAYOUT 5E6F7A8B, 99999999\n"
+        "BUILD 3.3.5.12340\n"
+        "$id$ID<32>\n"
+        "$relation$SpellID<u16>\n"
+    ));
+
+    {
+        std::ofstream out(temp_file_name, std::ios::binary);
+        writeDefinitionBundle(out, registry);
+    }
+
+    REQUIRE(DefinitionBundle::isBundle(temp_file_name));
+    REQUIRE_FALSE(DefinitionBundle::isBundle(temp_file_name.parent_path()));
+
+    const DefinitionBundle bundle(temp_file_name);
+    REQUIRE(bundle.size() == 2);
+    REQUIRE(bundle.names() == registry.names());
+    REQUIRE(bundle.contains("Item"));
+    REQUIRE_FALSE(bundle.contains("Missing"));
+
+    const std::vector<Build> builds = {
+        Build(1, 12, 1, 5875), Build(2, 0, 0, 5610), Build(2, 4, 0, 7999), Build(2, 4, 0, 8000), Build(2, 4, 3, 8606),
+        Build(2, 4, 3, 8607), Build(2, 5, 0, 1), Build(3, 0, 1, 8303), Build(3, 1, 0, 9000), Build(3, 1, 0, 9001),
+        Build(3, 2, 0, 10000), Build(3, 3, 3, 11723), Build(3, 3, 3, 11724), Build(3, 3, 5, 12340), Build(4, 0, 0, 1), Build(0, 0, 0, 0)
+    };
+
+    size_t mismatches = 0;
+    for (const auto& name : { "Spell", "Item", "Missing" }) {
+        for (const auto& build : builds) {
+            const auto schema = bundle.schema(name, build);
+            const auto expected = registry.schema(name, build);
+            if (bundle.versionIndex(name, build) != registry.versionIndex(name, build) ||
+                schema.has_value() != (expected != nullptr) || (schema.has_value() && *schema != *expected)) {
+                mismatches++;
+            }
+        }
+
+        for (const uint32_t layout : { 0x0E84A21Cu, 0x5E6F7A8Bu, 0x99999999u, 0x12345678u }) {
+            if (bundle.versionIndexForLayout(name, layout) != registry.versionIndexForLayout(name, layout)) {
+                mismatches++;
+            }
+        }
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(bundle.versionIndex("Spell", Build(3, 1, 0, 9000)) == 1u);
+    REQUIRE(bundle.versionIndex("Spell", Build(2, 5, 0, 1)) == 2u);
+    REQUIRE(bundle.versionIndexForLayout("Spell", 0x5E6F7A8B) == 1u);
+
+    REQUIRE(bundle.tableForLayout(0x5E6F7A8B) == registry.tableForLayout(0x5E6F7A8B));
+    REQUIRE(bundle.tableForLayout(0x99999999) == "Item");
+    REQUIRE_FALSE(bundle.tableForLayout(0x12345678).has_value());
+    REQUIRE(*bundle.schemaForLayout(0x0E84A21C) == *registry.schemaForLayout(0x0E84A21C));
+
+    const auto definition = bundle.definition("Spell");
+    const auto& original = *registry.definition("Spell");
+    REQUIRE(definition.has_value());
+    REQUIRE(definition->columnDefinitions.size() == original.columnDefinitions.size());
+    REQUIRE(definition->columnDefinitions.at("Name").comment == "display name");
+    REQUIRE_FALSE(definition->columnDefinitions.at("Scale").verified);
+    REQUIRE(definition->versionDefinitions.size() == original.versionDefinitions.size());
+    for (size_t v = 0; v < original.versionDefinitions.size(); v++) {
+        const auto& version = definition->versionDefinitions[v];
+        REQUIRE(version.builds == original.versionDefinitions[v].builds);
+        REQUIRE(version.layoutHashes == original.versionDefinitions[v].layoutHashes);
+        REQUIRE(version.comment == original.versionDefinitions[v].comment);
+        REQUIRE(version.buildRanges.size() == original.versionDefinitions[v].buildRanges.size());
+        REQUIRE(makeSchema(*definition, version) == makeSchema(original, original.versionDefinitions[v]));
+    }
+    REQUIRE(bundle.definition("Item")->columnDefinitions.at("SpellID").foreignTable == "Spell");
+
+    std::ifstream in(temp_file_name, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    {
+        // identical definitions give an identical bundle.
+        std::ostringstream again;
+        writeDefinitionBundle(again, registry);
+        REQUIRE(again.str() == std::string(bytes.begin(), bytes.end()));
+    }
+
+    const DefinitionBundle in_memory(bytes);
+    REQUIRE(*in_memory.schema("Item", Build(3, 3, 5, 12340)) == *registry.schema("Item", Build(3, 3, 5, 12340)));
+
+    REQUIRE_THROWS_AS(DefinitionBundle(std::vector<uint8_t>(bytes.begin(), bytes.begin() + sizeof(BundleHeader) + 4)), WDBReaderException);
+    REQUIRE_THROWS_AS(DefinitionBundle(std::vector<uint8_t>(sizeof(BundleHeader), 0)), WDBReaderException);
+}
 
 #ifdef TESTING_WOWDBDEFS_DIR
 
@@ -28,5 +350,21 @@ TEST_CASE("Schema created from definitions.", "[wowdbdef]")
     REQUIRE(schema.has_value());
 }
 
+TEST_CASE("Definition registry reads the definitions directory.", "[wowdbdefs]")
+{
+    ThreadPool pool;
+    const DefinitionRegistry registry(TESTING_WOWDBDEFS_DIR "/definitions", &pool);
+
+    REQUIRE(registry.size() > 0);
+    REQUIRE(registry.failures().empty());
+
+    std::ifstream stream(TESTING_WOWDBDEFS_DIR "/definitions/SpellItemEnchantment.dbd");
+    const auto expected = makeSchema(DBDReader::read(stream), Build(3, 3, 5, 12340));
+    const auto schema = registry.schema("SpellItemEnchantment", Build(3, 3, 5, 12340));
+
+    REQUIRE(schema != nullptr);
+    REQUIRE(*schema == *expected);
+}
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <WDBReader/Database/Schema.hpp>
+#include <WDBReader/Database/Writer.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Schema covering every packed compression, written by the tests that need a generated file.
+/// </summary>
+inline const WDBReader::Database::RuntimeSchema packed_schema = WDBReader::Database::RuntimeSchema({
+	WDBReader::Database::Field::value<uint32_t>(WDBReader::Database::Annotation().Id().NonInline()),
+	WDBReader::Database::Field::string(),
+	WDBReader::Database::Field::value<uint32_t>(),
+	WDBReader::Database::Field::value<uint16_t>(),
+	WDBReader::Database::Field::value<int16_t>(),
+	WDBReader::Database::Field::value<uint8_t>(),
+	WDBReader::Database::Field::value<float>(),
+	WDBReader::Database::Field::value<uint32_t[3]>(),
+	WDBReader::Database::Field::value<uint32_t>(WDBReader::Database::Annotation().Relation().NonInline())
+}, {
+	"id",
+	"name",
+	"category",
+	"level",
+	"offset",
+	"flags",
+	"scale",
+	"values",
+	"parent"
+});
+
+/// <summary>
+/// Row of packed_schema, ids are 10 + 3 * index and levels 7 * index.
+/// </summary>
+inline WDBReader::Database::writer_row_t packedRow(uint32_t index) {
+	return {
+		uint64_t(10 + index * 3),
+		"name_" + std::to_string(index % 4),
+		uint64_t((index % 3) * 100),
+		uint64_t(index * 7),
+		static_cast<uint64_t>(int64_t(index * 50) - 300),
+		uint64_t(index % 5 == 0 ? 3 : 1),
+		index * 0.25f,
+		uint64_t(index % 2), uint64_t(index % 2 + 1), uint64_t(9),
+		uint64_t(1000 + index)
+	};
+}
+
+/// <summary>
+/// packedRow for indexes [first, first + count).
+/// </summary>
+inline std::vector<WDBReader::Database::writer_row_t> packedRows(uint32_t count, uint32_t first = 0) {
+	std::vector<WDBReader::Database::writer_row_t> rows;
+	rows.reserve(count);
+	for (uint32_t i = 0; i < count; i++) {
+		rows.push_back(packedRow(first + i));
+	}
+	return rows;
+}
+
+/// <summary>
+/// File in the temp directory, removed again when destroyed.
+/// </summary>
+class TempFile final {
+public:
+	explicit TempFile(std::string_view name) : _path(std::filesystem::temp_directory_path() / name) {}
+	TempFile(TempFile&& other) noexcept : _path(std::exchange(other._path, {})) {}
+	TempFile(const TempFile&) = delete;
+	TempFile& operator=(const TempFile&) = delete;
+	TempFile& operator=(TempFile&&) = delete;
+
+	~TempFile() {
+		if (!_path.empty()) {
+			std::error_code error;
+			std::filesystem::remove(_path, error);
+		}
+	}
+
+	const std::filesystem::path& path() const {
+		return _path;
+	}
+
+private:
+	std::filesystem::path _path;
+};
+
+/// <summary>
+/// Writes the rows as a DB2 file of format F, packed_schema unless another schema is given.
+/// </summary>
+template<WDBReader::Database::TDB2Format F = WDBReader::Database::DB2FileFormatWDC3>
+TempFile writePackedFile(std::string_view name, const std::vector<WDBReader::Database::writer_row_t>& rows,
+	const WDBReader::Database::DB2WriterOptions& options = WDBReader::Database::DB2WriterOptions(),
+	const WDBReader::Database::RuntimeSchema& schema = packed_schema) {
+	TempFile file(name);
+	std::ofstream out(file.path(), std::ios::binary | std::ios::trunc);
+	WDBReader::Database::writeDB2File<F>(out, schema, rows, options);
+	return file;
+}
+
+/// <summary>
+/// Writes the rows as a DBC file.
+/// </summary>
+inline TempFile writeLegacyFile(std::string_view name, const WDBReader::Database::RuntimeSchema& schema, const std::vector<WDBReader::Database::writer_row_t>& rows,
+	const WDBReader::Database::DBCWriterOptions& options = WDBReader::Database::DBCWriterOptions()) {
+	TempFile file(name);
+	std::ofstream out(file.path(), std::ios::binary | std::ios::trunc);
+	WDBReader::Database::writeDBCFile(out, schema, rows, options);
+	return file;
+}